@@ -17,25 +17,41 @@ namespace tsgl {
  *   methods for emptying and resetting the internal array, and a subscript operator
  *   for accessing individual elements.
  * \note The Array has wrap-around behavior, behaving similarly to a circular queue.
- * \note If a new shape is pushed into a full Array, the first element is deleted
- *   and the pointer to the first element is incremented.
+ * \note An Array may be given a maximum capacity larger than its initial one, in which case
+ *   it doubles its capacity whenever it fills up, until the maximum capacity is reached.
+ * \note If a new shape is pushed into a full Array that cannot grow any further, the first element
+ *   is deleted and the pointer to the first element is incremented.
  */
 template<typename Item>
 class Array {
  private:
-    unsigned int first_, last_, capacity_, size_;
+    unsigned int first_, last_, capacity_, maxCapacity_, size_;
     Item* myArray;
+
+    void grow() {
+        unsigned int newCapacity = (capacity_ > maxCapacity_ / 2) ? maxCapacity_ : 2 * capacity_;
+        Item* newArray = new Item[newCapacity]();
+        for (unsigned int i = 0; i < size_; i++)               // Move our items to the front of the new array
+            newArray[i] = myArray[(first_ + i) % capacity_];
+        delete[] myArray;
+        myArray = newArray;
+        capacity_ = newCapacity;
+        first_ = 0;
+        last_ = (size_ > 0) ? size_ - 1 : 0;
+    }
  public:
 
     /*!
      * \brief Array constructor method.
-     * \param size The maximum capacity of the Array.
+     * \param size The initial capacity of the Array.
+     * \param maxSize The maximum capacity the Array can grow to (defaults to <code>size</code>,
+     *   which makes the Array fixed-size).
      * \return An Array with capacity <code>size</code>.
      */
-    Array(unsigned int size) {
-        capacity_ = size;
-        myArray = new Item[size];
-        myArray[0] = nullptr;
+    Array(unsigned int size, unsigned int maxSize = 0) {
+        capacity_ = (size > 0) ? size : 1;
+        maxCapacity_ = (maxSize > capacity_) ? maxSize : capacity_;
+        myArray = new Item[capacity_]();
         first_ = last_ = size_ = 0;
     }
 
@@ -119,11 +135,34 @@ class Array {
         return size_;
     }
 
-    /*! \brief Returns the maximum amount of items the internal array can store. */
+    /*! \brief Returns the amount of items the internal array can currently store. */
     unsigned int capacity() const {
         return capacity_;
     }
 
+    /*! \brief Returns the amount of items the internal array can grow to store. */
+    unsigned int maxCapacity() const {
+        return maxCapacity_;
+    }
+
+    /*!
+     * \brief Sets the amount of items the internal array can grow to store.
+     * \details The internal array never shrinks, so the maximum capacity cannot be set
+     *   below the current capacity.
+     * \param maxSize The new maximum capacity.
+     */
+    void setMaxCapacity(unsigned int maxSize) {
+        maxCapacity_ = (maxSize > capacity_) ? maxSize : capacity_;
+    }
+
+    /*!
+     * \brief Returns true if pushing another item would remove the oldest one, false otherwise.
+     * \details This is the case when the internal array is full and already at its maximum capacity.
+     */
+    bool isFull() const {
+        return (size_ == capacity_ && capacity_ >= maxCapacity_);
+    }
+
     /*! \brief Returns true if the internal array contains no items, false otherwise. */
     bool isEmpty() const {
         return (size_ == 0);
@@ -131,11 +170,14 @@ class Array {
 
     /*!
      * \brief Adds the item <code>item</code> to the end of the internal array.
-     *  \note If the internal array is full, push() will remove the oldest item.
+     *  \note If the internal array is full, push() will grow it if it is still below its
+     *   maximum capacity, and remove the oldest item otherwise.
      * \param item The item to add.
      * \return The same item.
      */
     Item push(Item item) {
+        if (size_ == capacity_ && capacity_ < maxCapacity_)    // If the array is full but may grow...
+            grow();                                             // Make room for the new item
         if (myArray[first_] != nullptr)                         // If the array has items...
         (last_ + 1) == capacity_ ? last_ = 0 : last_++;         // Increment last
 
@@ -0,0 +1,255 @@
+#include "CachedFunction.h"
+
+#include <algorithm>    // For finding the least recently used samples
+#include <atomic>       // For the unit tests' evaluation counter
+
+namespace tsgl {
+
+CachedFunction::CachedFunction(const Function& function, size_t capacity) : function_(function) {
+    capacity_ = std::max(capacity, (size_t) 4);
+    clock_ = hits_ = misses_ = 0;
+}
+
+void CachedFunction::clear() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    samples_.clear();
+}
+
+void CachedFunction::evict() const {
+    std::vector<unsigned long> ages;
+    ages.reserve(samples_.size());
+    for (std::map<Decimal, Sample>::const_iterator it = samples_.begin(); it != samples_.end(); ++it)
+      ages.push_back(it->second.used);
+    size_t drop = samples_.size() - capacity_ * 3 / 4;
+    std::nth_element(ages.begin(), ages.begin() + drop - 1, ages.end());
+    unsigned long cutoff = ages[drop - 1];                   // Everything used before this goes...
+    size_t atCutoff = drop - std::count_if(ages.begin(), ages.begin() + drop,
+                                           [cutoff](unsigned long a) { return a < cutoff; });
+    for (std::map<Decimal, Sample>::iterator it = samples_.begin(); it != samples_.end(); ) {
+      if (it->second.used < cutoff || (it->second.used == cutoff && atCutoff > 0)) {
+        if (it->second.used == cutoff)
+          --atCutoff;                                        // ...as do just enough of those used at it
+        samples_.erase(it++);
+      } else {
+        ++it;
+      }
+    }
+}
+
+unsigned long CachedFunction::getHits() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return hits_;
+}
+
+unsigned long CachedFunction::getMisses() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return misses_;
+}
+
+size_t CachedFunction::getSize() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return samples_.size();
+}
+
+Decimal CachedFunction::valueAt(Decimal x) const {
+    Decimal y;
+    valuesAt(&x, &y, 1);
+    return y;
+}
+
+void CachedFunction::valuesAt(const Decimal* xs, Decimal* ys, size_t n) const {
+    std::vector<Decimal> missX;
+    std::vector<size_t> missIndex;
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      for (size_t i = 0; i < n; ++i) {
+        std::map<Decimal, Sample>::iterator it = samples_.find(xs[i]);
+        if (it != samples_.end()) {
+          it->second.used = clock_;
+          ys[i] = it->second.y;
+        } else {
+          missX.push_back(xs[i]);
+          missIndex.push_back(i);
+        }
+      }
+      ++clock_;
+      hits_ += n - missX.size();
+      misses_ += missX.size();
+    }
+    if (missX.empty())
+      return;
+
+    std::vector<Decimal> missY(missX.size());
+    function_.valuesAt(&missX[0], &missY[0], missX.size());  // Don't hold the lock while computing
+
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < missX.size(); ++i) {
+      ys[missIndex[i]] = missY[i];
+      Sample s = { missY[i], clock_ };
+      samples_[missX[i]] = s;
+    }
+    if (samples_.size() > capacity_)
+      evict();
+}
+
+//-----------------Unit testing-------------------------------------------------------
+namespace {
+  /*
+   * Counts how many times it has been evaluated.
+   */
+  class CountingFunction : public Function {
+   public:
+      mutable std::atomic<unsigned long> count;
+      CountingFunction() : count(0) {}
+      virtual Decimal valueAt(Decimal x) const {
+          ++count;
+          return x * x;
+      }
+  };
+}
+
+void CachedFunction::runTests() {
+    TsglDebug("Testing CachedFunction class...");
+    tsglAssert(testCaching(), "Unit test for caching values failed!");
+    tsglAssert(testOverlap(), "Unit test for reusing overlapping samples failed!");
+    tsglAssert(testCapacity(), "Unit test for bounding the cache's size failed!");
+    TsglDebug("Unit tests for CachedFunction complete.");
+    std::cout << std::endl;
+}
+
+bool CachedFunction::testCaching() {
+    int passed = 0;
+    int failed = 0;
+    CountingFunction f;
+    CachedFunction cached(f);
+
+    //Test 1: Values are computed once, and then come from the cache
+    Decimal xs[100], ys[100];
+    for (int i = 0; i < 100; ++i)
+      xs[i] = i / 4.0;
+    cached.valuesAt(xs, ys, 100);
+    cached.valuesAt(xs, ys, 100);
+    Decimal y = cached.valueAt(xs[10]);
+    if (f.count == 100 && cached.getMisses() == 100 && cached.getHits() == 101 && y == xs[10] * xs[10]) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 1, Computing each value once for testCaching() failed!");
+    }
+
+    //Test 2: Clearing the cache makes values be computed again
+    cached.clear();
+    cached.valuesAt(xs, ys, 100);
+    bool correct = true;
+    for (int i = 0; i < 100; ++i)
+      correct = correct && ys[i] == xs[i] * xs[i];
+    if (f.count == 200 && cached.getSize() == 100 && correct) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 2, Clearing for testCaching() failed!");
+    }
+
+    if(passed == 2 && failed == 0) {
+      TsglDebug("Unit test for caching values passed!");
+      return true;
+    } else {
+      TsglErr("This many tests for CachedFunction passed: ");
+      std::cout << " " << passed << std::endl;
+      TsglErr("This many tests for CachedFunction failed: ");
+      std::cout << " " << failed << std::endl;
+      return false;
+    }
+}
+
+bool CachedFunction::testOverlap() {
+    int passed = 0;
+    int failed = 0;
+    CountingFunction f;
+    CachedFunction cached(f);
+    const int SIZE = 1000;
+    Decimal xs[SIZE], ys[SIZE];
+
+    //Test 1: Panning by half a view only computes the newly exposed half
+    for (int i = 0; i < SIZE; ++i)
+      xs[i] = i * 0.125;
+    cached.valuesAt(xs, ys, SIZE);
+    for (int i = 0; i < SIZE; ++i)
+      xs[i] = (i + SIZE / 2) * 0.125;
+    cached.valuesAt(xs, ys, SIZE);
+    if (f.count == SIZE + SIZE / 2) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 1, Reusing samples after a pan for testOverlap() failed!");
+    }
+
+    //Test 2: Zooming in by two only computes the new samples between the old ones
+    unsigned long before = f.count;
+    for (int i = 0; i < SIZE; ++i)
+      xs[i] = (SIZE / 2) * 0.125 + i * 0.0625;
+    cached.valuesAt(xs, ys, SIZE);
+    if (f.count - before == SIZE / 2) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 2, Reusing samples after a zoom for testOverlap() failed!");
+    }
+
+    if(passed == 2 && failed == 0) {
+      TsglDebug("Unit test for reusing overlapping samples passed!");
+      return true;
+    } else {
+      TsglErr("This many tests for CachedFunction passed: ");
+      std::cout << " " << passed << std::endl;
+      TsglErr("This many tests for CachedFunction failed: ");
+      std::cout << " " << failed << std::endl;
+      return false;
+    }
+}
+
+bool CachedFunction::testCapacity() {
+    int passed = 0;
+    int failed = 0;
+    CountingFunction f;
+    CachedFunction cached(f, 100);
+
+    //Test 1: The cache never holds more than its capacity
+    Decimal xs[10], ys[10];
+    size_t largest = 0;
+    for (int batch = 0; batch < 100; ++batch) {
+      for (int i = 0; i < 10; ++i)
+        xs[i] = batch * 10 + i;
+      cached.valuesAt(xs, ys, 10);
+      largest = std::max(largest, cached.getSize());
+    }
+    if (largest <= 100) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 1, Bounding the size for testCapacity() failed!");
+    }
+
+    //Test 2: The most recently used values are the ones kept
+    unsigned long before = f.count;
+    cached.valuesAt(xs, ys, 10);
+    if (f.count == before) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 2, Keeping recent values for testCapacity() failed!");
+    }
+
+    if(passed == 2 && failed == 0) {
+      TsglDebug("Unit test for bounding the cache's size passed!");
+      return true;
+    } else {
+      TsglErr("This many tests for CachedFunction passed: ");
+      std::cout << " " << passed << std::endl;
+      TsglErr("This many tests for CachedFunction failed: ");
+      std::cout << " " << failed << std::endl;
+      return false;
+    }
+}
+
+}
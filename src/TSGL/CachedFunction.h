@@ -0,0 +1,115 @@
+/*
+ * CachedFunction.h provides a Function that remembers the values it has computed.
+ */
+
+#ifndef CACHEDFUNCTION_H_
+#define CACHEDFUNCTION_H_
+
+#include <map>              // For storing samples in order of x
+#include <mutex>            // For evaluating from several threads at once
+#include <vector>           // For gathering cache misses
+
+#include "Error.h"          // For unit testing output
+#include "Function.h"       // We extend Function
+#include "TsglAssert.h"     // For unit testing purposes
+
+namespace tsgl {
+
+/*! \class CachedFunction
+ *  \brief A Function that caches the values of another Function.
+ *  \details CachedFunction wraps an expensive Function and remembers every value it computes, keyed on x.
+ *    When the same x is asked for again, the stored value is returned instead of calling the wrapped
+ *    Function. valuesAt() looks up a whole batch at once and passes only the missing inputs on to the
+ *    wrapped Function's valuesAt().
+ *  \details CartesianCanvas samples Functions on a grid of power-of-two multiples of a power-of-two spacing.
+ *    After a pan, or a zoom by a factor of two, most of the samples needed for the new view are samples that
+ *    were already computed for the old one, so plotting a CachedFunction again only evaluates the newly
+ *    exposed (or newly detailed) parts of the curve.
+ *  \details The number of stored samples is bounded. When it exceeds the capacity, the least recently used
+ *    quarter of the samples are discarded.
+ *  \details CachedFunction is safe to evaluate from several threads at once.
+ *  \note The wrapped Function must outlive the CachedFunction, and must always return the same value for
+ *    the same x. Temporaries, such as the result of expr::makeFunction(), are rejected at compile time.
+ */
+class CachedFunction : public Function {
+ private:
+    struct Sample {
+      Decimal       y;              // The wrapped Function's value
+      unsigned long used;           // Value of clock_ when the sample was last returned
+    };
+
+    size_t                            capacity_;  // Maximum number of samples to store
+    mutable unsigned long             clock_;     // Number of lookups made so far, for tracking recent use
+    const Function&                   function_;  // The Function being cached
+    mutable unsigned long             hits_;      // Number of values returned from the cache
+    mutable unsigned long             misses_;    // Number of values passed on to function_
+    mutable std::mutex                mutex_;     // Mutex for the cache's state
+    mutable std::map<Decimal, Sample> samples_;   // Stored samples, keyed on x
+
+    void evict() const;
+
+    static bool testCaching();
+    static bool testOverlap();
+    static bool testCapacity();
+ public:
+
+    /*!
+     * \brief Constructs a new CachedFunction.
+     *      \param function The Function whose values to cache.
+     *      \param capacity The maximum number of values to store (set to 1048576 by default).
+     */
+    CachedFunction(const Function& function, size_t capacity = 1 << 20);
+
+    /*!
+     * \brief Refuses to wrap a temporary Function.
+     * \details CachedFunction only refers to the Function it wraps, which would be destroyed as soon as the
+     *   CachedFunction had been constructed. Store the Function in a variable first.
+     */
+    CachedFunction(const Function&& function, size_t capacity = 1 << 20) = delete;
+
+    /*!
+     * \brief Method to determine the value of the wrapped Function.
+     * \return The wrapped Function's value at *x*, from the cache if it has been computed before.
+     */
+    virtual Decimal valueAt(Decimal x) const;
+
+    /*!
+     * \brief Method to determine many values of the wrapped Function at once.
+     * \details Looks up every input in the cache, then computes all of the missing values with a single
+     *   call to the wrapped Function's valuesAt().
+     */
+    virtual void valuesAt(const Decimal* xs, Decimal* ys, size_t n) const;
+
+    /*!
+     * \brief Discards all stored values.
+     * \details Call this if the wrapped Function has changed.
+     */
+    void clear();
+
+    /*!
+     * \brief Accessor for the number of values returned from the cache.
+     * \return The number of inputs that were found in the cache.
+     */
+    unsigned long getHits() const;
+
+    /*!
+     * \brief Accessor for the number of values computed by the wrapped Function.
+     * \return The number of inputs that were not found in the cache.
+     */
+    unsigned long getMisses() const;
+
+    /*!
+     * \brief Accessor for the number of stored values.
+     * \return The number of samples currently in the cache.
+     */
+    size_t getSize() const;
+
+    /*!
+     * \brief Runs the Unit tests for CachedFunction.
+     */
+    static void runTests();
+};
+
+}
+
+#endif /* CACHEDFUNCTION_H_ */
@@ -1,4 +1,5 @@
 #include "Canvas.h"
+#include "RenderHub.h"
 
 namespace tsgl {
 
@@ -47,11 +48,18 @@ static const GLchar* textureFragmentSource =
     "    outColor = texture(tex, Texcoord) * vec4(Color);"
     "}";
 
+// Initial capacity of the shape and point buffers, which grow as needed
+static const unsigned MIN_BUFFER_SIZE = 1024;
+
 int Canvas::drawBuffer = GL_FRONT_LEFT;
 bool Canvas::glfwIsReady = false;
 std::mutex Canvas::glfwMutex;
 GLFWvidmode const* Canvas::monInfo;
+std::mutex Canvas::pollMutex;
 unsigned Canvas::openCanvases = 0;
+GLFWwindow* Canvas::sharedWindow = nullptr;
+std::weak_ptr<TextureHandler> Canvas::sharedLoader;
+bool Canvas::sharingResources = false;
 
 Canvas::Canvas(double timerLength) {
     init(-1, -1, -1, -1, -1, "", timerLength);
@@ -62,22 +70,54 @@ Canvas::Canvas(int x, int y, int width, int height, std::string title, double ti
 }
 
 Canvas::~Canvas() {
+    stopDispatching();
     // Free our pointer memory
     delete myShapes;
     delete myBuffer;
     delete drawTimer;
     delete[] vertexData;
+    delete[] drawVertexData;
     delete [] screenBuffer;
-    if (--openCanvases == 0) {
-        glfwIsReady = false;
-        glfwTerminate();  // Terminate GLFW
+    if (sharesContext) {
+      // Our textures live on in sharedWindow's context, so free them there if nobody else needs them
+      glfwMutex.lock();
+      if (loader.unique()) {
+        glfwMakeContextCurrent(sharedWindow);
+        loader.reset();
+        glfwMakeContextCurrent(NULL);
+      } else {
+        loader.reset();
+      }
+      glfwMutex.unlock();
     }
+    releaseGlfw();
+}
+
+void Canvas::addWorldGeometry(GLenum mode, int size, const float x[], const float y[], ColorFloat color) {
+    if (size <= 0)
+      return;
+    std::lock_guard<std::mutex> lock(worldMutex);
+    WorldRun run = { mode, (unsigned) (worldVertices.size() / 6), (unsigned) size };
+    worldVertices.reserve(worldVertices.size() + 6 * size);
+    for (int i = 0; i < size; ++i) {
+      worldVertices.push_back(x[i]);
+      worldVertices.push_back(y[i]);
+      worldVertices.push_back(color.R);
+      worldVertices.push_back(color.G);
+      worldVertices.push_back(color.B);
+      worldVertices.push_back(color.A);
+    }
+    worldRuns.push_back(run);
 }
 
 void Canvas::bindToButton(Key button, Action action, voidFunction function) {
     boundKeys[button + action * (GLFW_KEY_LAST + 1)] = function;
 }
 
+void Canvas::bindToMouseMove(std::function<void(double, double)> function) {
+    mouseMoveFunction = function;
+}
+
 void Canvas::bindToScroll(std::function<void(double, double)> function) {
     scrollFunction = function;
 }
@@ -85,27 +125,37 @@ void Canvas::bindToScroll(std::function<void(double, double)> function) {
 void Canvas::buttonCallback(GLFWwindow* window, int button, int action, int mods) {
     if (action == GLFW_REPEAT) return;
     Canvas* can = reinterpret_cast<Canvas*>(glfwGetWindowUserPointer(window));
-    int index = button + action * (GLFW_KEY_LAST + 1);
-    if (&(can->boundKeys[index]) != nullptr) if (can->boundKeys[index]) can->boundKeys[index]();
+    InputEvent e = { TSGL_BUTTON_EVENT, button, action, mods, can->mouseX, can->mouseY, 0.0 };
+    can->pushInputEvent(e);
 }
 
 void Canvas::clear() {
     toClear = true;
 }
 
+void Canvas::clearWorldGeometry() {
+    std::lock_guard<std::mutex> lock(worldMutex);
+    if (worldRuns.empty())
+      return;
+    worldVertices.clear();
+    worldRuns.clear();
+    worldRunsDrawn = worldUploaded = 0;  // worldBuffer keeps its capacity for the next geometry
+    worldChanged = true;                 // Erase what was drawn
+}
+
 void Canvas::close() {
     glfwSetWindowShouldClose(window, GL_TRUE);
     TsglDebug("Window closed successfully.");
 }
 
-void Canvas::draw() {
+void Canvas::beginDrawing() {
     // Reset the window
     glfwSetWindowShouldClose(window, GL_FALSE);
 
     // Get actual framebuffer size and adjust scaling accordingly
     int fbw, fbh;
     glfwGetFramebufferSize(window, &fbw, &fbh);
-    int scaling = round((1.0f*fbw)/winWidth);
+    scaling = round((1.0f*fbw)/winWidth);
 
     if (hasStereo)
       Canvas::setDrawBuffer(hasBackbuffer ? GL_FRONT_AND_BACK : GL_FRONT);
@@ -116,137 +166,254 @@ void Canvas::draw() {
     setBackgroundColor(bgcolor); //Set our initial clear / background color
     glClear(GL_COLOR_BUFFER_BIT);
     glfwSwapBuffers(window);
-    readyToDraw = true;
-    bool nothingDrawn = false;  //Always draw the first frame
+    nothingDrawn = false;  //Always draw the first frame
+    frameCounter = 0;
+
+    stateMutex.lock();
+    readyToDraw = true;    //Let drawShape() know it can stop waiting
+    stateMutex.unlock();
+    stateChanged.notify_all();
+}
+
+GLtexture Canvas::createShaderProgram(bool textured, GLtexture& vertex, GLtexture& fragment) {
+    GLint status;
+
+    // Create / compile vertex shader
+    vertex = glCreateShader(GL_VERTEX_SHADER);
+    glShaderSource(vertex, 1, textured ? &textureVertexSource : &vertexSource, NULL);
+    glCompileShader(vertex);
+    glGetShaderiv(vertex, GL_COMPILE_STATUS, &status);
+
+    // Create / compile fragment shader
+    fragment = glCreateShader(GL_FRAGMENT_SHADER);
+    glShaderSource(fragment, 1, textured ? &textureFragmentSource : &fragmentSource, NULL);
+    glCompileShader(fragment);
+    glGetShaderiv(fragment, GL_COMPILE_STATUS, &status);
+
+    // Attach both shaders to a shader program, link the program
+    GLtexture program = glCreateProgram();
+    glAttachShader(program, vertex);
+    glAttachShader(program, fragment);
+    glBindFragDataLocation(program, 0, "outColor");
+    glLinkProgram(program);
+    return program;
+}
+
+void Canvas::destroyShaderProgram(GLtexture program, GLtexture vertex, GLtexture fragment) {
+    glDetachShader(program, fragment);
+    glDetachShader(program, vertex);
+    glDeleteShader(fragment);
+    glDeleteShader(vertex);
+    glDeleteProgram(program);
+}
+
+void Canvas::cursorCallback(GLFWwindow* window, double xpos, double ypos) {
+    Canvas* can = reinterpret_cast<Canvas*>(glfwGetWindowUserPointer(window));
+    can->mouseX = xpos;
+    can->mouseY = ypos;
+    InputEvent e = { TSGL_CURSOR_EVENT, 0, 0, 0, xpos, ypos, 0.0 };
+    can->pushInputEvent(e);
+}
+
+void Canvas::dispatchInputEvent(const InputEvent& event) {
+    switch (event.type) {
+      case TSGL_BUTTON_EVENT: {
+        int index = event.key + event.action * (GLFW_KEY_LAST + 1);
+        if (boundKeys[index]) boundKeys[index]();
+        break;
+      }
+      case TSGL_CURSOR_EVENT:
+        if (mouseMoveFunction) mouseMoveFunction(event.x, event.y);
+        break;
+      case TSGL_SCROLL_EVENT:
+        if (scrollFunction) scrollFunction(event.x, event.y);
+        break;
+    }
+}
+
+void Canvas::dispatchInputEvents() {
+    if (dispatchOnThread && std::this_thread::get_id() != inputThread.get_id())
+      return;  // inputThread is the only one allowed to take events
+    InputEvent e;
+    while (inputEvents.pop(e))
+      dispatchInputEvent(e);
+}
+
+void Canvas::dispatchLoop() {
+    std::unique_lock<std::mutex> lock(inputMutex);
+    while (!inputStopping) {
+      lock.unlock();
+      dispatchInputEvents();
+      lock.lock();
+      inputSleeping = true;  // From here on, pushInputEvent() wakes us; the wait checks the queue once more first
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      inputReady.wait(lock, [this]{ return inputStopping || !inputEvents.isEmpty(); });
+      inputSleeping = false;
+    }
+}
+
+void Canvas::draw() {
+    beginDrawing();
 
     // Start the drawing loop
-    for (frameCounter = 0; !glfwWindowShouldClose(window); frameCounter++) {
+    while (!glfwWindowShouldClose(window)) {
         drawTimer->sleep(true);
+        drawFrame();
+    }
+}
 
-        syncMutex.lock();
+bool Canvas::drawFrame(bool wait) {
+    if (wait)
+      frameBarrier.beginFrame();
+    else if (!frameBarrier.tryBeginFrame())
+      return false;              // Drawing is paused; the caller will try again next frame
 
-      #ifdef __APPLE__
-        windowMutex.lock();
-      #endif
-        glfwMakeContextCurrent(window);  // We're drawing to window as soon as it's created
+  #ifdef __APPLE__
+    windowMutex.lock();
+  #endif
+    glfwMakeContextCurrent(window);  // We're drawing to window as soon as it's created
+    if (sharedShaders)
+      textureShaders(false);         // Other Canvases may have changed the uniforms of the shared programs
+
+    realFPS = round(1 / drawTimer->getTimeBetweenSleeps());
+    if (showFPS) std::cout << realFPS << "/" << FPS << std::endl;
+    std::cout.flush();
+
+    bufferMutex.lock();  // Time to flush our buffer
+    unsigned long frame = ++framesStarted;  // Everything drawn before here is part of this frame
+    if (myBuffer->size() > 0) {     // But only if there is anything to flush
+      nothingDrawn = false;
+      Array<Shape*>* temp = myShapes;  // myShapes was emptied last frame, so just trade places
+      myShapes = myBuffer;
+      myBuffer = temp;
+    }
+    bufferMutex.unlock();
+    bufferDrained.notify_all();
+
+    pointArrayMutex.lock();  // Likewise, take the points drawn since the last frame
+    unsigned pointStart = loopAround ? pointBufferPosition : 0;
+    unsigned pointCount = loopAround ? pointCapacity : pointBufferPosition;
+    std::swap(vertexData, drawVertexData);
+    std::swap(pointCapacity, drawPointCapacity);
+    pointBufferPosition = 0;
+    loopAround = false;
+    pointArrayMutex.unlock();
+    pointArrayDrained.notify_all();
 
-        realFPS = round(1 / drawTimer->getTimeBetweenSleeps());
-        if (showFPS) std::cout << realFPS << "/" << FPS << std::endl;
-        std::cout.flush();
+    if (pointCount > 0)
+      nothingDrawn = false;
 
-        bufferMutex.lock();  // Time to flush our buffer
-        if (myBuffer->size() > 0) {     // But only if there is anything to flush
-          nothingDrawn = false;
-          for (unsigned int i = 0; i < myBuffer->size(); i++)
-            myShapes->push((*myBuffer)[i]);
-          myBuffer->shallowClear();  // We want to clear the buffer but not delete those objects as we still need to draw them
-        }
-        bufferMutex.unlock();
-
-        int pos = pointBufferPosition;
-        int posLast = pointLastPosition;
-        pointLastPosition = pos;
-
-        if (loopAround || pos != posLast)
-          nothingDrawn = false;
-
-        if (!nothingDrawn) {
-
-          if (hasEXTFramebuffer)
-            glBindFramebufferEXT(GL_DRAW_FRAMEBUFFER_EXT, frameBuffer);
-          else
-            glBindFramebuffer(GL_DRAW_FRAMEBUFFER_EXT, frameBuffer);
-          glDrawBuffer(GL_COLOR_ATTACHMENT0);
-
-          glViewport(0,0,winWidth,winHeight);
-
-          if (toClear) glClear(GL_COLOR_BUFFER_BIT);
-          toClear = false;
-
-          unsigned int size = myShapes->size();
-          for (unsigned int i = 0; i < size; i++) {
-            Shape* s = (*myShapes)[i];
-            if (!s->getIsTextured()) {
-              s->draw();  // Iterate through our queue until we've made it to the end
-            } else {
-              textureShaders(true);
-              s->draw();
-              textureShaders(false);
-            }
-          }
-
-          if (loopAround) {
-            nothingDrawn = false;
-            int toend = myShapes->capacity() - posLast;
-            glBufferData(GL_ARRAY_BUFFER, toend * 6 * sizeof(float),
-                   &vertexData[posLast * 6], GL_DYNAMIC_DRAW);
-            glDrawArrays(GL_POINTS, 0, toend);
-            posLast = 0;
-            loopAround = false;
-          }
-          int pbsize = pos - posLast;
-          if (pbsize > 0) {
-            nothingDrawn = false;
-            glBufferData(GL_ARRAY_BUFFER, pbsize * 6 * sizeof(float), &vertexData[posLast * 6], GL_DYNAMIC_DRAW);
-            glDrawArrays(GL_POINTS, 0, pbsize);
-          }
-        }
+    worldMutex.lock();  // See whether the retained geometry has anything new to show
+    bool redrawWorld = worldChanged || (toClear && !worldRuns.empty());
+    if (redrawWorld || worldRunsDrawn < worldRuns.size())
+      nothingDrawn = false;
+    worldMutex.unlock();
 
-        // Reset drawn status for the next frame
-        nothingDrawn = true;
+    if (!nothingDrawn) {
 
-        // Update our screenBuffer copy with the screen
-        glViewport(0,0,winWidth*scaling,winHeight*scaling);
-        myShapes->clear();                           // Clear our buffer of shapes to be drawn
+      if (hasEXTFramebuffer)
+        glBindFramebufferEXT(GL_DRAW_FRAMEBUFFER_EXT, frameBuffer);
+      else
+        glBindFramebuffer(GL_DRAW_FRAMEBUFFER_EXT, frameBuffer);
+      glDrawBuffer(GL_COLOR_ATTACHMENT0);
 
-        if (hasEXTFramebuffer)
-          glBindFramebufferEXT(GL_READ_FRAMEBUFFER_EXT, frameBuffer);
-        else
-          glBindFramebuffer(GL_READ_FRAMEBUFFER_EXT, frameBuffer);
-        glReadBuffer(GL_COLOR_ATTACHMENT0);
-
-        glReadPixels(0, 0, winWidthPadded, winHeight, GL_RGB, GL_UNSIGNED_BYTE, screenBuffer);
-        if (toRecord > 0) {
-          screenShot();
-          --toRecord;
-        }
+      glViewport(0,0,winWidth,winHeight);
 
-        glBindFramebuffer(GL_DRAW_FRAMEBUFFER,0);
-        glDrawBuffer(drawBuffer);
+      if (toClear || redrawWorld) glClear(GL_COLOR_BUFFER_BIT);
+      toClear = false;
 
-        textureShaders(true);
-        const float vertices[32] = {
-          0,       0,        1,1,1,1,0,1,
-          winWidth,0,        1,1,1,1,1,1,
-          0,       winHeight,1,1,1,1,0,0,
-          winWidth,winHeight,1,1,1,1,1,0
-        };
-        glBindTexture(GL_TEXTURE_2D,renderedTexture);
-        glPixelStorei(GL_UNPACK_ALIGNMENT,4);
-        glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_S,GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_T,GL_REPEAT);
-        glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_NEAREST);
-        glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_NEAREST);
-        glBufferData(GL_ARRAY_BUFFER,32*sizeof(float),vertices,GL_DYNAMIC_DRAW);
-        glDrawArrays(GL_TRIANGLE_STRIP,0,4);
-        glFlush();                                   // Flush buffer data to the actual draw buffer
-        glfwSwapBuffers(window);                     // Swap out GL's back buffer and actually draw to the window
+      drawWorld(redrawWorld);
 
-        textureShaders(false);
+      unsigned int size = myShapes->size();
+      for (unsigned int i = 0; i < size; i++) {
+        Shape* s = (*myShapes)[i];
+        if (!s->getIsTextured()) {
+          s->draw();  // Iterate through our queue until we've made it to the end
+        } else {
+          textureShaders(true);
+          s->draw();
+          textureShaders(false);
+        }
+      }
+
+      if (pointCount > 0) {
+        pointShaders();
+        int toend = pointCount - pointStart;  // If the buffer wrapped, the oldest points start at pointStart
+        glBufferData(GL_ARRAY_BUFFER, toend * vertexStride,
+               &drawVertexData[pointStart * vertexStride], GL_DYNAMIC_DRAW);
+        glDrawArrays(GL_POINTS, 0, toend);
+        if (pointStart > 0) {
+          glBufferData(GL_ARRAY_BUFFER, pointStart * vertexStride, drawVertexData, GL_DYNAMIC_DRAW);
+          glDrawArrays(GL_POINTS, 0, pointStart);
+        }
+        if (packedPoints)
+          textureShaders(false);  // Go back to the float vertex format for the next shapes
+      }
+    }
 
-      #ifndef __APPLE__
-        glfwPollEvents();                            // Handle any I/O
-      #endif
-        glfwGetCursorPos(window, &mouseX, &mouseY);
-        glfwMakeContextCurrent(NULL);                // We're drawing to window as soon as it's created
-      #ifdef __APPLE__
-        windowMutex.unlock();
-      #endif
+    // Reset drawn status for the next frame
+    nothingDrawn = true;
 
-        syncMutex.unlock();
+    // Update our screenBuffer copy with the screen
+    glViewport(0,0,winWidth*scaling,winHeight*scaling);
+    myShapes->clear();                           // Clear our buffer of shapes to be drawn
 
-        if (toClose) glfwSetWindowShouldClose(window, GL_TRUE);
+    if (hasEXTFramebuffer)
+      glBindFramebufferEXT(GL_READ_FRAMEBUFFER_EXT, frameBuffer);
+    else
+      glBindFramebuffer(GL_READ_FRAMEBUFFER_EXT, frameBuffer);
+    glReadBuffer(GL_COLOR_ATTACHMENT0);
+
+    glReadPixels(0, 0, winWidthPadded, winHeight, GL_RGB, GL_UNSIGNED_BYTE, screenBuffer);
+    stateMutex.lock();
+    framesRendered = frame;                      // Wake up anyone waiting for this frame in sync()
+    stateMutex.unlock();
+    stateChanged.notify_all();
+    if (toRecord > 0) {
+      screenShot();
+      --toRecord;
     }
+
+    glBindFramebuffer(GL_DRAW_FRAMEBUFFER,0);
+    glDrawBuffer(drawBuffer);
+
+    textureShaders(true);
+    const float vertices[32] = {
+      0,       0,        1,1,1,1,0,1,
+      winWidth,0,        1,1,1,1,1,1,
+      0,       winHeight,1,1,1,1,0,0,
+      winWidth,winHeight,1,1,1,1,1,0
+    };
+    glBindTexture(GL_TEXTURE_2D,renderedTexture);
+    glPixelStorei(GL_UNPACK_ALIGNMENT,4);
+    glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_S,GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_WRAP_T,GL_REPEAT);
+    glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MIN_FILTER,GL_NEAREST);
+    glTexParameteri(GL_TEXTURE_2D,GL_TEXTURE_MAG_FILTER,GL_NEAREST);
+    glBufferData(GL_ARRAY_BUFFER,32*sizeof(float),vertices,GL_DYNAMIC_DRAW);
+    glDrawArrays(GL_TRIANGLE_STRIP,0,4);
+    glFlush();                                   // Flush buffer data to the actual draw buffer
+    glfwSwapBuffers(window);                     // Swap out GL's back buffer and actually draw to the window
+    if (timeToFirstFrame == 0)  // Only the rendering thread writes it, so there's no race between test and set
+      timeToFirstFrame = std::chrono::duration_cast<duration_d>(highResClock::now() - createdAt).count();
+
+    textureShaders(false);
+
+  #ifndef __APPLE__
+    if (hub == nullptr)
+      pollEvents();                              // Handle any I/O (a RenderHub does this once for all of its Canvases)
+  #endif
+    glfwGetCursorPos(window, &mouseX, &mouseY);
+    glfwMakeContextCurrent(NULL);                // We're drawing to window as soon as it's created
+  #ifdef __APPLE__
+    windowMutex.unlock();
+  #endif
+
+    frameBarrier.endFrame();
+
+    if (toClose) glfwSetWindowShouldClose(window, GL_TRUE);
+    ++frameCounter;
+    return true;
 }
 
 void Canvas::drawCircle(int xverts, int yverts, int radius, int sides, ColorFloat color, bool filled) {
@@ -306,7 +473,7 @@ void Canvas::drawConvexPolygon(int size, int x[], int y[], ColorFloat color[], b
 }
 
 void Canvas::drawImage(std::string filename, int x, int y, int width, int height, float alpha) {
-    Image* im = new Image(filename, loader, x, y, width, height, alpha);  // Creates the Image with the specified coordinates
+    Image* im = new Image(filename, *loader, x, y, width, height, alpha);  // Creates the Image with the specified coordinates
     drawShape(im);                                        // Push it onto our drawing buffer
 }
 
@@ -320,22 +487,8 @@ inline void Canvas::drawPixel(int row, int col, ColorFloat color) {
 }
 
 void Canvas::drawPoint(int x, int y, ColorFloat color) {
-    pointArrayMutex.lock();
-    if (pointBufferPosition >= myShapes->capacity()) {
-        loopAround = true;
-        pointBufferPosition = 0;
-    }
-    int tempPos = pointBufferPosition * 6;
-    pointBufferPosition++;
-
-    float atioff = atiCard ? 0.5f : 0.0f;
-    vertexData[tempPos] = x;
-    vertexData[tempPos + 1] = y+atioff;
-    vertexData[tempPos + 2] = color.R;
-    vertexData[tempPos + 3] = color.G;
-    vertexData[tempPos + 4] = color.B;
-    vertexData[tempPos + 5] = color.A;
-    pointArrayMutex.unlock();
+    std::unique_lock<std::mutex> lock(pointArrayMutex);
+    writePoint(nextPoint(lock), x, y, color);
 }
 
 void Canvas::drawProgress(ProgressBar* p) {
@@ -346,6 +499,13 @@ void Canvas::drawProgress(ProgressBar* p) {
     }
 }
 
+void Canvas::drawRaster(int x, int y, int width, int height, const ColorFloat colors[]) {
+    std::unique_lock<std::mutex> lock(pointArrayMutex);  // Taken once for the whole block, not once per pixel
+    for (int row = 0; row < height; ++row)
+      for (int col = 0; col < width; ++col)
+        writePoint(nextPoint(lock), x + col, y + row, colors[row * width + col]);
+}
+
 void Canvas::drawRectangle(int x1, int y1, int x2, int y2, ColorFloat color, bool filled) {
     if (filled) {
         if (x2 < x1) { int t = x1; x1 = x2; x2 = t; }
@@ -369,11 +529,22 @@ void Canvas::drawShape(Shape* s) {
 	  TsglDebug("No drawing before Canvas is started! Ignoring draw request.");
 	  return;
 	}
-	while (!readyToDraw)
-	  sleep();
-    bufferMutex.lock();
+    if (!readyToDraw) {
+      std::unique_lock<std::mutex> lock(stateMutex);
+      stateChanged.wait(lock, [this]{ return readyToDraw || isFinished; });
+    }
+    std::unique_lock<std::mutex> lock(bufferMutex);
+    while (myBuffer->isFull()) {
+      if (overflowPolicy == TSGL_BLOCK && canWaitForDrain()) {
+        bufferDrained.wait_for(lock, std::chrono::duration<double>(FRAME));  // Check back every frame in case we can't wait anymore
+      } else if (overflowPolicy != TSGL_DROP_OLDEST) {
+        myBuffer->setMaxCapacity(2 * myBuffer->capacity());
+      } else {
+        ++droppedShapes;
+        break;
+      }
+    }
     myBuffer->push(s);  // Push it onto our drawing buffer
-    bufferMutex.unlock();
 }
 
 void Canvas::drawText(std::string text, int x, int y, unsigned size, ColorFloat color) {
@@ -383,7 +554,7 @@ void Canvas::drawText(std::string text, int x, int y, unsigned size, ColorFloat
 }
 
 void Canvas::drawText(std::wstring text, int x, int y, unsigned size, ColorFloat color) {
-    Text* t = new Text(text, loader, x, y, size, color);  // Creates the Point with the specified coordinates and color
+    Text* t = new Text(text, *loader, x, y, size, color);  // Creates the Point with the specified coordinates and color
     drawShape(t);                                // Push it onto our drawing buffer
 }
 
@@ -419,10 +590,71 @@ void Canvas::drawTriangleStrip(int size, int xverts[], int yverts[], ColorFloat
     }
 }
 
+void Canvas::drawWorld(bool redraw) {
+    std::lock_guard<std::mutex> lock(worldMutex);
+    if (redraw) {
+      worldChanged = false;
+      worldRunsDrawn = 0;
+    }
+    if (worldRunsDrawn == worldRuns.size())
+      return;
+
+    // Copy any vertices retained since the last frame to the GPU; the rest are already there
+    glBindBuffer(GL_ARRAY_BUFFER, worldBuffer);
+    unsigned count = worldVertices.size() / 6;
+    if (count > worldBufferCapacity) {
+      worldBufferCapacity = std::max(count, 2 * worldBufferCapacity);
+      glBufferData(GL_ARRAY_BUFFER, worldBufferCapacity * 6 * sizeof(float), NULL, GL_STATIC_DRAW);
+      worldUploaded = 0;
+    }
+    if (worldUploaded < count) {
+      glBufferSubData(GL_ARRAY_BUFFER, worldUploaded * 6 * sizeof(float),
+                      (count - worldUploaded) * 6 * sizeof(float), &worldVertices[worldUploaded * 6]);
+      worldUploaded = count;
+    }
+
+    // Map world coordinates to pixels in the view matrix, so panning and zooming only changes uniforms
+    textureShaders(false);
+    setupCamera(worldTransform[0], worldTransform[1], worldTransform[2],
+                worldTransform[3] + (atiCard ? 0.5f : 0.0f));
+    for (unsigned i = worldRunsDrawn; i < worldRuns.size(); ++i)
+      glDrawArrays(worldRuns[i].mode, worldRuns[i].first, worldRuns[i].count);
+    worldRunsDrawn = worldRuns.size();
+
+    glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
+    textureShaders(false);  // Back to the pixel camera for the shapes
+}
+
+void Canvas::endDrawing() {
+  #ifndef __APPLE__
+    glfwDestroyWindow(window);
+    glDestroy();
+  #endif
+    std::lock_guard<std::mutex> lock(stateMutex);
+    isFinished = true;
+    stateChanged.notify_all();
+}
+
 void Canvas::errorCallback(int error, const char* string) {
     fprintf(stderr, "%i: %s\n", error, string);
 }
 
+unsigned long Canvas::flush() {
+    std::lock_guard<std::mutex> lock(bufferMutex);
+    return framesStarted + 1;  // The next frame to start takes everything drawn so far
+}
+
+bool Canvas::canWaitForDrain() {
+    // The rendering thread can't drain the buffers while it's waiting on itself, drawing is paused, or it's done,
+    // and the functions bound to input events must never block on it
+    return std::this_thread::get_id() != renderThreadId && std::this_thread::get_id() != inputThread.get_id() &&
+           !frameBarrier.isUpdating() && !isFinished && !toClose;
+}
+
+unsigned long Canvas::getDroppedInputEvents() {
+    return inputEvents.getDropped();
+}
+
 ColorFloat Canvas::getBackgroundColor() {
   return bgcolor;
 }
@@ -437,6 +669,16 @@ int Canvas::getDisplayWidth() {
   return monInfo->width;
 }
 
+unsigned long Canvas::getDroppedPoints() {
+    std::lock_guard<std::mutex> lock(pointArrayMutex);
+    return droppedPoints;
+}
+
+unsigned long Canvas::getDroppedShapes() {
+    std::lock_guard<std::mutex> lock(bufferMutex);
+    return droppedShapes;
+}
+
 float Canvas::getFPS() {
     return realFPS;
 }
@@ -449,6 +691,20 @@ bool Canvas::isOpen() {
     return !isFinished;
 }
 
+size_t Canvas::getMemoryUsage() {
+    size_t usage = bufferSize;  // Screen buffer
+    bufferMutex.lock();
+    usage += (myBuffer->capacity() + myShapes->capacity()) * sizeof(Shape*);
+    bufferMutex.unlock();
+    pointArrayMutex.lock();
+    usage += (size_t) (pointCapacity + drawPointCapacity) * vertexStride;
+    pointArrayMutex.unlock();
+    worldMutex.lock();
+    usage += worldVertices.capacity() * sizeof(float);
+    worldMutex.unlock();
+    return usage;
+}
+
 int Canvas::getMouseX() {
     return mouseX;
 }
@@ -479,6 +735,10 @@ uint8_t* Canvas::getScreenBuffer() {
     return screenBuffer;
 }
 
+double Canvas::getTimeToFirstFrame() {
+    return timeToFirstFrame;
+}
+
 double Canvas::getTime() {
     return drawTimer->getTime();
 }
@@ -505,20 +765,24 @@ int Canvas::getWindowY() {
 
 void Canvas::glDestroy() {
     // Free up our resources
-    glDetachShader(shaderProgram, shaderFragment);
-    glDetachShader(shaderProgram, shaderVertex);
-    glDeleteShader(shaderFragment);
-    glDeleteShader(shaderVertex);
-    glDeleteProgram(shaderProgram);
-    glDetachShader(textureShaderProgram, textureShaderFragment);
-    glDetachShader(textureShaderProgram, textureShaderVertex);
-    glDeleteShader(textureShaderFragment);
-    glDeleteShader(textureShaderVertex);
-    glDeleteProgram(textureShaderProgram);
+    if (!sharedShaders) {
+      destroyShaderProgram(shaderProgram, shaderVertex, shaderFragment);
+      destroyShaderProgram(textureShaderProgram, textureShaderVertex, textureShaderFragment);
+    }
     glDeleteBuffers(1, &vertexBuffer);
+    glDeleteBuffers(1, &worldBuffer);
     glDeleteVertexArrays(1, &vertexArray);
 }
 
+void Canvas::growPointBuffer(unsigned limit) {
+    unsigned newCapacity = (pointCapacity > limit / 2) ? limit : 2 * pointCapacity;
+    uint8_t* newData = new uint8_t[newCapacity * vertexStride];
+    memcpy(newData, vertexData, pointBufferPosition * vertexStride);
+    delete [] vertexData;
+    vertexData = newData;
+    pointCapacity = newCapacity;
+}
+
 //Workaround for OS X
 void Canvas::handleIO() {
   #ifdef __APPLE__
@@ -528,7 +792,7 @@ void Canvas::handleIO() {
         return;  //If we're not the main thread, we can't call this
     windowMutex.lock();
     glfwMakeContextCurrent(window);
-    glfwPollEvents();
+    pollEvents();
     glfwMakeContextCurrent(NULL);
     windowMutex.unlock();
     if (toClose && !windowClosed) {
@@ -542,13 +806,32 @@ void Canvas::handleIO() {
 }
 
 void Canvas::init(int xx, int yy, int ww, int hh, unsigned int b, std::string title, double timerLength) {
+    createdAt = highResClock::now();
+    timeToFirstFrame = 0;
+
+    glfwMutex.lock();
     ++openCanvases;
+    if (sharingResources) {
+      loader = sharedLoader.lock();     // Reuse the resources of the other sharing Canvases, if there are any
+      if (!loader)
+        sharedLoader = loader = std::make_shared<TextureHandler>();
+    } else {
+      loader = std::make_shared<TextureHandler>();
+    }
+    glfwMutex.unlock();
 
     if (ww == -1)
       ww = 1.2*Canvas::getDisplayHeight();
     if (hh == -1)
       hh = 0.75*ww;
     b = ww*hh*2;
+    maxBufferSize = b;
+    overflowPolicy = TSGL_DROP_OLDEST;
+    droppedPoints = droppedShapes = 0;
+    worldBufferCapacity = worldRunsDrawn = worldUploaded = 0;
+    worldChanged = false;
+    worldTransform[0] = worldTransform[1] = 1;  // World coordinates are pixels until told otherwise
+    worldTransform[2] = worldTransform[3] = 0;
 
     winTitle = title;
     winWidth = ww, winHeight = hh;
@@ -558,34 +841,43 @@ void Canvas::init(int xx, int yy, int ww, int hh, unsigned int b, std::string ti
     windowClosed = false;
 	  readyToDraw = false;
     frameCounter = 0;
-    syncMutexLocked = 0;
-	  syncMutexOwner = -1;
+    framesStarted = framesRendered = 0;
 
     int padwidth = winWidth % 4;
     if (padwidth > 0)
        padwidth = 4-padwidth;
     winWidthPadded = winWidth + padwidth;
     bufferSize = 3 * (winWidthPadded+1) * winHeight;
-    screenBuffer = new uint8_t[bufferSize];
-    for (unsigned i = 0; i < bufferSize; ++i) {
-      screenBuffer[i] = 0;
-    }
+    unsigned screenSize = bufferSize;
+    std::future<uint8_t*> screenAlloc = std::async(std::launch::async, [screenSize]() {
+      return new uint8_t[screenSize]();  // Zero the (large) screen buffer while the window is being created
+    });
 
     toClear = true;                   // Don't need to clear at the start
     started = false;                  // We haven't started the window yet
     monitorX = xx;
     monitorY = yy;
-    myShapes = new Array<Shape*>(b);  // Initialize myShapes
-    myBuffer = new Array<Shape*>(b);
-    vertexData = new float[6 * b];    // Buffer for vertexes for points
+    unsigned initialSize = std::min(b, MIN_BUFFER_SIZE);
+    myShapes = new Array<Shape*>(initialSize, b);  // Initialize myShapes
+    myBuffer = new Array<Shape*>(initialSize, b);
+    packedPoints = true;              // Store points as PackedVertex by default
+    vertexStride = sizeof(PackedVertex);
+    pointCapacity = drawPointCapacity = initialSize;
+    vertexData = new uint8_t[vertexStride * pointCapacity];  // Buffers for vertexes for points
+    drawVertexData = new uint8_t[vertexStride * drawPointCapacity];
     showFPS = false;                  // Set debugging FPS to false
     isFinished = false;               // We're not done rendering
-    pointBufferPosition = pointLastPosition = 0;
+    pointBufferPosition = 0;
     loopAround = false;
     toRecord = 0;
 
     bgcolor = GRAY;
     window = nullptr;
+    hub = nullptr;
+    sharedShaders = sharesContext = false;
+    dispatchOnThread = true;          // Handle input on a thread of our own unless told otherwise
+    inputSleeping = false;
+    inputStopping = false;
 
     drawTimer = new Timer((timerLength > 0.0f) ? timerLength : FRAME);
 
@@ -598,6 +890,7 @@ void Canvas::init(int xx, int yy, int ww, int hh, unsigned int b, std::string ti
     initGlew();
     glfwMakeContextCurrent(NULL);   // Reset the context
 #endif
+    screenBuffer = screenAlloc.get();
 }
 
 void Canvas::initGl() {
@@ -609,6 +902,17 @@ void Canvas::initGl() {
     glfwSetWindowUserPointer(window, this);
 #endif
 
+    // Use our RenderHub's shader programs if we can see them, or compile our own
+    sharedShaders = (hub != nullptr && sharesContext);
+    if (sharedShaders) {
+      shaderProgram = hub->shaderProgram;
+      textureShaderProgram = hub->textureShaderProgram;
+    } else {
+      shaderProgram = createShaderProgram(false, shaderVertex, shaderFragment);
+      textureShaderProgram = createShaderProgram(true, textureShaderVertex, textureShaderFragment);
+    }
+    textureShaders(false);
+
     // Enable and disable necessary stuff
     glDisable(GL_DEPTH_TEST);                           // Disable depth testing because we're not drawing in 3d
     glDisable(GL_DITHER);                               // Disable dithering because pixels do not (generally) overlap
@@ -642,17 +946,7 @@ void Canvas::initGlew() {
         exit(102);
     }
 
-    hasEXTFramebuffer = false;
-
-    GLint n, i;
-    glGetIntegerv(GL_NUM_EXTENSIONS, &n);
-    for (i = 0; i < n; i++) {
-      std::string s = reinterpret_cast< char const * >(glGetStringi(GL_EXTENSIONS, i));
-      if (s == "GL_EXT_framebuffer_object") {
-        hasEXTFramebuffer = true;
-        break;
-      }
-    }
+    hasEXTFramebuffer = (GLEW_EXT_framebuffer_object != 0);  // glewInit() already looked through the extensions
     const GLubyte* gfxVendor = glGetString(GL_VENDOR);
     std::string gfx(gfxVendor, gfxVendor + strlen((char*)gfxVendor));
     atiCard = (gfx.find("ATI") != std::string::npos);
@@ -662,64 +956,24 @@ void Canvas::initGlew() {
         printf("OpenGL version: %s\n", glGetString(GL_VERSION));
         printf("GLFW version:   %s\n", glfwGetVersionString());
         printf("GL Extension: ");
+        GLint n, i;
+        glGetIntegerv(GL_NUM_EXTENSIONS, &n);
         for (i = 0; i < n; i++)
           printf("%s, ", glGetStringi(GL_EXTENSIONS, i));
         if (hasEXTFramebuffer)
           TsglDebug("EXT Framebuffer available");
     #endif
 
-    GLint status;
-
     // Create and bind our Vertex Array Object
     glGenVertexArrays(1, &vertexArray);
     glBindVertexArray(vertexArray);
 
-    // Create and bind our Vertex Buffer Object
+    // Create a Vertex Buffer Object for retained geometry, then create and bind our Vertex Buffer Object
+    glGenBuffers(1, &worldBuffer);
     glGenBuffers(1, &vertexBuffer);
     glBindBuffer(GL_ARRAY_BUFFER, vertexBuffer);
 
-    // Create / compile vertex shader
-    shaderVertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(shaderVertex, 1, &vertexSource, NULL);
-    glCompileShader(shaderVertex);
-    glGetShaderiv(shaderVertex, GL_COMPILE_STATUS, &status);
-
-    // Create / compile fragment shader
-    shaderFragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(shaderFragment, 1, &fragmentSource, NULL);
-    glCompileShader(shaderFragment);
-    glGetShaderiv(shaderFragment, GL_COMPILE_STATUS, &status);
-
-    // Attach both shaders to a shader program, link the program
-    shaderProgram = glCreateProgram();
-    glAttachShader(shaderProgram, shaderVertex);
-    glAttachShader(shaderProgram, shaderFragment);
-    glBindFragDataLocation(shaderProgram, 0, "outColor");
-
-    // Specify the layout of the vertex data in our standard shader
-    glLinkProgram(shaderProgram);
-
-    // Create / compile textured vertex shader
-    textureShaderVertex = glCreateShader(GL_VERTEX_SHADER);
-    glShaderSource(textureShaderVertex, 1, &textureVertexSource, NULL);
-    glCompileShader(textureShaderVertex);
-    glGetShaderiv(textureShaderVertex, GL_COMPILE_STATUS, &status);
-
-    // Create / compile textured fragment shader
-    textureShaderFragment = glCreateShader(GL_FRAGMENT_SHADER);
-    glShaderSource(textureShaderFragment, 1, &textureFragmentSource, NULL);
-    glCompileShader(textureShaderFragment);
-    glGetShaderiv(textureShaderFragment, GL_COMPILE_STATUS, &status);
-
-    // Attach both shaders to another shader program, link the program
-    textureShaderProgram = glCreateProgram();
-    glAttachShader(textureShaderProgram, textureShaderVertex);
-    glAttachShader(textureShaderProgram, textureShaderFragment);
-    glBindFragDataLocation(textureShaderProgram, 0, "outColor");
-
-    // Specify the layout of the vertex data in our textured shader
-    glLinkProgram(textureShaderProgram);
-    textureShaders(false);
+    // Shader programs are set up in initGl(), once we know whether we can share a RenderHub's
 
     /****** NEW ******/
     // Create a framebuffer
@@ -764,25 +1018,10 @@ void Canvas::initGlfw() {
 void Canvas::initWindow() {
     glfwSetErrorCallback(errorCallback);
 
-     // Create a Window and the Context
-  #ifdef __arm__                                                    // Tentative fix for the Raspberry Pi
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 2);                  // Set target GL major version to 2
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);                  // Set target GL minor version to 2.0
-    glfwWindowHint(GLFW_CLIENT_API,GLFW_OPENGL_ES_API);             // Pi uses OpenGL ES
-  #else
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);                  // Set target GL major version to 3
-    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 2);                  // Set target GL minor version to 3.2
-    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);  // We're using the standard GL Profile
-    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);            // Don't use methods that are deprecated in the target version
-  #endif
-    glfwWindowHint(GLFW_RESIZABLE, GL_FALSE);                       // Do not let the user resize the window
-    glfwWindowHint(GLFW_STEREO, GL_FALSE);                          // Disable the right buffer
-    glfwWindowHint(GLFW_DOUBLEBUFFER, GL_FALSE);                    // Disable the back buffer
-    glfwWindowHint(GLFW_VISIBLE, GL_FALSE);                         // Don't show the window at first
-    glfwWindowHint(GLFW_SAMPLES,4);
-
     glfwMutex.lock();                                  // GLFW crashes if you try to make more than once window at once
-    window = glfwCreateWindow(winWidth, winHeight, winTitle.c_str(), NULL, NULL);  // Windowed
+    setWindowHints();
+    sharesContext = (sharedWindow != nullptr);
+    window = glfwCreateWindow(winWidth, winHeight, winTitle.c_str(), NULL, sharedWindow);  // Windowed
  //   window = glfwCreateWindow(monInfo->width, monInfo->height, title_.c_str(), glfwGetPrimaryMonitor(), NULL);  // Fullscreen
     if (!window) {
         fprintf(stderr, "GLFW window creation failed. Was the library correctly initialized?\n");
@@ -807,50 +1046,120 @@ void Canvas::initWindow() {
     glfwSetMouseButtonCallback(window, buttonCallback);
     glfwSetKeyCallback(window, keyCallback);
     glfwSetScrollCallback(window, scrollCallback);
+    glfwSetCursorPosCallback(window, cursorCallback);
 }
 
 void Canvas::keyCallback(GLFWwindow* window, int key, int scancode, int action, int mods) {
     buttonCallback(window, key, action, mods);
 }
 
+uint8_t* Canvas::nextPoint(std::unique_lock<std::mutex>& lock) {
+    while (pointBufferPosition >= pointCapacity) {
+        if (pointCapacity < maxBufferSize) {
+            growPointBuffer(maxBufferSize);
+        } else if (overflowPolicy == TSGL_BLOCK && canWaitForDrain()) {
+            pointArrayDrained.wait_for(lock, std::chrono::duration<double>(FRAME));  // Check back every frame in case we can't wait anymore
+        } else if (overflowPolicy != TSGL_DROP_OLDEST) {
+            growPointBuffer(2 * pointCapacity);
+        } else {
+            loopAround = true;
+            pointBufferPosition = 0;
+        }
+    }
+    if (loopAround)
+        ++droppedPoints;  // We're overwriting a point that hasn't been drawn yet
+    return &vertexData[pointBufferPosition++ * vertexStride];
+}
+
 void Canvas::pauseDrawing() {
-  #pragma omp critical (pauseResume)
-  {
-    if (syncMutexLocked == 0 && syncMutexOwner == -1) {
-      syncMutex.lock();
-      syncMutexOwner = omp_get_thread_num();
+    frameBarrier.beginUpdate();
+}
+
+void Canvas::pointShaders() {
+    if (!packedPoints)
+      return;  // The float vertex format is already set up by textureShaders(false)
+
+    // Read positions as (non-normalized) shorts and colors as normalized bytes
+    GLint posAttrib = glGetAttribLocation(shaderProgram, "position");
+    glEnableVertexAttribArray(posAttrib);
+    glVertexAttribPointer(posAttrib, 2, GL_SHORT, GL_FALSE, sizeof(PackedVertex), 0);
+    GLint colAttrib = glGetAttribLocation(shaderProgram, "color");
+    glEnableVertexAttribArray(colAttrib);
+    glVertexAttribPointer(colAttrib, 4, GL_UNSIGNED_BYTE, GL_TRUE, sizeof(PackedVertex),
+                          (void*) offsetof(PackedVertex, r));
+
+    // Integer positions can't hold the ATI half-pixel offset, so move it into the model matrix
+    if (atiCard) {
+      float modelF[] = { 1, 0, 0, 0, 0, 1, 0, 0, 0, 0, 1, 0, 0, 0.5f, 0, 1 };
+      glUniformMatrix4fv(uniModel, 1, GL_FALSE, &modelF[0]);
     }
-    #pragma omp critical (syncMutLock)
-    {
-      ++syncMutexLocked;
+}
+
+void Canvas::pollEvents() {
+    // glfwPollEvents() runs the callbacks of every window, and each Canvas' InputQueue only takes
+    // one producer at a time. If another thread is already polling, it will handle our events too.
+    std::unique_lock<std::mutex> lock(pollMutex, std::try_to_lock);
+    if (lock.owns_lock())
+      glfwPollEvents();
+}
+
+bool Canvas::pollInputEvent(InputEvent& event) {
+    if (dispatchOnThread)
+      return false;  // inputThread is taking the events
+    return inputEvents.pop(event);
+}
+
+void Canvas::pushInputEvent(InputEvent event) {
+    event.time = std::chrono::duration_cast<duration_d>(highResClock::now() - createdAt).count();
+    inputEvents.push(event);
+    if (dispatchOnThread) {
+      //Either inputThread sees the event before it sleeps, or we see that it may be asleep (the fences pair up).
+      //Only then do we lock, to make sure it is in fact asleep before waking it, so that pushing stays lock-free
+      //while inputThread is busy dispatching.
+      std::atomic_thread_fence(std::memory_order_seq_cst);
+      if (inputSleeping) {
+        { std::lock_guard<std::mutex> lock(inputMutex); }
+        inputReady.notify_one();
+      }
     }
-  }
 }
 
 void Canvas::recordForNumFrames(unsigned int num_frames) {
     toRecord = num_frames;
 }
 
+void Canvas::releaseGlfw() {
+    glfwMutex.lock();
+    if (--openCanvases == 0) {
+        glfwIsReady = false;
+        sharedWindow = nullptr;  // Destroyed along with everything else
+        glfwTerminate();  // Terminate GLFW
+    }
+    glfwMutex.unlock();
+}
+
 void Canvas::reset() {
     drawTimer->reset();
 }
 
-void Canvas::resumeDrawing() {
-  #pragma omp critical (syncMutLock)
-  {
-    --syncMutexLocked;
-  }
-  #pragma omp critical (pauseResume)
-  {
-    if (syncMutexOwner == omp_get_thread_num()) {
-      while (syncMutexLocked > 0)
-        sleepFor(FRAME/2);
-      syncMutex.unlock();
-      syncMutexOwner = -1;
+GLFWwindow* Canvas::retainSharedWindow() {
+    initGlfw();
+    glfwMutex.lock();
+    if (sharedWindow == nullptr) {
+        setWindowHints();
+        sharedWindow = glfwCreateWindow(1, 1, "", NULL, NULL);  // Never shown; only holds the shared GL objects
+        if (!sharedWindow) {
+            fprintf(stderr, "GLFW window creation failed. Was the library correctly initialized?\n");
+            exit(100);
+        }
     }
-  }
-  while (syncMutexOwner != -1)
-    sleepFor(FRAME/2);
+    ++openCanvases;
+    glfwMutex.unlock();
+    return sharedWindow;
+}
+
+void Canvas::resumeDrawing() {
+    frameBarrier.endUpdate();
 }
 
 void Canvas::run(void (*myFunction)(Canvas&) ) {
@@ -882,12 +1191,13 @@ void Canvas::screenShot() {
     char filename[25];
     sprintf(filename, "Image%06d.png", frameCounter);  // TODO: Make this save somewhere not in root
 
-    loader.saveImageToFile(filename, screenBuffer, winWidthPadded, winHeight);
+    loader->saveImageToFile(filename, screenBuffer, winWidthPadded, winHeight);
 }
 
 void Canvas::scrollCallback(GLFWwindow* window, double xpos, double ypos) {
     Canvas* can = reinterpret_cast<Canvas*>(glfwGetWindowUserPointer(window));
-    if (can->scrollFunction) can->scrollFunction(xpos, ypos);
+    InputEvent e = { TSGL_SCROLL_EVENT, 0, 0, 0, xpos, ypos, 0.0 };
+    can->pushInputEvent(e);
 }
 
 void Canvas::setBackgroundColor(ColorFloat color) {
@@ -899,23 +1209,92 @@ void Canvas::setBackgroundColor(ColorFloat color) {
     }
 }
 
+void Canvas::setDispatchThread(bool on) {
+    if (started) {
+      TsglDebug("Canvas already started; can't change who dispatches input events.");
+      return;
+    }
+    dispatchOnThread = on;
+}
+
 void Canvas::setDrawBuffer(int buffer) {
     Canvas::drawBuffer = buffer;
 }
 
 void Canvas::setFont(std::string filename) {
-    loader.loadFont(filename);
+    loader->loadFont(filename);
+}
+
+void Canvas::setOverflowPolicy(OverflowPolicy policy) {
+    bufferMutex.lock();
+    pointArrayMutex.lock();
+    overflowPolicy = policy;
+    pointArrayMutex.unlock();
+    bufferMutex.unlock();
+}
+
+void Canvas::setPackedPoints(bool packed) {
+    if (started || packed == packedPoints) return;
+    pointArrayMutex.lock();
+    packedPoints = packed;
+    vertexStride = packed ? sizeof(PackedVertex) : FLOAT_VERTEX_SIZE * sizeof(float);
+    delete [] vertexData;
+    delete [] drawVertexData;
+    vertexData = new uint8_t[vertexStride * pointCapacity];
+    drawVertexData = new uint8_t[vertexStride * drawPointCapacity];
+    pointArrayMutex.unlock();
+}
+
+void Canvas::setMaxBufferSize(unsigned size) {
+    bufferMutex.lock();
+    pointArrayMutex.lock();
+    maxBufferSize = std::max(size, pointCapacity);
+    myBuffer->setMaxCapacity(size);
+    myShapes->setMaxCapacity(size);
+    pointArrayMutex.unlock();
+    bufferMutex.unlock();
+}
+
+void Canvas::setSharedResources(bool share) {
+    if (share == sharingResources)
+      return;
+    if (share)
+      retainSharedWindow();  // Lets the windows of new Canvases share GL objects with each other
+    glfwMutex.lock();
+    sharingResources = share;
+    glfwMutex.unlock();
+    if (!share)
+      releaseGlfw();
 }
 
 void Canvas::setShowFPS(bool b) {
     showFPS = b;
 }
 
-void Canvas::setupCamera() {
-    // Set up camera positioning
+void Canvas::setWindowHints() {
+    // Create a Window and the Context
+  #ifdef __arm__                                                    // Tentative fix for the Raspberry Pi
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 2);                  // Set target GL major version to 2
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 0);                  // Set target GL minor version to 2.0
+    glfwWindowHint(GLFW_CLIENT_API,GLFW_OPENGL_ES_API);             // Pi uses OpenGL ES
+  #else
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MAJOR, 3);                  // Set target GL major version to 3
+    glfwWindowHint(GLFW_CONTEXT_VERSION_MINOR, 2);                  // Set target GL minor version to 3.2
+    glfwWindowHint(GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE);  // We're using the standard GL Profile
+    glfwWindowHint(GLFW_OPENGL_FORWARD_COMPAT, GL_TRUE);            // Don't use methods that are deprecated in the target version
+  #endif
+    glfwWindowHint(GLFW_RESIZABLE, GL_FALSE);                       // Do not let the user resize the window
+    glfwWindowHint(GLFW_STEREO, GL_FALSE);                          // Disable the right buffer
+    glfwWindowHint(GLFW_DOUBLEBUFFER, GL_FALSE);                    // Disable the back buffer
+    glfwWindowHint(GLFW_VISIBLE, GL_FALSE);                         // Don't show the window at first
+    glfwWindowHint(GLFW_SAMPLES,4);
+}
+
+void Canvas::setupCamera(float scaleX, float scaleY, float offsetX, float offsetY) {
+    // Set up camera positioning, first scaling and offsetting the vertices into pixels
     // Note: (winWidth-1) is a dark voodoo magic fix for some camera issues
-    float viewF[] = { 1, 0, 0, 0, 0, -1, 0, 0, 0, 0, -1, 0,
-      -(winWidth-1) / 2.0f, (winHeight) / 2.0f, -(winHeight) / 2.0f, 1 };
+    float viewF[] = { scaleX, 0, 0, 0, 0, -scaleY, 0, 0, 0, 0, -1, 0,
+      offsetX - (winWidth-1) / 2.0f, (winHeight) / 2.0f - offsetY, -(winHeight) / 2.0f, 1 };
 //    float viewF[] = { 1, 0, 0, 0, 0, -1, 0, 0, 0, 0, -1, 0,
 //      -(winWidth-1) / 2.0f, (winHeight+0.5f) / 2.0f, -(winHeight-0.5f) / 2.0f, 1 };
     glUniformMatrix4fv(uniView, 1, GL_FALSE, &viewF[0]);
@@ -929,6 +1308,16 @@ void Canvas::setupCamera() {
     glUniformMatrix4fv(uniModel, 1, GL_FALSE, &modelF[0]);
 }
 
+void Canvas::setWorldTransform(float scaleX, float scaleY, float offsetX, float offsetY) {
+    std::lock_guard<std::mutex> lock(worldMutex);
+    worldTransform[0] = scaleX;
+    worldTransform[1] = scaleY;
+    worldTransform[2] = offsetX;
+    worldTransform[3] = offsetY;
+    if (!worldRuns.empty())
+      worldChanged = true;  // Redraw the retained geometry where it now belongs
+}
+
 void Canvas::sleep() {
   #ifdef __APPLE__
     handleIO();
@@ -946,6 +1335,12 @@ void Canvas::sleepFor(float seconds) {
 int Canvas::start() {
     if (started) return -1;
     started = true;
+    if (dispatchOnThread)
+      inputThread = std::thread(Canvas::startDispatching, this);  // Spawn the thread that handles input
+    if (hub != nullptr) {
+      hub->attach(this);  // Our RenderHub's thread will do the drawing
+      return 0;
+    }
   #ifdef __APPLE__
     pthread_create(&renderThread,NULL,startDrawing,(void*)this);
   #else
@@ -957,21 +1352,35 @@ int Canvas::start() {
 #ifdef __APPLE__
 void* Canvas::startDrawing(void* cPtr) {
     Canvas* c = (Canvas*)cPtr;
+    c->renderThreadId = std::this_thread::get_id();
     c->initGl();
     c->draw();
-    c->isFinished = true;
+    c->endDrawing();
     pthread_exit(NULL);
 }
 #else
 void Canvas::startDrawing(Canvas *c) {
+    c->renderThreadId = std::this_thread::get_id();
     c->initGl();
     c->draw();
-    c->isFinished = true;
-    glfwDestroyWindow(c->window);
-    c->glDestroy();
+    c->endDrawing();
 }
 #endif
 
+void Canvas::startDispatching(Canvas* c) {
+    c->dispatchLoop();
+}
+
+void Canvas::stopDispatching() {
+    if (!inputThread.joinable() || std::this_thread::get_id() == inputThread.get_id())
+      return;
+    inputMutex.lock();
+    inputStopping = true;
+    inputMutex.unlock();
+    inputReady.notify_one();
+    inputThread.join();
+}
+
 void Canvas::stop() {
     close();
     wait();
@@ -981,6 +1390,18 @@ void Canvas::stopRecording() {
     toRecord = 0;
 }
 
+bool Canvas::sync(unsigned long fence) {
+    if (!started || std::this_thread::get_id() == renderThreadId)
+      return false;
+    std::unique_lock<std::mutex> lock(stateMutex);
+    stateChanged.wait(lock, [this, fence]{ return framesRendered >= fence || isFinished; });
+    return framesRendered >= fence;
+}
+
+bool Canvas::sync() {
+    return sync(flush());
+}
+
 void Canvas::takeScreenShot() {
     if (toRecord == 0) toRecord = 1;
 }
@@ -1032,13 +1453,35 @@ int Canvas::wait() {
   #ifdef __APPLE__
     while(!isFinished)
       sleepFor(0.1f);
-    pthread_join(renderThread, NULL);
+    if (hub == nullptr)
+      pthread_join(renderThread, NULL);
   #else
-    renderThread.join();
+    if (hub == nullptr)
+      renderThread.join();
+    else {
+      std::unique_lock<std::mutex> lock(stateMutex);
+      stateChanged.wait(lock, [this]{ return isFinished; });
+    }
   #endif
+    stopDispatching();
     return 0;
 }
 
+void Canvas::writePoint(uint8_t* vertex, int x, int y, const ColorFloat& color) {
+    if (packedPoints) {
+      packVertex(x, y, color, *reinterpret_cast<PackedVertex*>(vertex));  // ATI offset is applied in pointShaders()
+    } else {
+      float atioff = atiCard ? 0.5f : 0.0f;
+      float* v = reinterpret_cast<float*>(vertex);
+      v[0] = x;
+      v[1] = y+atioff;
+      v[2] = color.R;
+      v[3] = color.G;
+      v[4] = color.B;
+      v[5] = color.A;
+    }
+}
+
 //-----------------Unit testing-------------------------------------------------------
 void Canvas::runTests() {
   TsglDebug("Testing Canvas class...");
@@ -1047,8 +1490,11 @@ void Canvas::runTests() {
   c1.start();
   tsglAssert(testFilledDraw(c1), "Unit test for filled draw failed!");
   tsglAssert(testLine(c1), "Unit test for line failed!");
+  tsglAssert(testRaster(c1), "Unit test for rasters failed!");
   tsglAssert(testAccessors(c1), "Unit test for accessors failed!");
   tsglAssert(testDrawImage(c1), "Unit test for drawing images failed!");
+  tsglAssert(testBufferGrowth(c1), "Unit test for buffer growth failed!");
+  tsglAssert(testSync(c1), "Unit test for syncing failed!");
   c1.stop();
   TsglDebug("Unit tests for Canvas complete.");
   std::cout << std::endl;
@@ -1060,7 +1506,7 @@ bool Canvas::testFilledDraw(Canvas& can) {
   int failed = 0;   //Failed tests
   ColorInt red(255, 0, 0);   //Fill color
   can.drawCircle(250, 250, 50, 32, red, true);  //Draw filled shape
-  can.sleepFor(1);
+  can.sync();
 
   //Test 1: Get middle pixel and see if its red.
   if(can.getPixel(250, 250) == red) {
@@ -1138,7 +1584,7 @@ bool Canvas::testLine(Canvas & can) {
    int failed = 0;
    can.drawLine(0, 0, 250, 250, BLACK);  //Diagonal line
    can.drawLine(253, 253, 400, 253);  //Straight line
-   can.sleepFor(1);
+   can.sync();
    ColorInt black(0, 0, 0);
    //Test 1: Near the ending endpoint? (Diagonal)
    if(can.getPoint(249, 249) == black) {
@@ -1195,6 +1641,56 @@ bool Canvas::testLine(Canvas & can) {
    }
 }
 
+bool Canvas::testRaster(Canvas& can) {
+   int passed = 0;
+   int failed = 0;
+   const int W = 40, H = 30;
+   ColorFloat* colors = new ColorFloat[W * H];
+   for (int i = 0; i < W * H; ++i)
+     colors[i] = ((i % W) < W / 2) ? RED : BLUE;  //Left half red, right half blue
+   can.drawRaster(100, 200, W, H, colors);
+   can.sync();
+   delete [] colors;
+   ColorInt red(MAX_COLOR, 0, 0), blue(0, 0, MAX_COLOR), white(MAX_COLOR, MAX_COLOR, MAX_COLOR);
+   //Test 1: Corners of the raster
+   if (can.getPoint(100, 200) == red && can.getPoint(100 + W - 1, 200 + H - 1) == blue) {
+     passed++;
+   } else {
+     failed++;
+     TsglErr("Test 1, Corners of the raster for testRaster() failed!");
+   }
+
+   //Test 2: Every pixel, and only those pixels
+   int count = 0;
+   for (int y = 199; y <= 200 + H; ++y)
+     for (int x = 99; x <= 100 + W; ++x) {
+       bool inside = x >= 100 && x < 100 + W && y >= 200 && y < 200 + H;
+       ColorInt expected = !inside ? white : (x < 100 + W / 2) ? red : blue;
+       if (can.getPoint(x, y) == expected)
+         count++;
+     }
+   if (count == (W + 2) * (H + 2)) {
+     passed++;
+   } else {
+     failed++;
+     TsglErr("Test 2, Every pixel, and only those pixels for testRaster() failed!");
+   }
+
+   //Results:
+   if (passed == 2 && failed == 0) {
+     can.clear();
+     TsglDebug("Unit test for rasters passed!");
+     return true;
+   } else {
+     can.clear();
+     TsglErr("This many passed testRaster(): ");
+     std::cerr << " " << passed << std::endl;
+     TsglErr("This many failed for testRaster(): ");
+     std::cerr << " " << failed << std::endl;
+     return false;
+   }
+}
+
 bool Canvas::testAccessors(Canvas& can) {
     int passed = 0;
     int failed = 0;
@@ -1250,8 +1746,16 @@ bool Canvas::testAccessors(Canvas& can) {
       TsglErr("Test 4, Window open? for testAccessors() failed!");
     }
 
+    //Test 5: Time to the first frame should have been measured by now
+    if(can.getTimeToFirstFrame() > 0) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 5, Time to first frame for testAccessors() failed!");
+    }
+
     //Results:
-    if(passed == 4 && failed == 0) {
+    if(passed == 5 && failed == 0) {
       can.clear();
       TsglDebug("Unit test for accessors/mutators passed!");
       return true;
@@ -1265,9 +1769,94 @@ bool Canvas::testAccessors(Canvas& can) {
     }
 }
 
+bool Canvas::testBufferGrowth(Canvas& can) {
+    int passed = 0;
+    int failed = 0;
+    size_t oldFixedUsage = (size_t) 500 * 500 * 2 * (2 * sizeof(Shape*) + FLOAT_VERTEX_SIZE * sizeof(float));
+
+    //Test 1: A fresh Canvas shouldn't allocate its buffers for the worst case
+    size_t before = can.getMemoryUsage();
+    if(before < oldFixedUsage / 10) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 1, initial memory usage for testBufferGrowth() failed!");
+    }
+
+    //Test 2: Drawing lots of points in one frame should grow the point buffer
+    can.pauseDrawing();
+    for(int i = 0; i < 100; i++) {
+      for(int j = 0; j < 100; j++) {
+        can.drawPoint(i, j, BLACK);
+      }
+    }
+    size_t after = can.getMemoryUsage();
+    can.resumeDrawing();
+    if(after > before) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 2, point buffer growth for testBufferGrowth() failed!");
+    }
+
+    //Test 3: Past the maximum size, the oldest points should be dropped (and counted)
+    can.sleepFor(FRAME * 2);
+    can.setMaxBufferSize(0);  //Can't shrink, so this stops the buffers from growing any further
+    can.pauseDrawing();
+    unsigned long dropped = can.getDroppedPoints();
+    for(int i = 0; i < 200; i++) {
+      for(int j = 0; j < 200; j++) {
+        can.drawPoint(i, j, BLACK);
+      }
+    }
+    unsigned long droppedAfter = can.getDroppedPoints();
+    can.resumeDrawing();
+    if(droppedAfter > dropped) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 3, dropping points for testBufferGrowth() failed!");
+    }
+
+    //Test 4: Growing past the maximum size shouldn't drop anything
+    can.sleepFor(FRAME * 2);
+    can.setOverflowPolicy(TSGL_GROW);
+    can.pauseDrawing();
+    dropped = can.getDroppedPoints();
+    for(int i = 0; i < 200; i++) {
+      for(int j = 0; j < 200; j++) {
+        can.drawPoint(i, j, BLACK);
+      }
+    }
+    droppedAfter = can.getDroppedPoints();
+    can.resumeDrawing();
+    if(droppedAfter == dropped) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 4, growing past the maximum size for testBufferGrowth() failed!");
+    }
+    can.setOverflowPolicy(TSGL_DROP_OLDEST);
+    can.setMaxBufferSize(500 * 500 * 2);
+
+    //Results:
+    if(passed == 4 && failed == 0) {
+      can.clear();
+      TsglDebug("Unit test for buffer growth passed!");
+      return true;
+    } else {
+      can.clear();
+      TsglErr("This many passed for testBufferGrowth(): ");
+      std::cerr << " " << passed << std::endl;
+      TsglErr("This many failed for testBufferGrowth(): ");
+      std::cerr << " " << failed << std::endl;
+      return false;
+    }
+}
+
 bool Canvas::testDrawImage(Canvas& can) {
     can.drawImage("../assets/pics/ff0000.png", 0, 0, 200, 200);
-    can.sleepFor(1);
+    can.sync();
     int passed = 0;
     int failed = 0;
     ColorInt red(255, 0, 0);
@@ -1308,5 +1897,55 @@ bool Canvas::testDrawImage(Canvas& can) {
       return false;
     }
 }
+
+bool Canvas::testSync(Canvas& can) {
+    int passed = 0;
+    int failed = 0;
+    ColorInt blue(0, 0, 255);
+    //Test 1: Points drawn before a fence should be readable once it has been reached
+    for (int i = 300; i < 320; ++i)
+      can.drawPoint(i, 400, blue);
+    unsigned long fence = can.flush();
+    if (can.sync(fence) && can.getPoint(300, 400) == blue && can.getPoint(319, 400) == blue) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 1, points readable after sync for testSync() failed!");
+    }
+
+    //Test 2: Fences only move forward, and a reached fence returns immediately
+    unsigned long next = can.flush();
+    if (next > fence && can.sync(fence)) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 2, ordering of fences for testSync() failed!");
+    }
+
+    //Test 3: Shapes drawn from several threads should all be readable after sync()
+    #pragma omp parallel num_threads(4)
+    {
+      int y = 420 + 10 * omp_get_thread_num();
+      can.drawRectangle(300, y, 320, y + 5, blue);
+    }
+    if (can.sync() && can.getPoint(310, 422) == blue && can.getPoint(310, 452) == blue) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 3, shapes from many threads for testSync() failed!");
+    }
+
+    if (passed == 3 && failed == 0) {
+      TsglDebug("Unit test for syncing passed!");
+      return true;
+    } else {
+      TsglErr("This many passed for testSync(): ");
+      std::cerr << " " << passed << std::endl;
+      TsglErr("This many failed for testSync(): ");
+      std::cerr << " " << failed << std::endl;
+      return false;
+    }
+}
 //------------End Unit testing--------------------------------------------------------
+
 }
@@ -12,10 +12,12 @@
 
 #include "Array.h"          // Our own array for buffering drawing operations
 #include "Color.h"          // Our own interface for converting color types
+#include "FrameBarrier.h"   // Our own lock for pausing the rendering thread
 #include "TriangleStrip.h" // Our own class for drawing polygons with colored vertices
 #include "ConcavePolygon.h" // Our own class for concave polygons with colored vertices
 #include "ConvexPolygon.h"  // Our own class for convex polygons with colored vertices
 #include "Image.h"          // Our own class for drawing images / textured quads
+#include "InputQueue.h"     // Our own queue for passing input events off the I/O thread
 #include "Keynums.h"        // Our enums for key presses
 #include "Line.h"           // Our own class for drawing straight lines
 #include "Polyline.h"       // Our own class for drawing polylines
@@ -25,14 +27,21 @@
 #include "Timer.h"          // Our own timer for steady FPS
 #include "Triangle.h"       // Our own class for drawing triangles
 #include "Util.h"           // Needed constants and has cmath for performing math operations
+#include "Vertex.h"         // Our own packed vertex format for the point buffer
 
+#include <atomic>           // For checking whether the Canvas is ready without locking
+#include <condition_variable> // For blocking drawing threads until the buffers are drained
+#include <future>           // For allocating buffers while the window is being created
 #include <functional>       // For callback upon key presses
 #include <iostream>         // DEBUGGING
+#include <memory>           // For sharing a TextureHandler between Canvases
 #include <mutex>            // Needed for locking the Canvas for thread-safety
 #include <sstream>          // For string building
 #include <string>           // For window titles
+#include <vector>           // For retaining geometry in world coordinates
 #ifdef __APPLE__
   #include <pthread.h>
+  #include <thread>           // For std::this_thread
 #else
   #include <thread>           // For spawning rendering in a different thread
 #endif
@@ -48,6 +57,18 @@
 
 namespace tsgl {
 
+class RenderHub;  // Forward declaration for rendering several Canvases from one thread
+
+/*!
+ * \brief What a Canvas does when more is drawn in a single frame than its buffers can hold.
+ * \see Canvas::setOverflowPolicy(), Canvas::setMaxBufferSize()
+ */
+enum OverflowPolicy {
+  TSGL_DROP_OLDEST,   // Discard the oldest shapes / points queued for the frame (the default)
+  TSGL_BLOCK,         // Make the drawing thread wait until the rendering thread has drained the buffers
+  TSGL_GROW           // Keep growing the buffers past their maximum size
+};
+
 /*! \class Canvas
  *  \brief A GL window with numerous built-in, thread-safe drawing operations.
  *  \details Canvas provides an easy-to-set-up, easy-to-use class for drawing various shapes.
@@ -65,28 +86,55 @@ private:
     typedef std::function<void(double, double)>     doubleFunction;
     typedef std::function<void()>                   voidFunction;
 
+    struct WorldRun {
+      GLenum        mode;                                               // Primitive to draw the vertices as
+      unsigned      first, count;                                       // Range of worldVertices in the run
+    };
+
     float           aspect;                                             // Aspect ratio used for setting up the window
     ColorFloat      bgcolor;                                            // Color of the Canvas' clearRectangle
     voidFunction    boundKeys    [(GLFW_KEY_LAST+1)*2];                 // Array of function objects for key binding
+    std::condition_variable bufferDrained;                              // Signals drawing threads that the render buffer has been emptied
     std::mutex      bufferMutex;                                        // Mutex for locking the render buffer so that only one thread can read/write at a time
     unsigned        bufferSize;                                         // Size of the screen buffer
+    bool            dispatchOnThread;                                   // Whether bound functions are called from inputThread
     Timer*          drawTimer;                                          // Timer to regulate drawing frequency
+    unsigned long   droppedPoints;                                      // Number of points overwritten before they were drawn
+    unsigned long   droppedShapes;                                      // Number of shapes discarded before they were drawn
     GLuint          frameBuffer;                                        // Target buffer for rendering to renderedTexture
+    timepoint_d     createdAt;                                          // When the Canvas was constructed
     int             frameCounter;                                       // Counter for the number of frames that have elapsed in the current session (for animations)
+    unsigned long   framesRendered;                                     // Number of the last frame copied into screenBuffer
+    unsigned long   framesStarted;                                      // Number of the last frame that took its shapes from myBuffer
+    FrameBarrier    frameBarrier;                                       // Keeps frames from being drawn while computational threads pause drawing
     bool            hasBackbuffer;                                      // Whether or not the hardware supports double-buffering
     bool            hasEXTFramebuffer;                                  // Whether or not the hard supports EXT FBOs
     bool            hasStereo;                                          // Whether or not the hardware supports stereoscopic rendering
+    RenderHub*      hub;                                                // RenderHub rendering the Canvas (or nullptr if it renders itself)
+    InputQueue      inputEvents;                                        // Input events waiting to be handled by the application
+    std::mutex      inputMutex;                                         // Mutex for putting inputThread to sleep
+    std::condition_variable inputReady;                                 // Wakes inputThread when there are events to dispatch
+    std::atomic<bool> inputSleeping;                                    // Whether inputThread may be waiting on inputReady
+    bool            inputStopping;                                      // Whether inputThread should stop
+    std::thread     inputThread;                                        // Thread that calls the functions bound to input events
     bool            isFinished;                                         // If the rendering is done, which will signal the window to close
     bool            keyDown;                                            // If a key is being pressed. Prevents an action from happening twice
-    TextureHandler  loader;                                             // The ImageLoader that holds all our already loaded textures
-    bool            loopAround;                                         // Whether our point buffer has looped back to the beginning this
+    std::shared_ptr<TextureHandler> loader;                             // The ImageLoader that holds all our already loaded textures
+    bool            loopAround;                                         // Whether our point buffer has looped back to the beginning this frame
+    unsigned        maxBufferSize;                                      // Number of shapes / points the buffers may grow to hold
+    bool            nothingDrawn;                                       // Whether nothing new has been drawn since the last frame
     int             monitorX, monitorY;                                 // Monitor position for upper left corner
     double          mouseX, mouseY;                                     // Location of the mouse once HandleIO() has been called
+    doubleFunction  mouseMoveFunction;                                  // Single function object for moving the mouse
     Array<Shape*> * myBuffer;                                           // Our buffer of shapes that the can be pushed to, and will later be flushed to the shapes array
     Array<Shape*> * myShapes;                                           // Our buffer of shapes to draw
+    OverflowPolicy  overflowPolicy;                                     // What to do when more is drawn in a frame than the buffers can hold
+    bool            packedPoints;                                       // Whether the point buffer holds PackedVertex or float vertices
+    std::condition_variable pointArrayDrained;                          // Signals drawing threads that the allPoints array has been emptied
     std::mutex      pointArrayMutex;                                    // Mutex for the allPoints array
-    unsigned int    pointBufferPosition, pointLastPosition;             // Holds the position of the allPoints array
-	bool            readyToDraw;                                        // Whether a Canvas is ready to start drawing
+    unsigned int    pointBufferPosition;                                // Holds the position of the allPoints array
+    unsigned int    pointCapacity, drawPointCapacity;                   // Number of points the allPoints arrays can currently hold
+    std::atomic<bool> readyToDraw;                                      // Whether a Canvas is ready to start drawing
     int             realFPS;                                            // Actual FPS of drawing
     GLuint          renderedTexture;                                    // Texture to which we render to every frame
   #ifdef __APPLE__
@@ -94,17 +142,21 @@ private:
   #else
     std::thread   renderThread;                                         // Thread dedicated to rendering the Canvas
   #endif
+    std::thread::id renderThreadId;                                     // ID of the thread rendering the Canvas
+    int             scaling;                                            // Ratio of framebuffer pixels to window pixels
     uint8_t*        screenBuffer;                                       // Array that is a copy of the screen
     doubleFunction  scrollFunction;                                     // Single function object for scrolling
     GLtexture       shaderFragment,                                     // Address of the fragment shader
                     shaderProgram,                                      // Addres of the shader program to send to the GPU
                     shaderVertex;                                       // Address of the vertex shader
     std::mutex      shapesMutex;                                        // Mutex for locking the render array so that only one thread can read/write at a time
+    bool            sharedShaders;                                      // Whether the shader programs belong to a RenderHub
+    bool            sharesContext;                                      // Whether the window shares its GL objects with sharedWindow
     bool            showFPS;                                            // Flag to show DEBUGGING FPS
     bool            started;                                            // Whether our canvas is running and the frame counter is counting
-    std::mutex      syncMutex;                                          // Mutex for syncing the rendering thread with a computational thread
-    int             syncMutexLocked;                                    // Whether the syncMutex is currently locked
-	int             syncMutexOwner;                                     // Thread ID of the owner of the syncMutex
+    std::condition_variable stateChanged;                               // Signals waiting threads that the Canvas is ready, rendered a frame, or finished
+    std::mutex      stateMutex;                                         // Mutex for waiting on the state of the Canvas
+    std::atomic<double> timeToFirstFrame;                               // Seconds from construction until the first frame was shown (or 0)
     GLtexture       textureShaderFragment,                              // Address of the textured fragment shader
                     textureShaderProgram,                               // Addres of the textured shader program to send to the GPU
                     textureShaderVertex;                                // Address of the textured vertex shader
@@ -116,7 +168,9 @@ private:
                     uniProj;                                            // Projection of the camera
     GLtexture       vertexArray,                                        // Address of GL's array buffer object
                     vertexBuffer;                                       // Address of GL's vertex buffer object
-    float*          vertexData;                                         // The allPoints array
+    uint8_t*        vertexData;                                         // The allPoints array
+    uint8_t*        drawVertexData;                                     // The allPoints array being drawn by the rendering thread
+    unsigned        vertexStride;                                       // Size in bytes of one vertex in the allPoints array
     GLFWwindow*     window;                                             // GLFW window that we will draw to
     bool            windowClosed;                                       // Whether we've closed the Canvas' window or not
     std::mutex      windowMutex;                                        // (OS X) Mutex for handling window contexts
@@ -124,18 +178,49 @@ private:
     std::string     winTitle;                                           // Title of the window
     int             winWidth;                                           // Width of the Canvas' window
     int             winWidthPadded;                                     // Window width padded to a multiple of 4 (necessary for taking screenshots)
+    GLtexture       worldBuffer;                                        // GL buffer holding the retained world-coordinate vertices
+    unsigned        worldBufferCapacity;                                // Number of vertices worldBuffer has room for
+    bool            worldChanged;                                       // Whether the retained geometry must be redrawn from scratch
+    std::mutex      worldMutex;                                         // Mutex for the retained geometry and its transform
+    std::vector<WorldRun> worldRuns;                                    // Retained draw calls, in the order they were made
+    unsigned        worldRunsDrawn;                                     // Number of worldRuns already drawn to the framebuffer
+    float           worldTransform[4];                                  // Scale and offset from world coordinates to pixels
+    unsigned        worldUploaded;                                      // Number of worldVertices already copied to worldBuffer
+    std::vector<float> worldVertices;                                   // Retained vertices (x, y, r, g, b, a) in world coordinates
 
     static int          drawBuffer;                                     // Buffer to use for drawing (set to GL_LEFT or GL_RIGHT)
     static bool         glfwIsReady;                                    // Whether or not we have info about our monitor
     static std::mutex   glfwMutex;                                      // Keeps GLFW createWindow from getting called at the same time in multiple threads
     static displayInfo  monInfo;                                        // Info about our display
-    static unsigned     openCanvases;                                   // Total number of open Canvases
-
+    static std::mutex   pollMutex;                                      // Keeps more than one thread from dispatching GLFW callbacks at once
+    static unsigned     openCanvases;                                   // Total number of open Canvases (guarded by glfwMutex)
+    static GLFWwindow*  sharedWindow;                                   // Hidden window that later windows share GL objects with
+    static std::weak_ptr<TextureHandler> sharedLoader;                  // TextureHandler used by all Canvases sharing resources
+    static bool         sharingResources;                               // Whether new Canvases use sharedLoader
+
+    friend class RenderHub;
+
+    void         beginDrawing();                                        // Prepares the window for the first frame
+    static void  cursorCallback(GLFWwindow* window, double xpos,
+                   double ypos);                                        // GLFW callback for moving the mouse
+    void         dispatchInputEvent(const InputEvent& event);           // Calls the function bound to an input event
+    void         dispatchLoop();                                        // Loop of inputThread
+    void         pushInputEvent(InputEvent event);                      // Timestamps an input event and queues it
+    static void  startDispatching(Canvas* c);                           // Entry point of inputThread
+    void         stopDispatching();                                     // Stops and joins inputThread
     static void  buttonCallback(GLFWwindow* window, int key,
                    int action, int mods);                               // GLFW callback for mouse buttons
+    static GLtexture createShaderProgram(bool textured, GLtexture& vertex,
+                   GLtexture& fragment);                                // Compiles and links one of our shader programs
+    static void  destroyShaderProgram(GLtexture program, GLtexture vertex,
+                   GLtexture fragment);                                 // Frees a shader program made by createShaderProgram()
     void         draw();                                                // Draw loop for the Canvas
+    void         drawWorld(bool redraw);                                // Draws the retained world-coordinate geometry
+    bool         drawFrame(bool wait = true);                           // Renders a frame (without waiting: false if drawing is paused)
+    void         endDrawing();                                          // Cleans up after the last frame
     static void  errorCallback(int error, const char* string);          // Display where an error is coming from
     void         glDestroy();                                           // Destroys the GL and GLFW things that are specific for this canvas
+    void         growPointBuffer(unsigned limit);                       // Doubles the capacity of the allPoints array (up to limit)
     void         init(int xx,int yy,int ww,int hh,
                    unsigned int b, std::string title,
                    double timerLength);                                 // Method for initializing the canvas
@@ -143,27 +228,45 @@ private:
     void         initGlew();                                            // Initialized the GLEW things specific to the Canvas
     static void  initGlfw();                                            // Initalizes GLFW for all future canvases.
     void         initWindow();                                          // Initalizes the window specific to the Canvas
+    bool         canWaitForDrain();                                     // Whether the calling thread may block until the buffers are drained
     static void  keyCallback(GLFWwindow* window, int key,
                    int scancode, int action, int mods);                 // GLFW callback for keys
+    uint8_t*     nextPoint(std::unique_lock<std::mutex>& lock);         // Claims the next vertex in the allPoints array (lock held)
+    void         pointShaders();                                        // Set up the shader attributes for the point buffer
+    static void  pollEvents();                                          // Polls GLFW for I/O unless another thread already is
+    static void  releaseGlfw();                                         // Terminates GLFW once nothing uses it anymore
+    static GLFWwindow* retainSharedWindow();                            // Creates sharedWindow if needed and keeps GLFW alive
     void         screenShot();                                          // Takes a screenshot
     static void  scrollCallback(GLFWwindow* window, double xpos,
                    double ypos);                                        // GLFW callback for scrolling
     static void  setDrawBuffer(int buffer);                             // Sets the buffer used for drawing
-    void         setupCamera();                                         // Setup the 2D camera for smooth rendering
+    static void  setWindowHints();                                      // Sets the GLFW hints for creating our windows
+    void         setupCamera(float scaleX = 1, float scaleY = 1,
+                   float offsetX = 0, float offsetY = 0);               // Setup the 2D camera for smooth rendering
   #ifdef __APPLE__
     static void* startDrawing(void* cPtr);
   #else
     static void  startDrawing(Canvas *c);                               // Static method that is called by the render thread
   #endif
     void         textureShaders(bool state);                            // Turn textures on or off
+    void         writePoint(uint8_t* vertex, int x, int y,
+                   const ColorFloat& color);                            // Fills in a vertex claimed by nextPoint()
     static bool  testFilledDraw(Canvas& can);                           // Unit test for drawing shapes and determining if fill works
     static bool testLine(Canvas& can);                                  // Unit tester for lines
+    static bool testRaster(Canvas& can);                                // Unit tester for drawing blocks of pixels
     static bool testAccessors(Canvas& can);                             // Unit tester for accessor methods
     static bool testDrawImage(Canvas& can);                             // Unit tester for drawing images (simultaneously a Unit test for Image)
+    static bool testBufferGrowth(Canvas& can);                          // Unit tester for growing the shape and point buffers and their overflow policy
+    static bool testSync(Canvas& can);                                  // Unit tester for waiting on fences
 
 protected:
     bool        atiCard;                                                // Whether the vendor of the graphics card is ATI
     void        drawShape(Shape* s);                                    // Draw a shape type
+    void        addWorldGeometry(GLenum mode, int size, const float x[],
+                  const float y[], ColorFloat color);                   // Retains vertices in world coordinates
+    void        clearWorldGeometry();                                   // Discards all retained geometry
+    void        setWorldTransform(float scaleX, float scaleY,
+                  float offsetX, float offsetY);                        // Sets the world to pixel mapping
 public:
 
     /*!
@@ -218,6 +321,22 @@ public:
      */
     void bindToScroll(std::function<void(double, double)> function);
 
+    /*!
+     * \brief Binds mouse movement to a function.
+     * \details Upon every movement of the mouse over the Canvas, Canvas will call the specified function with the
+     *   new position of the mouse, so that no intermediate positions are missed.
+     *   \param function A function taking x and y parameters to be called when the mouse moves.
+     */
+    void bindToMouseMove(std::function<void(double, double)> function);
+
+    /*!
+     * \brief Calls the functions bound to all input events received so far.
+     * \details Pops every queued input event and calls the function bound to it (see bindToButton(),
+     *   bindToScroll() and bindToMouseMove()) on the calling thread.
+     * \note Only does anything if the dispatch thread has been turned off with setDispatchThread().
+     */
+    void dispatchInputEvents();
+
     /*!
      * \brief Clears the Canvas.
      * \details This function clears the screen to the color specified in setBackgroundColor().
@@ -338,6 +457,20 @@ public:
      */
     virtual void drawProgress(ProgressBar* p);
 
+    /*!
+     * \brief Draws a rectangular block of pixels.
+     * \details This function draws <code>width</code> x <code>height</code> pixels at once, with the given colors,
+     *   taking the lock on the point buffer once rather than once per pixel as drawPoint() does.
+     *   \param x The x position of the block's left edge.
+     *   \param y The y position of the block's top edge.
+     *   \param width The width of the block, in pixels.
+     *   \param height The height of the block, in pixels.
+     *   \param colors The colors of the pixels, one row after another.
+     * \note Like drawPoint(), this uses absolute Canvas coordinates, even on a CartesianCanvas.
+     * \see drawPoint()
+     */
+    virtual void drawRaster(int x, int y, int width, int height, const ColorFloat colors[]);
+
     /*!
      * \brief Draws a rectangle.
      * \details This function draws a Rectangle with the given coordinates, dimensions, and color.
@@ -404,6 +537,15 @@ public:
      */
     virtual void drawTriangleStrip(int size, int xverts[], int yverts[], ColorFloat color[], bool filled = true);
 
+    /*!
+     * \brief Gets a fence for everything drawn so far.
+     * \details Everything drawn (by any thread) before this function is called will have been rendered,
+     *   and will be readable with getPixel() and getPoint(), once the returned fence has been reached.
+     * \return A fence to pass to sync().
+     * \see sync()
+     */
+    unsigned long flush();
+
     /*!
      * \brief Accessor for the current background color.
      * \return The color that the Canvas clears to when clear() is called.
@@ -429,6 +571,31 @@ public:
      */
     int getFrameNumber();
 
+    /*!
+     * \brief Accessor for the number of points dropped so far.
+     * \details Under the TSGL_DROP_OLDEST overflow policy, a point is dropped when it is overwritten by
+     *   a newer one before it could be rendered.
+     * \return The number of points drawn to the Canvas that never made it onto the screen.
+     * \see setOverflowPolicy()
+     */
+    unsigned long getDroppedPoints();
+
+    /*!
+     * \brief Accessor for the number of shapes dropped so far.
+     * \details Under the TSGL_DROP_OLDEST overflow policy, a shape is dropped when it is discarded to make
+     *   room for a newer one before it could be rendered.
+     * \return The number of shapes drawn to the Canvas that never made it onto the screen.
+     * \see setOverflowPolicy()
+     */
+    unsigned long getDroppedShapes();
+
+    /*!
+     * \brief Accessor for the number of input events dropped.
+     * \details Input events are dropped if the application handles them too slowly and too many pile up.
+     * \return The number of input events the Canvas has dropped.
+     */
+    unsigned long getDroppedInputEvents();
+
     /*!
      * \brief Accessor for the current FPS.
      * \return The average number of frames being rendered per second.
@@ -441,6 +608,15 @@ public:
      */
     bool isOpen();
 
+    /*!
+     * \brief Accessor for the memory used by the Canvas' buffers.
+     * \details The shape and point buffers of a Canvas start small and grow as needed (up to the
+     *   limit set by setMaxBufferSize()), so this value changes as more is drawn per frame.
+     * \return The number of bytes currently allocated for the Canvas' screen, shape, and point buffers, and for
+     *   any geometry retained in world coordinates.
+     */
+    size_t getMemoryUsage();
+
     /*!
      * \brief Accessor for the mouse's x-position.
      * \return The x coordinates of the mouse on the Canvas.
@@ -498,6 +674,15 @@ public:
      */
     uint8_t* getScreenBuffer();
 
+    /*!
+     * \brief Accessor for how long the Canvas took to start up.
+     * \details Measures the time from the construction of the Canvas until its first frame was shown
+     *   on the screen, which includes creating the window, setting up GL, and the wait until start().
+     * \return The time to the first frame in seconds, or 0 if the first frame has not been shown yet.
+     * \note Safe to call from any thread while the Canvas is rendering.
+     */
+    double getTimeToFirstFrame();
+
     /*!
      * \brief Accessor for the time since the Canvas was initialized.
      * \return The elapsed time in microseconds since the Canvas has started drawing.
@@ -542,14 +727,28 @@ public:
      */
     void handleIO();
 
+    /*!
+     * \brief Gets the oldest input event that has not been handled yet.
+     * \details Every key press, mouse click, mouse movement and scroll is queued (with a timestamp) as it is
+     *   received, without blocking the rendering thread. This function takes them off of the queue one by one.
+     *   \param event An InputEvent to copy the event into.
+     * \return True if there was an event, false if there are no events waiting (or the dispatch thread is on).
+     * \note Only works if the dispatch thread has been turned off with setDispatchThread(); events are not
+     *   dispatched to bound functions when they are taken off the queue with this function.
+     * \warning <b>Only one thread may take events from a Canvas.</b>
+     */
+    bool pollInputEvent(InputEvent& event);
+
     /*!
      * \brief Pauses the rendering thread of the Canvas
      * \details This function forces the calling thread to wait until the Canvas finishes its draw cycle,
      *   them prevents the Canvas from rendering further updates until resumeDrawing is called.
-     * \note This method may be called from any number of threads, so long as a matching number of calls
-     *   to resumeDrawing() are made.
-     * \warning <b>This function makes use of a mutex lock. Do not call this without later calling
-     *   resumeDrawing().</b>
+     * \note This method may be called from any number of threads of any kind, so long as each of them
+     *   later calls resumeDrawing(). The Canvas renders its next frame as soon as the last of them has.
+     * \note Once the Canvas is waiting to render, further calls wait until it has rendered its frame.
+     * \note Calls may be nested: a thread that has already paused the Canvas returns at once, and the Canvas
+     *   stays paused until the thread has called resumeDrawing() as many times as it called this.
+     * \warning <b>Do not call this without later calling resumeDrawing() from the same thread.</b>
      * \see resumeDrawing()
      */
     void pauseDrawing();
@@ -575,10 +774,8 @@ public:
      * \brief Resumes the rendering thread of the Canvas
      * \details This function should be called after pauseDrawing to let the Canvas' rendering thread
      *   know that it may resume rendering.
-     * \note This method may be called from any number of threads, so long as a matching number of calls
-     *   to pauseDrawing() are made.
-     * \warning <b>This function makes use of a mutex lock. Do not call this without having
-     *   first called pauseDrawing().</b>
+     * \note Returns immediately; the Canvas renders once every thread that paused it has resumed it.
+     * \warning <b>Do not call this without having first called pauseDrawing().</b>
      * \see pauseDrawing()
      */
     void resumeDrawing();
@@ -661,15 +858,76 @@ public:
      */
     void setBackgroundColor(ColorFloat color);
 
+    /*!
+     * \brief Mutator for who handles input events.
+     * \details By default, the Canvas starts a thread of its own that calls the functions bound to input
+     *   events, so that slow functions never hold up rendering. Turning the dispatch thread off instead
+     *   leaves the events in a queue for the application to take with pollInputEvent() or dispatchInputEvents().
+     *   \param on Whether the Canvas should dispatch input events from a thread of its own.
+     * \note This function has no effect once the Canvas has been started.
+     */
+    void setDispatchThread(bool on);
+
     /*!
      * \brief Mutator for the currently loaded font.
      * \details This function sets the font with the specified filename into memory.
      *   Subsequent calls to drawText() will use this font to print.
      *   \param filename The filename of the font to load.
      * \note Supports all font types that FreeType supports.
+     * \note If the Canvas shares its resources (see setSharedResources()), the font is set for
+     *   every Canvas sharing them.
      */
     void setFont(std::string filename);
 
+    /*!
+     * \brief Mutator for the maximum size of the Canvas' buffers.
+     * \details The shape and point buffers double in size whenever they fill up within a single
+     *   frame, until they hold <code>size</code> items. What happens beyond that is determined by
+     *   the Canvas' overflow policy.
+     *   \param size The maximum number of shapes / points to buffer per frame (by default, twice
+     *   the number of pixels on the Canvas).
+     * \see setOverflowPolicy()
+     * \note Buffers that have already grown larger than <code>size</code> do not shrink.
+     */
+    void setMaxBufferSize(unsigned size);
+
+    /*!
+     * \brief Turns sharing of fonts and textures between Canvases on or off.
+     * \details Normally, every Canvas loads, rasterizes and uploads its own copy of each font, glyph and image
+     *   it draws. While sharing is on, the windows of newly created Canvases share their GL objects, and the
+     *   Canvases share a single set of these resources, which is freed once the last of them is destroyed.
+     *   \param share Whether Canvases created from now on should share their resources.
+     * \note Only affects Canvases created after the call; Canvases that already exist keep their own resources.
+     * \note Canvases sharing resources also share their font (see setFont()).
+     */
+    static void setSharedResources(bool share);
+
+    /*!
+     * \brief Mutator for the overflow policy of the Canvas' buffers.
+     * \details This function determines what happens when more shapes or points are drawn in a single
+     *   frame than fit in the buffers (see setMaxBufferSize()):
+     *   - TSGL_DROP_OLDEST discards the oldest shapes / points queued for the frame (the default).
+     *     Dropped items are counted by getDroppedShapes() and getDroppedPoints().
+     *   - TSGL_BLOCK makes the drawing thread wait until the rendering thread has drained the buffers.
+     *   - TSGL_GROW keeps growing the buffers past their maximum size.
+     *   .
+     *   \param policy The new overflow policy.
+     * \note Threads can't wait for the buffers to drain while drawing is paused, from the rendering thread
+     *   itself, or from the dispatch thread (i.e., in a function bound to a key or button), which must never
+     *   block on the rendering thread. TSGL_BLOCK grows the buffers instead in those cases.
+     */
+    void setOverflowPolicy(OverflowPolicy policy);
+
+    /*!
+     * \brief Mutator for the vertex format of the point buffer.
+     * \details By default, points drawn with drawPoint() are stored as PackedVertex (8 bytes per point).
+     *   This function switches the point buffer between the packed format and TSGL's float vertex
+     *   format (24 bytes per point), mostly for comparing the two.
+     *   \param packed Whether to store points as PackedVertex (true) or as floats (false).
+     * \note This function has no effect once the Canvas has been started.
+     */
+    void setPackedPoints(bool packed);
+
     /*!
      * \brief Mutator for showing the FPS.
      *   \param b Whether to print the FPS to stdout every draw cycle (for debugging purposes).
@@ -715,6 +973,30 @@ public:
      */
     void stopRecording();
 
+    /*!
+     * \brief Waits until a fence has been reached.
+     * \details Blocks the calling thread until the rendering thread has drawn everything that had been drawn
+     *   when <code>fence</code> was obtained from flush(), and has copied the result to the screen buffer.
+     *   Waiting threads are woken as soon as the frame is done, so no time is wasted sleeping.
+     *   \param fence A fence returned by flush().
+     * \return True if the fence was reached, false if the Canvas closed (or had not started) first.
+     * \warning <b>Do not call this between pauseDrawing() and resumeDrawing(), where the Canvas can't render
+     *   the frame you're waiting for, or from the rendering thread. Functions bound to keys and buttons run on
+     *   the dispatch thread (see setDispatchThread()) and must not call this either: no further input would be
+     *   handled while they wait, and the Canvas waits for the dispatch thread when it closes.</b>
+     * \see flush()
+     */
+    bool sync(unsigned long fence);
+
+    /*!
+     * \brief Waits until everything drawn so far has been rendered.
+     * \details Equivalent to <code>sync(flush())</code>. Call this before reading pixels back from the
+     *   Canvas to make sure they include everything you have drawn.
+     * \return True if everything was rendered, false if the Canvas closed (or had not started) first.
+     * \see flush(), getPixel(), getPoint()
+     */
+    bool sync();
+
     /*!
      * \brief Takes a screenshot.
      * \details This function saves a screenshot of the current Canvas to the working directory.
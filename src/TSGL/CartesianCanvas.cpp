@@ -1,45 +1,65 @@
 #include "CartesianCanvas.h"
+#include "Expression.h"  // For the unit tests' expression Function
 
 namespace tsgl {
 
-CartesianCanvas::CartesianCanvas(double timerLength)
+template<typename T>
+const int CartesianCanvasT<T>::FUNCTION_CHUNK;
+template<typename T>
+const int CartesianCanvasT<T>::SAMPLE_SPACING;
+template<typename T>
+const int CartesianCanvasT<T>::MAX_SUBDIVISION;
+
+template<typename T>
+CartesianCanvasT<T>::CartesianCanvasT(double timerLength)
     : Canvas(timerLength) {
+    worldOriginX = worldOriginY = 0;
     recomputeDimensions(-400, -300, 400, 300);
 }
 
-CartesianCanvas::CartesianCanvas(int x, int y, int width, int height, Decimal xMin, Decimal yMin, Decimal xMax,
-                                 Decimal yMax, std::string t, double timerLength)
+template<typename T>
+CartesianCanvasT<T>::CartesianCanvasT(int x, int y, int width, int height, T xMin, T yMin, T xMax,
+                                     T yMax, std::string t, double timerLength)
     : Canvas(x, y, width, height, t, timerLength) {
+    worldOriginX = (xMin + xMax) / 2;
+    worldOriginY = (yMin + yMax) / 2;
     recomputeDimensions(xMin, yMin, xMax, yMax);
 }
 
-void CartesianCanvas::drawAxes(Decimal originX, Decimal originY, Decimal spacingX, Decimal spacingY) {
+template<typename T>
+void CartesianCanvasT<T>::clearPlot() {
+    clearWorldGeometry();
+}
+
+template<typename T>
+void CartesianCanvasT<T>::drawAxes(T originX, T originY, T spacingX, T spacingY) {
     drawLine(maxX, originY, minX, originY);  // Make the two axes
     drawLine(originX, maxY, originX, minY);
 
     if (spacingX != 0.0) {
         if (spacingX < 0.0) spacingX = -spacingX;
 
-        for (Decimal x_ = originX + spacingX; x_ < maxX; x_ += spacingX) {
+        for (T x_ = originX + spacingX; x_ < maxX; x_ += spacingX) {
             drawLine(x_, originY + 8 * pixelHeight, x_, originY - 8 * pixelHeight);
         }
-        for (Decimal x_ = originX - spacingX; x_ > minX; x_ -= spacingX) {
+        for (T x_ = originX - spacingX; x_ > minX; x_ -= spacingX) {
             drawLine(x_, originY + 8 * pixelHeight, x_, originY - 8 * pixelHeight);
         }
     }
     if (spacingY != 0.0) {
         if (spacingY < 0.0) spacingY = -spacingY;
 
-        for (Decimal y_ = originY + spacingY; y_ < maxY; y_ += spacingY) {
+        for (T y_ = originY + spacingY; y_ < maxY; y_ += spacingY) {
             drawLine(originX + 8 * pixelWidth, y_, originX - 8 * pixelWidth, y_);
         }
-        for (Decimal y_ = originY - spacingY; y_ > minY; y_ -= spacingY) {
+        for (T y_ = originY - spacingY; y_ > minY; y_ -= spacingY) {
             drawLine(originX + 8 * pixelWidth, y_, originX - 8 * pixelWidth, y_);
         }
     }
 }
 
-void CartesianCanvas::drawCircle(Decimal x, Decimal y, Decimal radius, int sides, ColorFloat color, bool filled) {
+template<typename T>
+void CartesianCanvasT<T>::drawCircle(T x, T y, T radius, int sides, ColorFloat color, bool filled) {
     int actualX, actualY, actualR;
     getScreenCoordinates(x, y, actualX, actualY);
     getScreenCoordinates(x+radius,y,actualR,actualY);
@@ -47,7 +67,8 @@ void CartesianCanvas::drawCircle(Decimal x, Decimal y, Decimal radius, int sides
     Canvas::drawCircle(actualX, actualY, actualR, sides, color, filled);
 }
 
-void CartesianCanvas::drawConcavePolygon(int size, Decimal xverts[], Decimal yverts[], ColorFloat color[], bool filled) {
+template<typename T>
+void CartesianCanvasT<T>::drawConcavePolygon(int size, T xverts[], T yverts[], ColorFloat color[], bool filled) {
     int* int_x = new int[size];
     int* int_y = new int[size];
 
@@ -60,7 +81,8 @@ void CartesianCanvas::drawConcavePolygon(int size, Decimal xverts[], Decimal yve
     delete int_y;
 }
 
-void CartesianCanvas::drawConvexPolygon(int size, Decimal xverts[], Decimal yverts[], ColorFloat color[], bool filled) {
+template<typename T>
+void CartesianCanvasT<T>::drawConvexPolygon(int size, T xverts[], T yverts[], ColorFloat color[], bool filled) {
     int* int_x = new int[size];
     int* int_y = new int[size];
 
@@ -73,40 +95,29 @@ void CartesianCanvas::drawConvexPolygon(int size, Decimal xverts[], Decimal yver
     delete int_y;
 }
 
-void CartesianCanvas::drawFunction(const Function &function, float sleepTime, ColorFloat color) {
-  if (sleepTime > 0.0f) {
-    bool first = true;
-    Decimal lastX, lastY, y;
-    for (Decimal x = minX; x < maxX; x += pixelWidth) {
-        if (!isOpen()) break;
-        y = function.valueAt(x);
-        if (!first)
-          drawLine(lastX,lastY,x,y,color);
-        first = false;
-        lastX = x;
-        lastY = y;
-        if (y > minY && y < maxY)  //Don't waste time if it's offscreen
-          sleepFor(sleepTime);
-    }
-  } else {
+template<typename T>
+void CartesianCanvasT<T>::drawFunction(const Function &function, float sleepTime, ColorFloat color) {
+  drawPartialFunction(function,minX,maxX,sleepTime,color);
+}
+
+template<typename T>
+void CartesianCanvasT<T>::drawFunction(functionPointer &function, float sleepTime, ColorFloat color) {
+  drawPartialFunction(function,minX,maxX,sleepTime,color);
+}
+
+template<typename T>
+void CartesianCanvasT<T>::drawValues(int size, const Decimal xs[], const Decimal ys[], ColorFloat color) {
     int screenX = 0, screenY = 0;
-    int size = (maxX - minX) / pixelWidth;
     Polyline *p = new Polyline(size);
-    Decimal x = minX;
     for (int i = 0; i < size; ++i) {
-        getScreenCoordinates(x, function.valueAt(x), screenX, screenY);
+        getScreenCoordinates(xs[i], ys[i], screenX, screenY);
         p->addNextVertex(screenX, screenY, color);
-        x += pixelWidth;
     }
     drawShape(p);
-  }
-}
-
-void CartesianCanvas::drawFunction(functionPointer &function, float sleepTime, ColorFloat color) {
-  drawPartialFunction(function,minX,maxX,sleepTime,color);
 }
 
-void CartesianCanvas::drawImage(std::string function, Decimal x, Decimal y, Decimal w, Decimal h, float a) {
+template<typename T>
+void CartesianCanvasT<T>::drawImage(std::string function, T x, T y, T w, T h, float a) {
     int actualX1, actualY1, actualX2, actualY2;
     getScreenCoordinates(x, y, actualX1, actualY1);
     getScreenCoordinates(x + w, y - h, actualX2, actualY2);
@@ -114,7 +125,8 @@ void CartesianCanvas::drawImage(std::string function, Decimal x, Decimal y, Deci
     Canvas::drawImage(function, actualX1, actualY1, actualX2 - actualX1, actualY2 - actualY1, a);
 }
 
-void CartesianCanvas::drawLine(Decimal x1, Decimal y1, Decimal x2, Decimal y2, ColorFloat color) {
+template<typename T>
+void CartesianCanvasT<T>::drawLine(T x1, T y1, T x2, T y2, ColorFloat color) {
     int actualX1, actualY1, actualX2, actualY2;
     getScreenCoordinates(x1, y1, actualX1, actualY1);
     getScreenCoordinates(x2, y2, actualX2, actualY2);
@@ -122,13 +134,20 @@ void CartesianCanvas::drawLine(Decimal x1, Decimal y1, Decimal x2, Decimal y2, C
     Canvas::drawLine(actualX1, actualY1, actualX2, actualY2, color);
 }
 
-void CartesianCanvas::drawPartialFunction(functionPointer &function, Decimal min, Decimal max, float sleepTime, ColorFloat color) {
+template<typename T>
+void CartesianCanvasT<T>::drawPartialFunction(functionPointer &function, T min, T max, float sleepTime, ColorFloat color) {
+  PointerFunction f(function);
+  drawPartialFunction(f,min,max,sleepTime,color);
+}
+
+template<typename T>
+void CartesianCanvasT<T>::drawPartialFunction(const Function &function, T min, T max, float sleepTime, ColorFloat color) {
   if (sleepTime > 0.0f) {
     bool first = true;
-    Decimal lastX, lastY, y;
-    for (Decimal x = min; x < max; x += pixelWidth) {
+    T lastX, lastY, y;
+    for (T x = min; x < max; x += pixelWidth) {
         if (!isOpen()) break;
-        y = (function)(x);
+        y = function.valueAt(x);
         if (!first)
           drawLine(lastX,lastY,x,y,color);
         first = false;
@@ -138,24 +157,140 @@ void CartesianCanvas::drawPartialFunction(functionPointer &function, Decimal min
           sleepFor(sleepTime);
     }
   } else {
-    int screenX = 0, screenY = 0;
-    int size = 1 + ceil((max - min) / pixelWidth);
-    Polyline *p = new Polyline(size);
-    Decimal x = min;
-    for (int i = 0; i < size; ++i) {
-        getScreenCoordinates(x, (function)(x), screenX, screenY);
-        p->addNextVertex(screenX, screenY, color);
-        x += pixelWidth;
+    std::vector<Decimal> xs, ys;
+    std::vector<int> runs;
+    sampleFunction(function, min, max, xs, ys, runs);
+    for (unsigned i = 0; i < runs.size(); ++i) {
+      int last = (i + 1 < runs.size()) ? runs[i + 1] : xs.size();
+      drawValues(last - runs[i], &xs[runs[i]], &ys[runs[i]], color);
     }
-    drawShape(p);
   }
 }
 
-void CartesianCanvas::drawPixel(Decimal row, Decimal col, ColorFloat color) {
+template<typename T>
+void CartesianCanvasT<T>::evaluate(const Function& function, const Decimal xs[], Decimal ys[], int size) {
+    #pragma omp parallel for schedule(dynamic) if (size > 4 * FUNCTION_CHUNK)
+    for (int first = 0; first < size; first += FUNCTION_CHUNK)
+      function.valuesAt(xs + first, ys + first, std::min(FUNCTION_CHUNK, size - first));
+}
+
+/*
+ * Samples function between min and max, refining where a straight segment between two samples would be more
+ *  than half a pixel from the curve at its midpoint. Every segment of a level is checked with one batched call
+ *  to evaluate(), so the work stays parallel. The first samples lie on a lattice of multiples of the largest power
+ *  of two no wider than SAMPLE_SPACING pixels, so every sample (bar those next to min and max) is a multiple of a
+ *  power of two. Views that overlap after a pan or zoom therefore ask for many of the same x values, which lets a
+ *  CachedFunction reuse them.
+ * Segments that are entirely above or below the window, or entirely undefined, are not refined. A segment whose
+ *  rise keeps pace with its parent's as it is halved down to MAX_SUBDIVISION is a jump, and is left undrawn.
+ * The resulting vertices are stored in xs and ys, in order; runs holds the index of the first vertex of each run
+ *  of connected segments. Returns the number of times function was evaluated.
+ */
+template<typename T>
+int CartesianCanvasT<T>::sampleFunction(const Function& function, T min, T max, std::vector<Decimal>& xs,
+                                        std::vector<Decimal>& ys, std::vector<int>& runs) {
+    struct Segment {
+      Decimal x0, y0, x1, y1;   // Endpoints
+      Decimal rise;             // |y1 - y0| of the segment this was split from
+      int steady;               // Number of splits in a row in which the rise barely shrank
+      bool drawn;               // Whether to draw this segment once it has been accepted
+      bool operator<(const Segment& s) const { return x0 < s.x0; }
+    };
+    int exponent;
+    frexp(SAMPLE_SPACING * (Decimal)pixelWidth, &exponent);
+    const Decimal STEP = ldexp((Decimal)1, exponent - 1);  // Largest power of two within SAMPLE_SPACING pixels
+    const Decimal MIN_WIDTH = pixelWidth / (Decimal)MAX_SUBDIVISION;
+    const Decimal STEADY_RATIO = 0.9;  // A continuous curve's rise roughly halves with each split
+    const int JUMP_SPLITS = 3;         // Splits in a row without shrinking that make a jump
+    xs.clear(); ys.clear(); runs.clear();
+    if (!(max > min))
+      return 0;
+
+    //Sample the lattice
+    std::vector<Decimal> px(1, min), py;
+    for (long long k = floor(min / STEP) + 1; k * STEP < max; ++k)
+      px.push_back(k * STEP);
+    px.push_back(max);
+    py.resize(px.size());
+    evaluate(function, &px[0], &py[0], px.size());
+    int evaluations = px.size();
+
+    std::vector<Segment> pending, next, accepted;
+    for (unsigned i = 0; i + 1 < px.size(); ++i) {
+      Segment s = { px[i], py[i], px[i + 1], py[i + 1], INFINITY, 0, true };
+      pending.push_back(s);
+    }
+
+    //Refine one level at a time
+    while (!pending.empty()) {
+      px.resize(pending.size());
+      py.resize(pending.size());
+      for (unsigned i = 0; i < pending.size(); ++i)
+        px[i] = (pending[i].x0 + pending[i].x1) / 2;
+      evaluate(function, &px[0], &py[0], px.size());
+      evaluations += px.size();
+      next.clear();
+      for (unsigned i = 0; i < pending.size(); ++i) {
+        Segment& s = pending[i];
+        Decimal xm = px[i], ym = py[i];
+        bool defined0 = std::isfinite(s.y0), definedM = std::isfinite(ym), defined1 = std::isfinite(s.y1);
+        bool canSplit = (s.x1 - s.x0) > 2 * MIN_WIDTH;
+        bool done;
+        if (!defined0 && !definedM && !defined1) {
+          s.drawn = false;
+          done = true;
+        } else if (!defined0 || !definedM || !defined1) {
+          s.drawn = false;             // Narrow down where the function becomes undefined
+          done = !canSplit;
+        } else if ((s.y0 > maxY && ym > maxY && s.y1 > maxY) || (s.y0 < minY && ym < minY && s.y1 < minY)) {
+          done = true;                 // Off the screen
+        } else if (std::abs(ym - (s.y0 + s.y1) / 2) <= pixelHeight / 2) {
+          done = true;                 // Flat enough
+        } else {
+          done = !canSplit;
+          s.drawn = s.steady < JUMP_SPLITS;
+        }
+        if (done) {
+          accepted.push_back(s);
+          continue;
+        }
+        Segment left = { s.x0, s.y0, xm, ym, std::abs(s.y1 - s.y0), 0, true };
+        Segment right = { xm, ym, s.x1, s.y1, left.rise, 0, true };
+        Segment* halves[2] = { &left, &right };
+        for (int h = 0; h < 2; ++h) {
+          Decimal rise = std::abs(halves[h]->y1 - halves[h]->y0);
+          if (rise > pixelHeight && rise > STEADY_RATIO * halves[h]->rise)
+            halves[h]->steady = s.steady + 1;
+          next.push_back(*halves[h]);
+        }
+      }
+      pending.swap(next);
+    }
+
+    //Join the accepted segments into runs of vertices
+    std::sort(accepted.begin(), accepted.end());
+    for (unsigned i = 0; i < accepted.size(); ++i) {
+      const Segment& s = accepted[i];
+      if (!s.drawn)
+        continue;
+      if (i == 0 || !accepted[i - 1].drawn) {
+        runs.push_back(xs.size());
+        xs.push_back(s.x0);
+        ys.push_back(s.y0);
+      }
+      xs.push_back(s.x1);
+      ys.push_back(s.y1);
+    }
+    return evaluations;
+}
+
+template<typename T>
+void CartesianCanvasT<T>::drawPixel(T row, T col, ColorFloat color) {
     drawPoint(col, row, color);
 }
 
-void CartesianCanvas::drawPoint(Decimal x, Decimal y, ColorFloat color) {
+template<typename T>
+void CartesianCanvasT<T>::drawPoint(T x, T y, ColorFloat color) {
     int actualX, actualY;
     getScreenCoordinates(x, y, actualX, actualY);
 
@@ -165,28 +300,45 @@ void CartesianCanvas::drawPoint(Decimal x, Decimal y, ColorFloat color) {
       Canvas::drawPoint(actualX, actualY, color);
 }
 
-void CartesianCanvas::drawRectangle(Decimal x1, Decimal y1, Decimal x2, Decimal y2, ColorFloat color, bool filled) {
+template<typename T>
+void CartesianCanvasT<T>::drawPoints(int size, const T x[], const T y[], ColorFloat color) {
+    const int BATCH = 1024;  // Small enough to stay on the stack and in cache
+    int screenX[BATCH], screenY[BATCH];
+    const int atiOffset = atiCard ? 1 : 0;
+    for (int first = 0; first < size; first += BATCH) {
+      int n = std::min(BATCH, size - first);
+      getScreenCoordinates(n, x + first, y + first, screenX, screenY);
+      for (int i = 0; i < n; ++i)
+        Canvas::drawPoint(screenX[i], screenY[i] - atiOffset, color);
+    }
+}
+
+template<typename T>
+void CartesianCanvasT<T>::drawRectangle(T x1, T y1, T x2, T y2, ColorFloat color, bool filled) {
     int actualX1, actualY1, actualX2, actualY2;
     getScreenCoordinates(x1, y1, actualX1, actualY1);
     getScreenCoordinates(x2, y2, actualX2, actualY2);  //Change y - h to y + h
     Canvas::drawRectangle(actualX1, actualY1, actualX2, actualY2, color, filled);
 }
 
-void CartesianCanvas::drawText(std::string text, Decimal x, Decimal y, unsigned size, ColorFloat color) {
+template<typename T>
+void CartesianCanvasT<T>::drawText(std::string text, T x, T y, unsigned size, ColorFloat color) {
     int actualX, actualY;
     getScreenCoordinates(x, y, actualX, actualY);
 
     Canvas::drawText(text, actualX, actualY, size, color);
 }
 
-void CartesianCanvas::drawText(std::wstring text, Decimal x, Decimal y, unsigned size, ColorFloat color) {
+template<typename T>
+void CartesianCanvasT<T>::drawText(std::wstring text, T x, T y, unsigned size, ColorFloat color) {
     int actualX, actualY;
     getScreenCoordinates(x, y, actualX, actualY);
 
     Canvas::drawText(text, actualX, actualY, size, color);
 }
 
-void CartesianCanvas::drawTriangle(Decimal x1, Decimal y1, Decimal x2, Decimal y2, Decimal x3, Decimal y3, ColorFloat color, bool filled) {
+template<typename T>
+void CartesianCanvasT<T>::drawTriangle(T x1, T y1, T x2, T y2, T x3, T y3, ColorFloat color, bool filled) {
     int actualX1, actualY1, actualX2, actualY2, actualX3, actualY3;
     getScreenCoordinates(x1, y1, actualX1, actualY1);
     getScreenCoordinates(x2, y2, actualX2, actualY2);
@@ -194,7 +346,8 @@ void CartesianCanvas::drawTriangle(Decimal x1, Decimal y1, Decimal x2, Decimal y
     Canvas::drawTriangle(actualX1, actualY1, actualX2, actualY2, actualX3, actualY3, color, filled);
 }
 
-void CartesianCanvas::drawTriangleStrip(int size, Decimal xverts[], Decimal yverts[], ColorFloat color[], bool filled) {
+template<typename T>
+void CartesianCanvasT<T>::drawTriangleStrip(int size, T xverts[], T yverts[], ColorFloat color[], bool filled) {
     int* int_x = new int[size];
     int* int_y = new int[size];
 
@@ -207,44 +360,54 @@ void CartesianCanvas::drawTriangleStrip(int size, Decimal xverts[], Decimal yver
     delete int_y;
 }
 
-void CartesianCanvas::getCartesianCoordinates(int screenX, int screenY, Decimal &cartX, Decimal &cartY) {
+template<typename T>
+void CartesianCanvasT<T>::getCartesianCoordinates(int screenX, int screenY, T &cartX, T &cartY) {
     cartX = (screenX * cartWidth) / getWindowWidth() + minX;
     cartY = minY - (screenY - getWindowHeight()) * cartHeight / getWindowHeight();
 }
 
-Decimal CartesianCanvas::getCartHeight() {
+template<typename T>
+T CartesianCanvasT<T>::getCartHeight() {
     return cartHeight;
 }
 
-Decimal CartesianCanvas::getCartWidth() {
+template<typename T>
+T CartesianCanvasT<T>::getCartWidth() {
     return cartWidth;
 }
 
-Decimal CartesianCanvas::getPixelWidth() {
+template<typename T>
+T CartesianCanvasT<T>::getPixelWidth() {
     return pixelWidth;
 }
 
-Decimal CartesianCanvas::getPixelHeight() {
+template<typename T>
+T CartesianCanvasT<T>::getPixelHeight() {
     return pixelHeight;
 }
 
-Decimal CartesianCanvas::getMaxX() {
+template<typename T>
+T CartesianCanvasT<T>::getMaxX() {
     return maxX;
 }
 
-Decimal CartesianCanvas::getMaxY() {
+template<typename T>
+T CartesianCanvasT<T>::getMaxY() {
     return maxY;
 }
 
-Decimal CartesianCanvas::getMinX() {
+template<typename T>
+T CartesianCanvasT<T>::getMinX() {
     return minX;
 }
 
-Decimal CartesianCanvas::getMinY() {
+template<typename T>
+T CartesianCanvasT<T>::getMinY() {
     return minY;
 }
 
-void CartesianCanvas::getScreenCoordinates(Decimal cartX, Decimal cartY, int &screenX, int &screenY) {
+template<typename T>
+void CartesianCanvasT<T>::getScreenCoordinates(T cartX, T cartY, int &screenX, int &screenY) {
     screenX = round((cartX - minX) / pixelWidth);
     if (atiCard)
       screenY = getWindowHeight() - round((cartY - minY) / pixelHeight + pixelHeight*0.5f);
@@ -252,7 +415,43 @@ void CartesianCanvas::getScreenCoordinates(Decimal cartX, Decimal cartY, int &sc
       screenY = getWindowHeight() - 1 - round((cartY - minY) / pixelHeight + pixelHeight*0.5f);
 }
 
-void CartesianCanvas::recomputeDimensions(Decimal xMin, Decimal yMin, Decimal xMax, Decimal yMax) {
+template<typename T>
+void CartesianCanvasT<T>::getScreenCoordinates(int size, const T cartX[], const T cartY[], int screenX[], int screenY[]) {
+    const T left = minX, bottom = minY, pw = pixelWidth, ph = pixelHeight, halfPh = pixelHeight*0.5f;
+    const int top = getWindowHeight() - (atiCard ? 0 : 1);
+    #pragma omp simd
+    for (int i = 0; i < size; ++i) {
+      T sx = (cartX[i] - left) / pw;
+      T sy = (cartY[i] - bottom) / ph + halfPh;
+      screenX[i] = sx + (sx < 0 ? -0.5f : 0.5f);  // Same as round(), but without the library call
+      screenY[i] = top - (int)(sy + (sy < 0 ? -0.5f : 0.5f));
+    }
+}
+
+template<typename T>
+void CartesianCanvasT<T>::plot(GLenum mode, int size, const T x[], const T y[], ColorFloat color) {
+    std::vector<float> worldX(size), worldY(size);
+    const T originX = worldOriginX, originY = worldOriginY;
+    #pragma omp simd
+    for (int i = 0; i < size; ++i) {
+      worldX[i] = x[i] - originX;  // Small offsets keep more of their precision as floats
+      worldY[i] = y[i] - originY;
+    }
+    addWorldGeometry(mode, size, worldX.data(), worldY.data(), color);
+}
+
+template<typename T>
+void CartesianCanvasT<T>::plotPoints(int size, const T x[], const T y[], ColorFloat color) {
+    plot(GL_POINTS, size, x, y, color);
+}
+
+template<typename T>
+void CartesianCanvasT<T>::plotPolyline(int size, const T x[], const T y[], ColorFloat color) {
+    plot(GL_LINE_STRIP, size, x, y, color);
+}
+
+template<typename T>
+void CartesianCanvasT<T>::recomputeDimensions(T xMin, T yMin, T xMax, T yMax) {
     minX = xMin;
     minY = yMin;
     maxX = xMax;
@@ -261,52 +460,67 @@ void CartesianCanvas::recomputeDimensions(Decimal xMin, Decimal yMin, Decimal xM
     cartHeight = maxY - minY;
     pixelWidth = cartWidth / (getWindowWidth() - 1);
     pixelHeight = cartHeight / (getWindowHeight() - 1);  //Minor hacky fix
+    setWorldTransform(1 / pixelWidth, -1 / pixelHeight, (worldOriginX - minX) / pixelWidth,
+                      getWindowHeight() - 1 - (worldOriginY - minY) / pixelHeight);
 }
 
-void CartesianCanvas::run(void (*myFunction)(CartesianCanvas&) ) {
+template<typename T>
+void CartesianCanvasT<T>::run(void (*myFunction)(CartesianCanvasT<T>&) ) {
   start(); myFunction(*this); wait();
 }
-void CartesianCanvas::run(void (*myFunction)(CartesianCanvas&, int), int i) {
+template<typename T>
+void CartesianCanvasT<T>::run(void (*myFunction)(CartesianCanvasT<T>&, int), int i) {
   start(); myFunction(*this, i); wait();
 }
-void CartesianCanvas::run(void (*myFunction)(CartesianCanvas&, unsigned), unsigned u) {
+template<typename T>
+void CartesianCanvasT<T>::run(void (*myFunction)(CartesianCanvasT<T>&, unsigned), unsigned u) {
   start(); myFunction(*this, u); wait();
 }
-void CartesianCanvas::run(void (*myFunction)(CartesianCanvas&, int, int), int i1, int i2) {
+template<typename T>
+void CartesianCanvasT<T>::run(void (*myFunction)(CartesianCanvasT<T>&, int, int), int i1, int i2) {
   start(); myFunction(*this, i1, i2); wait();
 }
-void CartesianCanvas::run(void (*myFunction)(CartesianCanvas&, unsigned, unsigned), unsigned u1, unsigned u2) {
+template<typename T>
+void CartesianCanvasT<T>::run(void (*myFunction)(CartesianCanvasT<T>&, unsigned, unsigned), unsigned u1, unsigned u2) {
   start(); myFunction(*this, u1, u2); wait();
 }
-void CartesianCanvas::run(void (*myFunction)(CartesianCanvas&, std::string),std::string s) {
+template<typename T>
+void CartesianCanvasT<T>::run(void (*myFunction)(CartesianCanvasT<T>&, std::string),std::string s) {
   start(); myFunction(*this, s); wait();
 }
-void CartesianCanvas::run(void (*myFunction)(CartesianCanvas&, int, std::string), int i, std::string s) {
+template<typename T>
+void CartesianCanvasT<T>::run(void (*myFunction)(CartesianCanvasT<T>&, int, std::string), int i, std::string s) {
   start(); myFunction(*this, i, s); wait();
 }
-void CartesianCanvas::run(void (*myFunction)(CartesianCanvas&, std::string, int), std::string s, int i) {
+template<typename T>
+void CartesianCanvasT<T>::run(void (*myFunction)(CartesianCanvasT<T>&, std::string, int), std::string s, int i) {
   start(); myFunction(*this, s, i); wait();
 }
 
-void CartesianCanvas::sleep() {
+template<typename T>
+void CartesianCanvasT<T>::sleep() {
     Canvas::sleep();
 }
 
-void CartesianCanvas::zoom(Decimal x, Decimal y, Decimal scale) {
-    Decimal newWidth = cartWidth * scale;
-    Decimal newHeight = cartHeight * scale;
+template<typename T>
+void CartesianCanvasT<T>::zoom(T x, T y, T scale) {
+    T newWidth = cartWidth * scale;
+    T newHeight = cartHeight * scale;
     recomputeDimensions(x - .5 * newWidth, y - .5 * newHeight, x + .5 * newWidth, y + .5 * newHeight);
 }
 
-void CartesianCanvas::zoom(Decimal x1, Decimal y1, Decimal x2, Decimal y2) {
-    Decimal scale = (std::abs(x2 - x1) / cartWidth + std::abs(y2 - y1) / cartHeight) / 2.0;
+template<typename T>
+void CartesianCanvasT<T>::zoom(T x1, T y1, T x2, T y2) {
+    T scale = (std::abs(x2 - x1) / cartWidth + std::abs(y2 - y1) / cartHeight) / 2.0;
     zoom((x2 + x1) / 2, (y2 + y1) / 2, scale);
 }
 
 //-----------------------Unit testing-------------------------------------------------
-void CartesianCanvas::runTests() {
+template<typename T>
+void CartesianCanvasT<T>::runTests() {
   TsglDebug("Testing CartesianCanvas class...");
-  CartesianCanvas c1(0.0f);
+  tsglAssert(testBatchedFunctions(), "Unit test for batched function evaluation failed!");
+  CartesianCanvasT<T> c1(0.0f);
   c1.setBackgroundColor(WHITE);
   c1.start();
 
@@ -315,16 +529,20 @@ void CartesianCanvas::runTests() {
   tsglAssert(testRecomputeDimensions(c1), "Unit test for recomputing dimensions failed!");
   c1.stop();
 
-  CartesianCanvas c2(-1, -1, 800, 600, -1, -1, 3, 2,"");
+  CartesianCanvasT<T> c2(-1, -1, 800, 600, -1, -1, 3, 2,"");
   c2.setBackgroundColor(WHITE);
   c2.start();
   tsglAssert(testDraw(c2), "Unit test for drawing functions failed!");
+  tsglAssert(testBatchedCoordinates(c2), "Unit test for batched coordinate transforms failed!");
+  tsglAssert(testAdaptiveSampling(c2), "Unit test for adaptive function sampling failed!");
+  tsglAssert(testPlot(c2), "Unit test for retained plotting failed!");
   c2.wait();
 
   TsglDebug("Unit tests for CartesianCanvas complete.");
 }
 
-bool CartesianCanvas::testDraw(CartesianCanvas& can) {
+template<typename T>
+bool CartesianCanvasT<T>::testDraw(CartesianCanvasT<T>& can) {
   int passed = 0;
   int failed = 0;
 
@@ -413,7 +631,8 @@ bool CartesianCanvas::testDraw(CartesianCanvas& can) {
   }
 }
 
-bool CartesianCanvas::testZoom(CartesianCanvas& can) {
+template<typename T>
+bool CartesianCanvasT<T>::testZoom(CartesianCanvasT<T>& can) {
     int passed = 0;
     int failed = 0;
     //Test 1: Zooming out
@@ -469,11 +688,12 @@ bool CartesianCanvas::testZoom(CartesianCanvas& can) {
     }
 }
 
-bool CartesianCanvas::testRecomputeDimensions(CartesianCanvas& can) {
+template<typename T>
+bool CartesianCanvasT<T>::testRecomputeDimensions(CartesianCanvasT<T>& can) {
    int passed = 0;
    int failed = 0;
-   Decimal xMin, xMax;
-   Decimal yMin, yMax;
+   T xMin, xMax;
+   T yMin, yMax;
    //Test 1: Positive values only (with 0.0)
    xMin = 0.0;
    xMax = 500.0;
@@ -528,5 +748,281 @@ bool CartesianCanvas::testRecomputeDimensions(CartesianCanvas& can) {
      return false;
    }
 }
+
+template<typename T>
+bool CartesianCanvasT<T>::testBatchedCoordinates(CartesianCanvasT<T>& can) {
+   int passed = 0;
+   int failed = 0;
+   const int SIZE = 2000;
+   T* x = new T[SIZE];
+   T* y = new T[SIZE];
+   int *batchX = new int[SIZE], *batchY = new int[SIZE];
+   for (int i = 0; i < SIZE; ++i) {  // Cover the whole window, plus a margin off each side
+     x[i] = can.getMinX() - 1 + (can.getCartWidth() + 2) * i / SIZE;
+     y[i] = can.getMaxY() + 1 - (can.getCartHeight() + 2) * ((i * 7) % SIZE) / SIZE;
+   }
+   //Test 1: Batched transform matches the single-point transform
+   can.getScreenCoordinates(SIZE, x, y, batchX, batchY);
+   int mismatches = 0;
+   for (int i = 0; i < SIZE; ++i) {
+     int sx, sy;
+     can.getScreenCoordinates(x[i], y[i], sx, sy);
+     if (sx != batchX[i] || sy != batchY[i])
+       ++mismatches;
+   }
+   if (mismatches == 0) {
+     passed++;
+   } else {
+     failed++;
+     TsglErr("Test 1, Batched versus single transforms for testBatchedCoordinates() failed!");
+   }
+
+   //Test 2: Drawing a batch of points lands on the same pixels as drawing them one by one
+   can.drawPoints(SIZE, x, y, RED);
+   can.sync(can.flush());
+   ColorInt red(255, 0, 0);
+   const int atiOffset = can.atiCard ? 1 : 0;  // drawPoints() shifts points up on ATI cards
+   int wrong = 0;
+   for (int i = 0; i < SIZE; ++i) {
+     int py = batchY[i] - atiOffset;
+     if (batchX[i] > 0 && batchX[i] < can.getWindowWidth() - 1 &&
+         py > 0 && py < can.getWindowHeight() - 1 &&
+         can.getPoint(batchX[i], py) != red)
+       ++wrong;
+   }
+   if (wrong == 0) {
+     passed++;
+   } else {
+     failed++;
+     TsglErr("Test 2, Drawing a batch of points for testBatchedCoordinates() failed!");
+   }
+   delete [] x;
+   delete [] y;
+   delete [] batchX;
+   delete [] batchY;
+
+   if(passed == 2 && failed == 0) {
+     TsglDebug("Unit test for batched coordinate transforms passed!");
+     return true;
+   } else {
+     TsglErr("This many tests passed for testBatchedCoordinates(): ");
+     std::cout << " " << passed << std::endl;
+     TsglErr("This many tests failed for testBatchedCoordinates(): ");
+     std::cout << " " << failed << std::endl;
+     return false;
+   }
+}
+
+template<typename T>
+bool CartesianCanvasT<T>::testAdaptiveSampling(CartesianCanvasT<T>& can) {
+   int passed = 0;
+   int failed = 0;
+   std::vector<Decimal> xs, ys;
+   std::vector<int> runs;
+   const int COLUMNS = can.getWindowWidth();
+
+   //Test 1: A straight line needs fewer evaluations and vertices than there are pixel columns
+   PowerFunction line(1);
+   int evaluations = can.sampleFunction(line, can.getMinX(), can.getMaxX(), xs, ys, runs);
+   if (evaluations < COLUMNS && (int)xs.size() < COLUMNS / 2 && runs.size() == 1) {
+     passed++;
+   } else {
+     failed++;
+     TsglErr("Test 1, Sampling a straight line for testAdaptiveSampling() failed!");
+   }
+
+   //Test 2: A curve stays within about half a pixel of the true function between vertices
+   SineFunction sine;
+   can.sampleFunction(sine, can.getMinX(), can.getMaxX(), xs, ys, runs);
+   Decimal worst = 0;
+   for (unsigned i = 0; i + 1 < xs.size(); ++i) {
+     for (Decimal x = xs[i]; x < xs[i + 1]; x += can.getPixelWidth() / 4) {
+       Decimal y = ys[i] + (x - xs[i]) / (xs[i + 1] - xs[i]) * (ys[i + 1] - ys[i]);
+       worst = std::max(worst, std::abs(y - sine.valueAt(x)) / can.getPixelHeight());
+     }
+   }
+   if (runs.size() == 1 && worst < 0.75) {
+     passed++;
+   } else {
+     failed++;
+     TsglErr("Test 2, Accuracy of a sampled curve for testAdaptiveSampling() failed!");
+   }
+
+   //Test 3: The asymptote of tan(x) at pi/2 splits the curve instead of being drawn across
+   TangentFunction tangent;
+   can.sampleFunction(tangent, can.getMinX(), can.getMaxX(), xs, ys, runs);
+   bool crossed = false;
+   for (unsigned i = 0; i + 1 < xs.size(); ++i) {
+     bool newRun = std::find(runs.begin(), runs.end(), (int)i + 1) != runs.end();
+     if (!newRun && xs[i] < PI / 2 && xs[i + 1] > PI / 2)
+       crossed = true;
+   }
+   if (runs.size() == 2 && !crossed) {
+     passed++;
+   } else {
+     failed++;
+     TsglErr("Test 3, Splitting at an asymptote for testAdaptiveSampling() failed!");
+   }
+
+   if(passed == 3 && failed == 0) {
+     TsglDebug("Unit test for adaptive function sampling passed!");
+     return true;
+   } else {
+     TsglErr("This many tests passed for testAdaptiveSampling(): ");
+     std::cout << " " << passed << std::endl;
+     TsglErr("This many tests failed for testAdaptiveSampling(): ");
+     std::cout << " " << failed << std::endl;
+     return false;
+   }
+}
+
+template<typename T>
+bool CartesianCanvasT<T>::testPlot(CartesianCanvasT<T>& can) {
+   int passed = 0;
+   int failed = 0;
+   const T xMin = can.getMinX(), yMin = can.getMinY(), xMax = can.getMaxX(), yMax = can.getMaxY();
+   const T centerX = xMin + 400 * can.getPixelWidth(), centerY = yMin + 300 * can.getPixelHeight();
+   const int SIZE = 200;
+   T x[SIZE], y[SIZE];
+   int oldX[SIZE], oldY[SIZE];
+   for (int i = 0; i < SIZE; ++i) {  // Even numbers of pixels from the center, so they land on pixels when zoomed out
+     x[i] = centerX + 2 * (i - SIZE / 2) * can.getPixelWidth();
+     y[i] = centerY + 2 * ((i * 7) % SIZE - SIZE / 2) * can.getPixelHeight();
+   }
+   ColorInt blue(0, 0, 255);
+   auto missing = [&]() {
+     int sx[SIZE], sy[SIZE], count = 0;
+     can.getScreenCoordinates(SIZE, x, y, sx, sy);
+     for (int i = 0; i < SIZE; ++i)
+       if (can.getPoint(sx[i], sy[i]) != blue)
+         ++count;
+     return count;
+   };
+
+   //Test 1: Plotted points land on the same pixels as drawn ones
+   can.plotPoints(SIZE, x, y, BLUE);
+   can.sync(can.flush());
+   if (missing() == 0) {
+     passed++;
+   } else {
+     failed++;
+     TsglErr("Test 1, Plotting points for testPlot() failed!");
+   }
+
+   //Test 2: Zooming out moves the points, and erases them from where they were
+   can.getScreenCoordinates(SIZE, x, y, oldX, oldY);
+   can.zoom(centerX, centerY, 2);
+   can.sync(can.flush());
+   int leftBehind = 0;
+   for (int i = 0; i < SIZE; ++i)
+     if ((i < SIZE / 4 || i >= SIZE * 3 / 4) && can.getPoint(oldX[i], oldY[i]) == blue)
+       ++leftBehind;  // These were far enough out that none of the points moved onto them
+   if (missing() == 0 && leftBehind == 0) {
+     passed++;
+   } else {
+     failed++;
+     TsglErr("Test 2, Zooming plotted points for testPlot() failed!");
+   }
+
+   //Test 3: Clearing the plot erases the points for good
+   can.clearPlot();
+   can.recomputeDimensions(xMin, yMin, xMax, yMax);
+   can.sync(can.flush());
+   if (missing() == SIZE) {
+     passed++;
+   } else {
+     failed++;
+     TsglErr("Test 3, Clearing plotted points for testPlot() failed!");
+   }
+
+   if(passed == 3 && failed == 0) {
+     TsglDebug("Unit test for retained plotting passed!");
+     return true;
+   } else {
+     TsglErr("This many tests passed for testPlot(): ");
+     std::cout << " " << passed << std::endl;
+     TsglErr("This many tests failed for testPlot(): ");
+     std::cout << " " << failed << std::endl;
+     return false;
+   }
+}
+
+namespace {
+  Decimal cubic(Decimal x) {  // For testing PointerFunction
+    return x * x * x - 2 * x;
+  }
+}
+
+template<typename T>
+bool CartesianCanvasT<T>::testBatchedFunctions() {
+   int passed = 0;
+   int failed = 0;
+   const int SIZE = 1000;
+   Decimal xs[SIZE], ys[SIZE];
+   for (int i = 0; i < SIZE; ++i)
+     xs[i] = 0.005 + i * 0.01;  // Positive, so every function is defined, and never a whole or half number
+   //Whether valuesAt() gives valueAt() at every input, over the whole array and over an odd-sized tail
+   auto same = [&xs, &ys](const Function& f) {
+     bool ok = true;
+     for (int start = 0; start < SIZE; start += SIZE - 7) {
+       int n = SIZE - start;
+       f.valuesAt(xs + start, ys + start, n);
+       for (int i = start; i < SIZE; ++i) {
+         Decimal y = f.valueAt(xs[i]);
+         ok = ok && std::abs(ys[i] - y) <= 1e-12 * std::max((Decimal)1, std::abs(y));
+       }
+     }
+     return ok;
+   };
+
+   //Test 1: Every built-in Function's batched override matches its scalar one
+   PowerFunction power(2.5);
+   SquareRootFunction root;
+   SineFunction sine;
+   CosineFunction cosine;
+   TangentFunction tangent;
+   AbsoluteFunction absolute;
+   ExponentialFunction exponential;
+   NaturalLogFunction naturalLog;
+   CommonLogFunction commonLog;
+   CeilingFunction up;
+   FloorFunction down;
+   RoundFunction nearest;
+   const Function* builtIns[] = { &power, &root, &sine, &cosine, &tangent, &absolute, &exponential,
+                                  &naturalLog, &commonLog, &up, &down, &nearest };
+   bool allSame = true;
+   for (unsigned k = 0; k < sizeof(builtIns) / sizeof(builtIns[0]); ++k)
+     allSame = allSame && same(*builtIns[k]);
+   if (allSame) {
+     passed++;
+   } else {
+     failed++;
+     TsglErr("Test 1, Built-in Functions for testBatchedFunctions() failed!");
+   }
+
+   //Test 2: So do the adapters for function pointers and expressions
+   using namespace expr;
+   if (same(PointerFunction(&cubic)) && same(makeFunction(sin(x) * pow(x, 2) - sqrt(x) / 3))) {
+     passed++;
+   } else {
+     failed++;
+     TsglErr("Test 2, PointerFunction and ExpressionFunction for testBatchedFunctions() failed!");
+   }
+
+   if(passed == 2 && failed == 0) {
+     TsglDebug("Unit test for batched function evaluation passed!");
+     return true;
+   } else {
+     TsglErr("This many tests passed for testBatchedFunctions(): ");
+     std::cout << " " << passed << std::endl;
+     TsglErr("This many tests failed for testBatchedFunctions(): ");
+     std::cout << " " << failed << std::endl;
+     return false;
+   }
+}
 //-----------------End Unit testing----------------------------------------------------
+
+template class CartesianCanvasT<float>;
+template class CartesianCanvasT<double>;
+template class CartesianCanvasT<long double>;
 }
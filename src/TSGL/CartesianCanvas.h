@@ -9,27 +9,49 @@
 #include "Function.h"   // For drawing math functions on the screen
 #include "Util.h"
 
-namespace tsgl {
+#include <algorithm>    // For sorting sampled segments
+#include <vector>       // For adaptively sampling Functions
 
-typedef Decimal (*functionPointer)(Decimal x);
+namespace tsgl {
 
 /*!
- * \class CartesianCanvas
+ * \class CartesianCanvasT
  * \brief Canvas extended with Cartesian drawing operations.
- * \details CartesianCanvas provides a Canvas with a Cartesian coordinate system for ease of plotting.
+ * \details CartesianCanvasT provides a Canvas with a Cartesian coordinate system for ease of plotting.
+ * \details The template parameter <code>T</code> is the type used for Cartesian coordinates, and may be
+ *   <code>float</code>, <code>double</code> or <code>long double</code>. <code>long double</code> gives the
+ *   most precision (useful when zooming in deeply), while <code>float</code> and <code>double</code> let
+ *   the batched coordinate transforms be vectorized. CartesianCanvas is a typedef for
+ *   <code>CartesianCanvasT<Decimal></code>.
  * \note While on a regular Canvas, pixels higher on the screen have a lower y-value, <b>on a CartesianCanvas,
  *   pixels higher on the screen have a higher y-value.</b>
  */
-class CartesianCanvas : public Canvas {
+template<typename T>
+class CartesianCanvasT : public Canvas {
 private:
-    Decimal cartWidth;                                                  // maxX-minX
-    Decimal cartHeight;                                                 // maxY-minY
-    Decimal minX, maxX, minY, maxY;                                     // Bounding Cartesian coordinates for the window
-    Decimal pixelWidth, pixelHeight;                                    // cartWidth/window.w(), cartHeight/window.h()
-
-    static bool testZoom(CartesianCanvas& can);                         // Unit test for zoom() methods
-    static bool testRecomputeDimensions(CartesianCanvas& can);          // Unit test for recomputeDimensions()
-    static bool testDraw(CartesianCanvas& can);                         // Unit test for drawing
+    T cartWidth;                                                    // maxX-minX
+    T cartHeight;                                                   // maxY-minY
+    T minX, maxX, minY, maxY;                                       // Bounding Cartesian coordinates for the window
+    T pixelWidth, pixelHeight;                                      // cartWidth/window.w(), cartHeight/window.h()
+    T worldOriginX, worldOriginY;                                   // Point that plotted coordinates are stored relative to
+
+    static const int FUNCTION_CHUNK = 256;                          // Number of Function values computed per task
+    static const int SAMPLE_SPACING = 4;                            // Pixels between a Function's first samples
+    static const int MAX_SUBDIVISION = 64;                          // Narrowest sampled segment, in fractions of a pixel
+
+    void plot(GLenum mode, int size, const T x[], const T y[], ColorFloat color);  // Retains plotted vertices
+    void drawValues(int size, const Decimal xs[], const Decimal ys[], ColorFloat color);  // Plots precomputed values
+    static void evaluate(const Function& function, const Decimal xs[], Decimal ys[], int size);  // Parallel valuesAt()
+    int sampleFunction(const Function& function, T min, T max, std::vector<Decimal>& xs,
+                       std::vector<Decimal>& ys, std::vector<int>& runs);  // Adaptively samples a Function
+
+    static bool testZoom(CartesianCanvasT& can);                    // Unit test for zoom() methods
+    static bool testRecomputeDimensions(CartesianCanvasT& can);     // Unit test for recomputeDimensions()
+    static bool testDraw(CartesianCanvasT& can);                    // Unit test for drawing
+    static bool testBatchedCoordinates(CartesianCanvasT& can);      // Unit test for batched transforms
+    static bool testAdaptiveSampling(CartesianCanvasT& can);        // Unit test for sampleFunction()
+    static bool testPlot(CartesianCanvasT& can);                    // Unit test for retained plotting
+    static bool testBatchedFunctions();                             // Unit test for Function::valuesAt()
 public:
 
     /*!
@@ -42,7 +64,7 @@ public:
      *   The created CartesianCanvas will take up approximately 90% of the monitor's height, and will
      *   have a 4:3 aspect ratio.
      */
-    CartesianCanvas(double timerLength = 0.0);
+    CartesianCanvasT(double timerLength = 0.0);
 
     /*!
      * \brief Explicit CartesianCanvas constructor method.
@@ -61,8 +83,14 @@ public:
      * \return A new CartesianCanvas with the specified position, dimensions, scaling, title,
      *   and timer length.
      */
-    CartesianCanvas(int x, int y, int width, int height, Decimal xMin, Decimal yMin, Decimal xMax, Decimal yMax,
-                    std::string t, double timerLength = 0.0);
+    CartesianCanvasT(int x, int y, int width, int height, T xMin, T yMin, T xMax, T yMax,
+                     std::string t, double timerLength = 0.0);
+
+    /*!
+     * \brief Removes everything plotted with plotPoints() and plotPolyline().
+     * \details The retained points and lines are discarded, and the CartesianCanvas is cleared.
+     */
+    void clearPlot();
 
     /*!
      * \brief Draws axes on the Cartesian Canvas.
@@ -73,7 +101,7 @@ public:
      *    \param spacingX The distance between marks on the x-axis.
      *    \param spacingY The distance between marks on the y-axis.
      */
-    void drawAxes(Decimal originX, Decimal originY, Decimal spacingX, Decimal spacingY);
+    void drawAxes(T originX, T originY, T spacingX, T spacingY);
 
     /*!
      * \brief Draws a circle.
@@ -89,7 +117,7 @@ public:
      *     (set to true by default).
      * \note Identical to Canvas::drawCircle().
      */
-    void drawCircle(Decimal x, Decimal y, Decimal radius, int sides, ColorFloat color = BLACK, bool filled = true);
+    void drawCircle(T x, T y, T radius, int sides, ColorFloat color = BLACK, bool filled = true);
 
     /*!
      * \brief Draws a Concave polygon with colored vertices.
@@ -106,7 +134,7 @@ public:
      * \note Identical to Canvas::drawConcavePolygon().
      * \see drawConvexPolygon().
      */
-    void drawConcavePolygon(int size, Decimal xverts[], Decimal yverts[], ColorFloat color[], bool filled = true);
+    void drawConcavePolygon(int size, T xverts[], T yverts[], ColorFloat color[], bool filled = true);
 
     /*!
      * \brief Draws a convex polygon with colored vertices.
@@ -123,7 +151,7 @@ public:
      *   180 degrees ( see http://www.mathopenref.com/polygonconvex.html ).
      * \note Identical to Canvas::drawConvexPolygon().
      */
-    void drawConvexPolygon(int size, Decimal xverts[], Decimal yverts[], ColorFloat color[], bool filled = true);
+    void drawConvexPolygon(int size, T xverts[], T yverts[], ColorFloat color[], bool filled = true);
 
     /*!
      * \brief Plots a function on the screen.
@@ -131,6 +159,8 @@ public:
      *   \param function Reference to the Function to plot.
      *   \param sleepTime Time to sleep between plotting points
      *   \param color The color of the vertices of the plotted function (set to BLACK by default).
+     * \note When <code>sleepTime</code> is 0, the Function is evaluated a chunk at a time with
+     *   Function::valuesAt(), by several threads at once.
      */
     void drawFunction(const Function &function, float sleepTime = 0.0f, ColorFloat color = BLACK);
 
@@ -157,7 +187,7 @@ public:
      *     (set to 1.0f by default).
      * \note Identical to Canvas::drawImage().
      */
-    void drawImage(std::string filename, Decimal x, Decimal y, Decimal w, Decimal h, float a = 1.0f);
+    void drawImage(std::string filename, T x, T y, T w, T h, float a = 1.0f);
 
     /*!
      * \brief Draws a line.
@@ -170,7 +200,7 @@ public:
      *     (set to BLACK by default).
      *  \note Identical to Canvas::drawLine().
      */
-    void drawLine(Decimal x1, Decimal y1, Decimal x2, Decimal y2, ColorFloat color = BLACK);
+    void drawLine(T x1, T y1, T x2, T y2, ColorFloat color = BLACK);
 
     /*!
      * \brief Plots part of a function on the screen.
@@ -182,8 +212,27 @@ public:
      *   \param sleepTime Time to sleep between plotting points
      *   \param color The color of the vertices of the plotted function (set to BLACK by default).
      * \note <code>function</code> must receive exactly one Decimal x parameter, and return a Decimal y parameter.
+     * \note When <code>sleepTime</code> is 0, <code>function</code> is evaluated by several threads at once,
+     *   so it must not modify any shared state.
+     */
+    void drawPartialFunction(functionPointer &function, T min, T max,
+                             float sleepTime = 0.0f, ColorFloat color = BLACK);
+
+    /*!
+     * \brief Plots part of a Function on the screen.
+     * \details This function receives a TSGL Function instance as a parameter and plots the function on
+     *   the CartesianCanvas between the specified minimum and maximum coordinates.
+     *   \param function Reference to the Function to plot.
+     *   \param min Minimum x value to evaluate and plot
+     *   \param max Maximum x value to evaluate and plot
+     *   \param sleepTime Time to sleep between plotting points
+     *   \param color The color of the vertices of the plotted function (set to BLACK by default).
+     * \note When <code>sleepTime</code> is 0, the Function is sampled adaptively: more densely where the
+     *   curve bends, less densely where it is flat or off the screen. Samples are evaluated a chunk at a
+     *   time with Function::valuesAt(), by several threads at once. Jumps (such as the asymptotes of
+     *   TangentFunction) are left as gaps rather than drawn as vertical lines.
      */
-    void drawPartialFunction(functionPointer &function, Decimal min, Decimal max,
+    void drawPartialFunction(const Function &function, T min, T max,
                              float sleepTime = 0.0f, ColorFloat color = BLACK);
 
     /*!
@@ -197,7 +246,7 @@ public:
      * \see drawPixel()
      * \note Identical to Canvas::drawPixel().
      */
-    void drawPixel(Decimal row, Decimal col, ColorFloat color = BLACK);
+    void drawPixel(T row, T col, ColorFloat color = BLACK);
 
     /*!
      * \brief Draws a single pixel, specified in x,y format.
@@ -210,7 +259,19 @@ public:
      * \see drawPoint()
      * \note Identical to Canvas::drawPoint().
      */
-    void drawPoint(Decimal x, Decimal y, ColorFloat color = BLACK);
+    void drawPoint(T x, T y, ColorFloat color = BLACK);
+
+    /*!
+     * \brief Draws many single pixels, specified in Cartesian coordinates.
+     * \details This function converts the points to window coordinates in batches with
+     *   getScreenCoordinates(int, const T[], const T[], int[], int[]), then draws each of them.
+     *   \param size The number of points to draw.
+     *   \param x An array of the x coordinates of the points.
+     *   \param y An array of the y coordinates of the points.
+     *   \param color The color of the points (set to BLACK by default).
+     * \note Much faster than calling drawPoint() once per point when plotting many points.
+     */
+    void drawPoints(int size, const T x[], const T y[], ColorFloat color = BLACK);
 
     /*!
      * \brief Draws a rectangle.
@@ -225,7 +286,7 @@ public:
      *     (set to true by default).
      * \note Identical to Canvas::drawRectangle().
      */
-    void drawRectangle(Decimal x1, Decimal y1, Decimal x2, Decimal y2, ColorFloat color = BLACK, bool filled = true);
+    void drawRectangle(T x1, T y1, T x2, T y2, ColorFloat color = BLACK, bool filled = true);
 
 
     /*!
@@ -238,7 +299,7 @@ public:
      *   \param color The color of the Text (set to BLACK by default).
      * \note Identical to Canvas::drawText(std::string,..).
      */
-    void drawText(std::string text, Decimal x, Decimal y, unsigned size, ColorFloat color = BLACK);
+    void drawText(std::string text, T x, T y, unsigned size, ColorFloat color = BLACK);
 
     /*!
      * \brief Draw a string of text.
@@ -250,7 +311,7 @@ public:
      *   \param color The color of the Text (set to BLACK by default).
      * \note Identical to Canvas::drawText(std::wstring,..).
      */
-    void drawText(std::wstring text, Decimal x, Decimal y, unsigned size, ColorFloat color = BLACK);
+    void drawText(std::wstring text, T x, T y, unsigned size, ColorFloat color = BLACK);
 
     /*!
      * \brief Draw a triangle.
@@ -265,7 +326,7 @@ public:
      *      \param filled Whether the Triangle should be filled (set to true by default).
      * \note Identical to Canvas::drawTriangle().
      */
-    void drawTriangle(Decimal x1, Decimal y1, Decimal x2, Decimal y2, Decimal x3, Decimal y3, ColorFloat color = BLACK,
+    void drawTriangle(T x1, T y1, T x2, T y2, T x3, T y3, ColorFloat color = BLACK,
                       bool filled = true);
 
     /*!
@@ -280,7 +341,7 @@ public:
      *     (set to true by default).
      * \note Identical to Canvas::drawTriangleStrip().
      */
-    void drawTriangleStrip(int size, Decimal xverts[], Decimal yverts[], ColorFloat color[], bool filled = true);
+    void drawTriangleStrip(int size, T xverts[], T yverts[], ColorFloat color[], bool filled = true);
 
     /*!
      * \brief Translates Cartesian coordinates into window coordinates.
@@ -291,55 +352,55 @@ public:
      *    \param cartX A reference variable to be filled with screenX's Cartesian position.
      *    \param cartY A reference variable to be filled with screenY's Cartesian position.
      */
-    void getCartesianCoordinates(int screenX, int screenY, Decimal &cartX, Decimal &cartY);
+    void getCartesianCoordinates(int screenX, int screenY, T &cartX, T &cartY);
 
     /*!
      * \brief Accessor for the CartesianCanvas's Cartesian height.
      * \return The Cartesian height of the CartesianCanvas.
      */
-    Decimal getCartHeight();
+    T getCartHeight();
 
     /*!
      * \brief Accessor for the CartesianCanvas's Cartesian width.
      * \return The Cartesian width of the CartesianCanvas.
      */
-    Decimal getCartWidth();
+    T getCartWidth();
 
     /*!
      * \brief Accessor for the CartesianCanvas's right bound.
      * \return The real number corresponding the right of the CartesianCanvas.
      */
-    Decimal getMaxX();
+    T getMaxX();
 
     /*!
      * \brief Accessor for the CartesianCanvas's top bound.
      * \return The real number corresponding the top of the CartesianCanvas.
      */
-    Decimal getMaxY();
+    T getMaxY();
 
     /*!
      * \brief Accessor for the CartesianCanvas's left bound.
      * \return The real number corresponding the left of the CartesianCanvas.
      */
-    Decimal getMinX();
+    T getMinX();
 
     /*!
      * \brief Accessor for the CartesianCanvas's bottom bound.
      * \return The real number corresponding the bottom of the CartesianCanvas.
      */
-    Decimal getMinY();
+    T getMinY();
 
     /*!
      * \brief Accessor for the CartesianCanvas's effective pixel width.
      * \return The width corresponding to a single pixel in the current CartesianCanvas.
      */
-    Decimal getPixelWidth();
+    T getPixelWidth();
 
     /*!
      * \brief Accessor for the CartesianCanvas's effective pixel height.
      * \return The height corresponding to a single pixel in the current CartesianCanvas.
      */
-    Decimal getPixelHeight();
+    T getPixelHeight();
 
     /*!
      * \brief Translates window coordinates into Cartesian coordinates.
@@ -350,7 +411,48 @@ public:
      *   \param screenX A reference variable to be filled with cartX's window position.
      *   \param screenY A reference variable to be filled with cartY's window position.
      */
-    void getScreenCoordinates(Decimal cartX, Decimal cartY, int &screenX, int &screenY);
+    void getScreenCoordinates(T cartX, T cartY, int &screenX, int &screenY);
+
+    /*!
+     * \brief Translates many Cartesian coordinates into window coordinates at once.
+     * \details Gives the same results as calling getScreenCoordinates(T, T, int&, int&) on each point,
+     *   but hoists the per-call work out of the loop so that, when <code>T</code> is <code>float</code>
+     *   or <code>double</code>, the compiler can vectorize it.
+     *   \param size The number of points to translate.
+     *   \param cartX An array of the points' Cartesian x coordinates.
+     *   \param cartY An array of the points' Cartesian y coordinates.
+     *   \param screenX An array to store the points' window x coordinates in.
+     *   \param screenY An array to store the points' window y coordinates in.
+     */
+    void getScreenCoordinates(int size, const T cartX[], const T cartY[], int screenX[], int screenY[]);
+
+    /*!
+     * \brief Plots an array of points that stay on the CartesianCanvas as it is zoomed and panned.
+     * \details Unlike drawPoints(), which draws pixels once, plotPoints() keeps the points in Cartesian
+     *   coordinates on the GPU. When zoom() or recomputeDimensions() changes the bounds, the CartesianCanvas is
+     *   cleared and every plotted point is redrawn where it now belongs, by changing only the camera's view
+     *   matrix; no coordinates are recomputed or sent to the GPU again.
+     *   \param size The number of points.
+     *   \param x An array of the points' x coordinates.
+     *   \param y An array of the points' y coordinates.
+     *   \param color The color of the points (set to BLACK by default).
+     * \note Plotted coordinates are stored as floats relative to the center of the CartesianCanvas's initial
+     *   bounds, so zooming in very deeply far away from there will show rounding.
+     * \note Anything drawn with the other drawing functions is erased when the bounds change.
+     * \see plotPolyline(), clearPlot()
+     */
+    void plotPoints(int size, const T x[], const T y[], ColorFloat color = BLACK);
+
+    /*!
+     * \brief Plots a line through an array of points that stays on the CartesianCanvas as it is zoomed and panned.
+     * \details Same as plotPoints(), but joins the points with line segments.
+     *   \param size The number of vertices.
+     *   \param x An array of the vertices' x coordinates.
+     *   \param y An array of the vertices' y coordinates.
+     *   \param color The color of the line (set to BLACK by default).
+     * \see plotPoints(), clearPlot()
+     */
+    void plotPolyline(int size, const T x[], const T y[], ColorFloat color = BLACK);
 
     /*!
      * \brief Recomputes the CartesianCanvas's bounds.
@@ -360,7 +462,7 @@ public:
      *   \param xMax A real number corresponding to the new right edge of the CartesianCanvas.
      *   \param xMax A real number corresponding to the new top edge of the CartesianCanvas.
      */
-    void recomputeDimensions(Decimal xMin, Decimal yMin, Decimal xMax, Decimal yMax);
+    void recomputeDimensions(T xMin, T yMin, T xMax, T yMax);
 
     /*!
      * \brief Start the CartesianCanvas, run a function on it, and wait for the user to close it
@@ -370,7 +472,7 @@ public:
      * \param myFunction The function to run on the CartesianCanvas. Must take exactly one parameter of type
      *   CartesianCanvas&, which is a reference to the CartesianCanvas to render to.
      */
-    void run(void (*myFunction)(CartesianCanvas&));
+    void run(void (*myFunction)(CartesianCanvasT&));
 
     /*!
      * \brief Overload for run()
@@ -378,7 +480,7 @@ public:
      *   CartesianCanvas&, which is a reference to the CartesianCanvas to render to.
      * \param i An integer argument to myFunction
      */
-    void run(void (*myFunction)(CartesianCanvas&, int), int i);
+    void run(void (*myFunction)(CartesianCanvasT&, int), int i);
 
     /*!
      * \brief Overload for run()
@@ -386,7 +488,7 @@ public:
      *   CartesianCanvas&, which is a reference to the CartesianCanvas to render to.
      * \param u An unsigned integer argument to myFunction
      */
-    void run(void (*myFunction)(CartesianCanvas&, unsigned), unsigned u);
+    void run(void (*myFunction)(CartesianCanvasT&, unsigned), unsigned u);
 
     /*!
      * \brief Overload for run()
@@ -395,7 +497,7 @@ public:
      * \param i1 An integer argument to myFunction
      * \param i2 An integer argument to myFunction
      */
-    void run(void (*myFunction)(CartesianCanvas&, int, int), int i1, int i2);
+    void run(void (*myFunction)(CartesianCanvasT&, int, int), int i1, int i2);
 
     /*!
      * \brief Overload for run()
@@ -404,7 +506,7 @@ public:
      * \param u1 An unsigned integer argument to myFunction
      * \param u2 An unsigned integer argument to myFunction
      */
-    void run(void (*myFunction)(CartesianCanvas&, unsigned, unsigned), unsigned u1, unsigned u2);
+    void run(void (*myFunction)(CartesianCanvasT&, unsigned, unsigned), unsigned u1, unsigned u2);
 
     /*!
      * \brief Overload for run()
@@ -412,7 +514,7 @@ public:
      *   CartesianCanvas&, which is a reference to the CartesianCanvas to render to.
      * \param s A string argument to myFunction
      */
-    void run(void (*myFunction)(CartesianCanvas&, std::string),std::string s);
+    void run(void (*myFunction)(CartesianCanvasT&, std::string),std::string s);
 
     /*!
      * \brief Overload for run()
@@ -421,7 +523,7 @@ public:
      * \param i An integer argument to myFunction
      * \param s A string argument to myFunction
      */
-    void run(void (*myFunction)(CartesianCanvas&, int, std::string), int i, std::string s);
+    void run(void (*myFunction)(CartesianCanvasT&, int, std::string), int i, std::string s);
 
     /*!
      * \brief Overload for run()
@@ -430,7 +532,7 @@ public:
      * \param s A string argument to myFunction
      * \param i An integer argument to myFunction
      */
-    void run(void (*myFunction)(CartesianCanvas&, std::string, int), std::string s, int i);
+    void run(void (*myFunction)(CartesianCanvasT&, std::string, int), std::string s, int i);
 
     /*!
      * \brief Sleeps the internal drawing timer of a CartesianCanvas object.
@@ -449,7 +551,7 @@ public:
      *   \param scale The zoom scale compared to the original. Less than 1 zooms in, greater than 1 zooms out.
      * \note This function will automatically maintain the current aspect ratio.
      */
-    void zoom(Decimal x, Decimal y, Decimal scale);
+    void zoom(T x, T y, T scale);
 
     /*!
      * \brief Zoom the CartesianCanvas with the given bounding (Cartesian) coordinates.
@@ -463,7 +565,7 @@ public:
      * \warning This function will *NOT* automatically maintain the previous aspect ratio.
      * \warning Change the aspect ratio on-the-fly only with caution.
      */
-    void zoom(Decimal x1, Decimal y1, Decimal x2, Decimal y2);
+    void zoom(T x1, T y1, T x2, T y2);
 
     /*!
      * \brief Runs the Unit tests for CartesianCanvas.
@@ -471,6 +573,8 @@ public:
     static void runTests();
 };
 
+typedef CartesianCanvasT<Decimal> CartesianCanvas;  // The default, highest-precision CartesianCanvas
+
 }
 
 #endif /* CARTESIANCANVAS_H_- */
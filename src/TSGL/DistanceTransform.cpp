@@ -0,0 +1,273 @@
+#include "DistanceTransform.h"
+
+#include <algorithm>    // For clamping distances
+#include <cmath>        // For Euclidean distances
+#include <cstdlib>      // For absolute values
+#include <limits>       // For the distance when there are no features
+#include "Util.h"       // For the unit tests' random images
+
+namespace tsgl {
+
+/*
+ * Each metric gives the distance from column x of a row to the nearest feature of column i, whose nearest
+ * feature is g pixels up or down from the row, and the first column from which column u (> i) is at least as
+ * close as column i. See Meijster et al. for the derivations.
+ */
+namespace {
+
+struct Euclidean {
+    static long long f(int x, int i, int g) {
+      return (long long)(x - i) * (x - i) + (long long)g * g;
+    }
+    static int sep(int i, int u, int gi, int gu, int inf) {
+      return (int)(((long long)u * u - (long long)i * i + (long long)gu * gu - (long long)gi * gi) / (2 * (u - i)));
+    }
+    static float distance(long long f) {
+      return std::sqrt((float)f);
+    }
+};
+
+struct Manhattan {
+    static long long f(int x, int i, int g) {
+      return std::abs(x - i) + g;
+    }
+    static int sep(int i, int u, int gi, int gu, int inf) {
+      if (gu >= gi + u - i)
+        return inf;
+      if (gi > gu + u - i)
+        return -inf;
+      return (gu - gi + u + i) / 2;
+    }
+    static float distance(long long f) {
+      return (float)f;
+    }
+};
+
+struct Chessboard {
+    static long long f(int x, int i, int g) {
+      return std::max(std::abs(x - i), g);
+    }
+    static int sep(int i, int u, int gi, int gu, int inf) {
+      if (gi <= gu)
+        return std::max(i + gu, (i + u) / 2);
+      return std::min(u - gi, (i + u) / 2);
+    }
+    static float distance(long long f) {
+      return (float)f;
+    }
+};
+
+/*
+ * Finds the distances along one row from its column distances g, using s and t (each at least width long)
+ * as the stack of columns on the lower envelope and the first pixel each of them is nearest to.
+ */
+template <typename Metric>
+void transformRow(const int g[], float distances[], int width, int inf, int s[], int t[]) {
+    int q = 0;
+    s[0] = t[0] = 0;
+    for (int u = 1; u < width; ++u) {
+      while (q >= 0 && Metric::f(t[q], s[q], g[s[q]]) > Metric::f(t[q], u, g[u]))
+        --q;
+      if (q < 0) {
+        q = 0;
+        s[0] = u;
+      } else {
+        int w = 1 + Metric::sep(s[q], u, g[s[q]], g[u], inf);
+        if (w < width) {
+          ++q;
+          s[q] = u;
+          t[q] = w;
+        }
+      }
+    }
+    for (int u = width - 1; u >= 0; --u) {
+      distances[u] = Metric::distance(Metric::f(u, s[q], g[s[q]]));
+      if (u == t[q])
+        --q;
+    }
+}
+
+}
+
+DistanceTransform::DistanceTransform(int width, int height, unsigned threads) {
+    this->width = std::max(width, 0);
+    this->height = std::max(height, 0);
+    this->threads = (threads > 0) ? threads : omp_get_num_procs();
+    columnDistances.resize(this->width * this->height);
+}
+
+void DistanceTransform::compute(const bool features[], float distances[], DistanceMetric metric) {
+    const int W = width, H = height, INF = W + H;
+    if (W == 0 || H == 0)
+      return;
+    int* g = columnDistances.data();
+    bool found = false;
+
+    //Phase 1: distances within each column. Each thread sweeps its own block of columns a row at a time.
+    #pragma omp parallel num_threads(threads) reduction(||:found)
+    {
+      int tid = omp_get_thread_num(), nthreads = omp_get_num_threads();
+      int left = W * tid / nthreads, right = W * (tid + 1) / nthreads;
+      for (int x = left; x < right; ++x) {
+        g[x] = features[x] ? 0 : INF;
+        found = found || features[x];
+      }
+      for (int y = 1; y < H; ++y) {
+        const bool* row = features + y * W;
+        const int* above = g + (y - 1) * W;
+        int* here = g + y * W;
+        for (int x = left; x < right; ++x) {
+          here[x] = row[x] ? 0 : std::min(above[x] + 1, INF);
+          found = found || row[x];
+        }
+      }
+      for (int y = H - 2; y >= 0; --y) {
+        const int* below = g + (y + 1) * W;
+        int* here = g + y * W;
+        for (int x = left; x < right; ++x)
+          if (below[x] < here[x])
+            here[x] = below[x] + 1;
+      }
+    }
+
+    if (!found) {
+      std::fill(distances, distances + W * H, std::numeric_limits<float>::infinity());
+      return;
+    }
+
+    //Phase 2: distances along each row, from the lower envelope of its columns' distances
+    #pragma omp parallel num_threads(threads)
+    {
+      std::vector<int> s(W), t(W);
+      #pragma omp for
+      for (int y = 0; y < H; ++y) {
+        switch (metric) {
+          case TSGL_CHESSBOARD:
+            transformRow<Chessboard>(g + y * W, distances + y * W, W, INF, s.data(), t.data());
+            break;
+          case TSGL_MANHATTAN:
+            transformRow<Manhattan>(g + y * W, distances + y * W, W, INF, s.data(), t.data());
+            break;
+          default:
+            transformRow<Euclidean>(g + y * W, distances + y * W, W, INF, s.data(), t.data());
+            break;
+        }
+      }
+    }
+}
+
+//-----------------Unit testing-------------------------------------------------------
+void DistanceTransform::runTests() {
+    TsglDebug("Testing DistanceTransform class...");
+    tsglAssert(testAgainstBruteForce(), "Unit test for matching brute force failed!");
+    tsglAssert(testNoFeatures(), "Unit test for images without features failed!");
+    TsglDebug("Unit tests for DistanceTransform complete.");
+    std::cout << std::endl;
+}
+
+bool DistanceTransform::testAgainstBruteForce() {
+    int passed = 0;
+    int failed = 0;
+
+    const int W = 53, H = 37;
+    const DistanceMetric METRICS[3] = { TSGL_CHESSBOARD, TSGL_EUCLIDEAN, TSGL_MANHATTAN };
+    Random rng(48);
+    bool features[W * H];
+    for (int i = 0; i < W * H; ++i)
+      features[i] = rng.nextInt(0, 100) < 3;
+    float distances[W * H];
+    DistanceTransform transform(W, H, 4);
+
+    //Tests 1-3: Each metric matches measuring to every feature
+    for (int m = 0; m < 3; ++m) {
+      transform.compute(features, distances, METRICS[m]);
+      bool same = true;
+      for (int y = 0; y < H; ++y) {
+        for (int x = 0; x < W; ++x) {
+          float best = std::numeric_limits<float>::infinity();
+          for (int i = 0; i < W * H; ++i) {
+            if (!features[i])
+              continue;
+            int dx = std::abs(i % W - x), dy = std::abs(i / W - y);
+            float d = (METRICS[m] == TSGL_CHESSBOARD) ? std::max(dx, dy)
+                    : (METRICS[m] == TSGL_MANHATTAN) ? dx + dy
+                    : std::sqrt((float)(dx * dx + dy * dy));
+            best = std::min(best, d);
+          }
+          same = same && std::abs(distances[y * W + x] - best) < 1e-4f;
+        }
+      }
+      if (same) {
+        passed++;
+      } else {
+        failed++;
+        TsglErr("Test " + to_string(m + 1) + ", Matching brute force for testAgainstBruteForce() failed!");
+      }
+    }
+
+    //Test 4: A single thread gets the same answer
+    float single[W * H];
+    DistanceTransform(W, H, 1).compute(features, single, TSGL_EUCLIDEAN);
+    transform.compute(features, distances, TSGL_EUCLIDEAN);
+    if (std::equal(single, single + W * H, distances)) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 4, Computing on one thread for testAgainstBruteForce() failed!");
+    }
+
+    if(passed == 4 && failed == 0) {
+      TsglDebug("Unit test for matching brute force passed!");
+      return true;
+    } else {
+      TsglErr("This many tests for DistanceTransform passed: ");
+      std::cout << " " << passed << std::endl;
+      TsglErr("This many tests for DistanceTransform failed: ");
+      std::cout << " " << failed << std::endl;
+      return false;
+    }
+}
+
+bool DistanceTransform::testNoFeatures() {
+    int passed = 0;
+    int failed = 0;
+
+    //Test 1: With no features, everything is infinitely far away
+    const int W = 20, H = 10;
+    bool features[W * H];
+    std::fill(features, features + W * H, false);
+    float distances[W * H];
+    distanceTransform(W, H, features, distances, TSGL_MANHATTAN);
+    bool infinite = true;
+    for (int i = 0; i < W * H; ++i)
+      infinite = infinite && distances[i] == std::numeric_limits<float>::infinity();
+    if (infinite) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 1, Transforming an empty image for testNoFeatures() failed!");
+    }
+
+    //Test 2: With one feature, distances count out from it
+    features[3 * W + 5] = true;
+    distanceTransform(W, H, features, distances, TSGL_CHESSBOARD);
+    if (distances[3 * W + 5] == 0 && distances[0] == 5 && distances[W * H - 1] == 14) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 2, Transforming a single feature for testNoFeatures() failed!");
+    }
+
+    if(passed == 2 && failed == 0) {
+      TsglDebug("Unit test for images without features passed!");
+      return true;
+    } else {
+      TsglErr("This many tests for DistanceTransform passed: ");
+      std::cout << " " << passed << std::endl;
+      TsglErr("This many tests for DistanceTransform failed: ");
+      std::cout << " " << failed << std::endl;
+      return false;
+    }
+}
+
+}
@@ -0,0 +1,103 @@
+/*
+ * DistanceTransform.h provides a linear-time distance transform for images.
+ */
+
+#ifndef DISTANCETRANSFORM_H_
+#define DISTANCETRANSFORM_H_
+
+#include <omp.h>            // For computing rows and columns in parallel
+#include <vector>           // For the column distances
+
+#include "Error.h"          // For unit testing output
+#include "TsglAssert.h"     // For unit testing purposes
+
+namespace tsgl {
+
+/*! \enum DistanceMetric
+ *  \brief How a DistanceTransform measures the distance between two pixels.
+ */
+enum DistanceMetric {
+    TSGL_CHESSBOARD,        // max(|dx|, |dy|)
+    TSGL_EUCLIDEAN,         // sqrt(dx^2 + dy^2)
+    TSGL_MANHATTAN          // |dx| + |dy|
+};
+
+/*! \class DistanceTransform
+ *  \brief Finds the distance from every pixel of an image to the nearest "feature" pixel.
+ *  \details DistanceTransform uses the separable algorithm of Meijster, Roerdink and Hesselink ("A General
+ *    Algorithm for Computing Distance Transforms in Linear Time", 2000), which takes O(width * height) time
+ *    whatever the distances turn out to be:
+ *    - First, each column is scanned down and back up to find the distance to the nearest feature in that
+ *      column. Threads each take a block of columns, and walk it a row at a time, so they read memory in order.
+ *    - Then, each row finds, for each pixel, the column whose nearest feature is closest, by building the lower
+ *      envelope of the columns' distance functions. Threads each take a share of the rows.
+ *    .
+ *  \details A DistanceTransform keeps its working memory between calls to compute(), so it is cheap to reuse
+ *    on images of the same size.
+ */
+class DistanceTransform {
+ private:
+    std::vector<int>    columnDistances;    // Distance from each pixel to the nearest feature in its column
+    int                 height, width;      // Size of the image in pixels
+    unsigned            threads;            // Number of threads to run with
+
+    static bool testAgainstBruteForce();
+    static bool testNoFeatures();
+ public:
+
+    /*!
+     * \brief Constructs a new DistanceTransform.
+     *   \param width The width of the images to transform, in pixels.
+     *   \param height The height of the images to transform, in pixels.
+     *   \param threads The number of threads to use (0, the default, uses as many as there are processors).
+     */
+    DistanceTransform(int width, int height, unsigned threads = 0);
+
+    /*!
+     * \brief Computes the distance transform of an image.
+     *   \param features Array of <code>width * height</code> flags, one row after another, which are true for
+     *     the pixels to measure distances to.
+     *   \param distances Array of <code>width * height</code> floats in which to store each pixel's distance
+     *     to the nearest feature pixel (0 for feature pixels themselves).
+     *   \param metric How to measure distances (Euclidean by default).
+     * \note If no pixel is a feature, every distance is set to infinity.
+     */
+    void compute(const bool features[], float distances[], DistanceMetric metric = TSGL_EUCLIDEAN);
+
+    /*!
+     * \brief Accessor for the height of the images to transform.
+     * \return The height in pixels.
+     */
+    int getHeight() { return height; }
+
+    /*!
+     * \brief Accessor for the width of the images to transform.
+     * \return The width in pixels.
+     */
+    int getWidth() { return width; }
+
+    /*!
+     * \brief Runs the Unit tests for DistanceTransform.
+     */
+    static void runTests();
+};
+
+/*!
+ * \brief Computes the distance from every pixel of an image to the nearest feature pixel.
+ * \details This is shorthand for constructing a DistanceTransform and calling its compute() method.
+ *   \param width The width of the image, in pixels.
+ *   \param height The height of the image, in pixels.
+ *   \param features Array of <code>width * height</code> flags, which are true for the pixels to measure
+ *     distances to.
+ *   \param distances Array of <code>width * height</code> floats in which to store the distances.
+ *   \param metric How to measure distances (Euclidean by default).
+ * \see DistanceTransform
+ */
+inline void distanceTransform(int width, int height, const bool features[], float distances[],
+                              DistanceMetric metric = TSGL_EUCLIDEAN) {
+    DistanceTransform(width, height).compute(features, distances, metric);
+}
+
+}
+
+#endif /* DISTANCETRANSFORM_H_ */
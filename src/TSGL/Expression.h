@@ -0,0 +1,198 @@
+/*
+ * Expression.h provides expression templates for building plottable functions out of simple pieces.
+ */
+
+#ifndef EXPRESSION_H_
+#define EXPRESSION_H_
+
+#include <cmath>        // For the math functions we wrap
+
+#include "Function.h"   // For plugging Expressions into CartesianCanvas and IntegralViewer
+#include "Util.h"       // Decimal typedef
+
+namespace tsgl {
+
+/*!
+ * \brief Expression templates for composing Functions at compile time.
+ * \details The objects in this namespace can be combined with the usual arithmetic operators and with
+ *   sin(), cos(), sqrt() and pow() to describe a function of one variable, <code>x</code>. For example:
+ *   \code
+ *   using namespace tsgl::expr;
+ *   can.drawFunction(makeFunction(sin(x) * pow(x, 2) + 3));
+ *   \endcode
+ *   The result of each operation is a distinct type that remembers the whole expression, so evaluating it
+ *   compiles down to inline arithmetic with no function pointers or virtual calls per sample.
+ * \details Use makeFunction() to turn an expression into a Function for CartesianCanvas::drawFunction()
+ *   or IntegralViewer.
+ */
+namespace expr {
+
+/*! \class Expression
+ *  \brief Base class for all expression types.
+ *  \details Expression uses the curiously recurring template pattern: each expression type <code>E</code>
+ *    derives from <code>Expression<E></code>, which lets the operators below accept any expression while
+ *    still knowing its exact type.
+ */
+template<typename E>
+struct Expression {
+    /*!
+     * \brief Accessor for the actual expression.
+     * \return A reference to this Expression as its derived type.
+     */
+    const E& self() const { return static_cast<const E&>(*this); }
+
+    /*!
+     * \brief Evaluates the expression.
+     *   \param x The value to substitute for the variable.
+     * \return The value of the expression at <code>x</code>.
+     */
+    Decimal operator()(Decimal x) const { return self()(x); }
+};
+
+/*! \class Variable
+ *  \brief The independent variable of an expression.
+ */
+struct Variable : public Expression<Variable> {
+    Decimal operator()(Decimal x) const { return x; }
+};
+
+/*! \class Constant
+ *  \brief A constant term of an expression.
+ */
+struct Constant : public Expression<Constant> {
+    Decimal value;  // The constant's value
+
+    explicit Constant(Decimal v) : value(v) {}
+    Decimal operator()(Decimal) const { return value; }
+};
+
+/*! \class Binary
+ *  \brief An operation on the values of two sub-expressions.
+ *  \details <code>Op</code> supplies a static <code>apply(Decimal, Decimal)</code> method.
+ */
+template<typename L, typename R, typename Op>
+struct Binary : public Expression< Binary<L, R, Op> > {
+    L left;   // Left operand
+    R right;  // Right operand
+
+    Binary(const L& l, const R& r) : left(l), right(r) {}
+    Decimal operator()(Decimal x) const { return Op::apply(left(x), right(x)); }
+};
+
+/*! \class Unary
+ *  \brief An operation on the value of one sub-expression.
+ *  \details <code>Op</code> supplies a static <code>apply(Decimal)</code> method.
+ */
+template<typename A, typename Op>
+struct Unary : public Expression< Unary<A, Op> > {
+    A arg;    // Operand
+
+    explicit Unary(const A& a) : arg(a) {}
+    Decimal operator()(Decimal x) const { return Op::apply(arg(x)); }
+};
+
+// The operations themselves (the math functions are the same ones the built-in Functions call)
+struct Add        { static Decimal apply(Decimal a, Decimal b) { return a + b; } };
+struct Subtract   { static Decimal apply(Decimal a, Decimal b) { return a - b; } };
+struct Multiply   { static Decimal apply(Decimal a, Decimal b) { return a * b; } };
+struct Divide     { static Decimal apply(Decimal a, Decimal b) { return a / b; } };
+struct Power      { static Decimal apply(Decimal a, Decimal b) { return ::pow(a, b); } };
+struct Negate     { static Decimal apply(Decimal a) { return -a; } };
+struct Sine       { static Decimal apply(Decimal a) { return ::sin(a); } };
+struct Cosine     { static Decimal apply(Decimal a) { return ::cos(a); } };
+struct SquareRoot { static Decimal apply(Decimal a) { return ::sqrt(a); } };
+
+/*!
+ * \var x
+ * \brief The variable to build expressions from.
+ */
+const Variable x = Variable();
+
+// Operators between two expressions, and between an expression and a constant on either side
+#define TSGL_EXPR_BINARY(NAME, OP)                                                                   \
+    template<typename L, typename R>                                                                \
+    inline Binary<L, R, OP> NAME(const Expression<L>& l, const Expression<R>& r) {                  \
+        return Binary<L, R, OP>(l.self(), r.self());                                                \
+    }                                                                                               \
+    template<typename L>                                                                            \
+    inline Binary<L, Constant, OP> NAME(const Expression<L>& l, Decimal r) {                        \
+        return Binary<L, Constant, OP>(l.self(), Constant(r));                                      \
+    }                                                                                               \
+    template<typename R>                                                                            \
+    inline Binary<Constant, R, OP> NAME(Decimal l, const Expression<R>& r) {                        \
+        return Binary<Constant, R, OP>(Constant(l), r.self());                                      \
+    }
+
+TSGL_EXPR_BINARY(operator+, Add)
+TSGL_EXPR_BINARY(operator-, Subtract)
+TSGL_EXPR_BINARY(operator*, Multiply)
+TSGL_EXPR_BINARY(operator/, Divide)
+TSGL_EXPR_BINARY(pow, Power)
+
+#undef TSGL_EXPR_BINARY
+
+#define TSGL_EXPR_UNARY(NAME, OP)                                                                    \
+    template<typename A>                                                                            \
+    inline Unary<A, OP> NAME(const Expression<A>& a) {                                              \
+        return Unary<A, OP>(a.self());                                                              \
+    }
+
+TSGL_EXPR_UNARY(operator-, Negate)
+TSGL_EXPR_UNARY(sin, Sine)
+TSGL_EXPR_UNARY(cos, Cosine)
+TSGL_EXPR_UNARY(sqrt, SquareRoot)
+
+#undef TSGL_EXPR_UNARY
+
+/*! \class ExpressionFunction
+ *  \brief Adapts an expression into a Function.
+ *  \details ExpressionFunction lets an expression be used anywhere a Function is expected. Both
+ *    valueAt() and valuesAt() evaluate the expression inline; only one virtual call is made per call
+ *    to valuesAt(), rather than one per sample.
+ */
+template<typename E>
+class ExpressionFunction : public Function {
+ public:
+
+    /*!
+     * \brief Constructs a new ExpressionFunction.
+     *      \param e The expression to evaluate.
+     */
+    explicit ExpressionFunction(const E& e) : e_(e) {}
+
+    /*!
+     * \brief Method to determine the value of the expression.
+     * \return The value of the expression at *x*.
+     */
+    virtual Decimal valueAt(Decimal x) const {
+        return e_(x);
+    }
+
+    /*!
+     * \brief Method to determine many values of the expression at once.
+     * \details Same as valueAt(), applied to each of the <code>n</code> inputs in <code>xs</code>.
+     */
+    virtual void valuesAt(const Decimal* xs, Decimal* ys, size_t n) const {
+        #pragma omp simd
+        for (size_t i = 0; i < n; ++i)
+          ys[i] = e_(xs[i]);
+    }
+ private:
+    E e_;
+};
+
+/*!
+ * \brief Turns an expression into a Function.
+ *   \param e The expression.
+ * \return An ExpressionFunction that evaluates <code>e</code>.
+ */
+template<typename E>
+inline ExpressionFunction<E> makeFunction(const Expression<E>& e) {
+    return ExpressionFunction<E>(e.self());
+}
+
+}
+
+}
+
+#endif /* EXPRESSION_H_ */
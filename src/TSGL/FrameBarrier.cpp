@@ -0,0 +1,304 @@
+#include "FrameBarrier.h"
+
+#include <atomic>   // For the unit tests' shared state
+#include <chrono>   // For giving the unit tests' threads time to block
+#include <thread>   // For the unit tests' threads
+
+namespace tsgl {
+
+FrameBarrier::FrameBarrier() {
+    deferred = false;
+    inFrame = false;
+    updaters = 0;
+    waiting = 0;
+}
+
+void FrameBarrier::beginFrame() {
+    std::unique_lock<std::mutex> lock(mutex);
+    ++waiting;
+    changed.wait(lock, [this]{ return updaters == 0 && !inFrame; });
+    --waiting;
+    deferred = false;
+    inFrame = true;
+}
+
+void FrameBarrier::beginUpdate() {
+    std::unique_lock<std::mutex> lock(mutex);
+    unsigned& depth = nesting[std::this_thread::get_id()];
+    if (depth++ > 0)  // Waiting for a frame inside our own update would never end
+      return;
+    changed.wait(lock, [this]{ return !inFrame && waiting == 0 && !deferred; });
+    ++updaters;
+}
+
+void FrameBarrier::cancelFrame() {
+    std::lock_guard<std::mutex> lock(mutex);
+    deferred = false;
+    changed.notify_all();
+}
+
+void FrameBarrier::endFrame() {
+    std::lock_guard<std::mutex> lock(mutex);
+    inFrame = false;
+    changed.notify_all();
+}
+
+void FrameBarrier::endUpdate() {
+    std::lock_guard<std::mutex> lock(mutex);
+    std::map<std::thread::id, unsigned>::iterator it = nesting.find(std::this_thread::get_id());
+    if (it == nesting.end())
+      return;
+    if (--it->second > 0)
+      return;
+    nesting.erase(it);
+    if (--updaters == 0)
+      changed.notify_all();
+}
+
+bool FrameBarrier::isUpdating() {
+    std::lock_guard<std::mutex> lock(mutex);
+    return updaters > 0;
+}
+
+bool FrameBarrier::tryBeginFrame() {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (updaters > 0 || inFrame) {
+      deferred = true;
+      return false;
+    }
+    deferred = false;
+    inFrame = true;
+    return true;
+}
+
+//-----------------Unit testing-------------------------------------------------------
+void FrameBarrier::runTests() {
+    TsglDebug("Testing FrameBarrier class...");
+    FrameBarrier barrier;
+    tsglAssert(testExclusion(barrier), "Unit test for excluding frames and updates failed!");
+    tsglAssert(testFramePriority(barrier), "Unit test for prioritizing frames over updates failed!");
+    tsglAssert(testTryFrame(barrier), "Unit test for trying to begin frames failed!");
+    tsglAssert(testNesting(barrier), "Unit test for nested updates failed!");
+    TsglDebug("Unit tests for FrameBarrier complete.");
+    std::cout << std::endl;
+}
+
+bool FrameBarrier::testExclusion(FrameBarrier& barrier) {
+    int passed = 0;
+    int failed = 0;
+    //Test 1: Several threads may update at once
+    std::atomic<bool> begun(false), release(false);
+    std::thread other([&barrier, &begun, &release]() {
+      barrier.beginUpdate();
+      begun = true;
+      while (!release)
+        std::this_thread::yield();
+      barrier.endUpdate();
+    });
+    barrier.beginUpdate();
+    while (!begun)
+      std::this_thread::yield();
+    if (barrier.isUpdating() && barrier.updaters == 2) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 1, Concurrent updates for testExclusion() failed!");
+    }
+
+    //Test 2: A frame waits until the last update has ended
+    std::atomic<bool> drawn(false);
+    std::thread renderer([&barrier, &drawn]() {
+      barrier.beginFrame();
+      drawn = true;
+      barrier.endFrame();
+    });
+    barrier.endUpdate();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    bool early = drawn;
+    release = true;
+    other.join();
+    renderer.join();
+    if (!early && drawn && !barrier.isUpdating()) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 2, Frame waiting for updates for testExclusion() failed!");
+    }
+
+    //Test 3: An update waits until the frame has ended
+    std::atomic<bool> updated(false);
+    barrier.beginFrame();
+    std::thread updater([&barrier, &updated]() {
+      barrier.beginUpdate();
+      updated = true;
+      barrier.endUpdate();
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    early = updated;
+    barrier.endFrame();
+    updater.join();
+    if (!early && updated) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 3, Update waiting for frame for testExclusion() failed!");
+    }
+
+    if(passed == 3 && failed == 0) {
+      TsglDebug("Unit test for excluding frames and updates passed!");
+      return true;
+    } else {
+      TsglErr("This many tests for FrameBarrier passed: ");
+      std::cout << " " << passed << std::endl;
+      TsglErr("This many tests for FrameBarrier failed: ");
+      std::cout << " " << failed << std::endl;
+      return false;
+    }
+}
+
+bool FrameBarrier::testFramePriority(FrameBarrier& barrier) {
+    int passed = 0;
+    int failed = 0;
+    //Test 1: Once a frame is waiting, new updates wait for it
+    std::atomic<int> order(0);
+    int frameOrder = 0, updateOrder = 0;
+    barrier.beginUpdate();
+    std::thread renderer([&barrier, &order, &frameOrder]() {
+      barrier.beginFrame();
+      frameOrder = ++order;
+      barrier.endFrame();
+    });
+    while (true) {  // Wait for the frame to start waiting
+      std::lock_guard<std::mutex> lock(barrier.mutex);
+      if (barrier.waiting > 0) break;
+    }
+    std::thread updater([&barrier, &order, &updateOrder]() {
+      barrier.beginUpdate();
+      updateOrder = ++order;
+      barrier.endUpdate();
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    barrier.endUpdate();
+    renderer.join();
+    updater.join();
+    if (frameOrder == 1 && updateOrder == 2) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 1, Frame before later update for testFramePriority() failed!");
+    }
+
+    if(passed == 1 && failed == 0) {
+      TsglDebug("Unit test for prioritizing frames over updates passed!");
+      return true;
+    } else {
+      TsglErr("This many tests for FrameBarrier passed: ");
+      std::cout << " " << passed << std::endl;
+      TsglErr("This many tests for FrameBarrier failed: ");
+      std::cout << " " << failed << std::endl;
+      return false;
+    }
+}
+
+
+bool FrameBarrier::testTryFrame(FrameBarrier& barrier) {
+    int passed = 0;
+    int failed = 0;
+    //Test 1: A frame can't begin during an update, and later updates wait for it to be tried again
+    std::atomic<bool> updated(false);
+    barrier.beginUpdate();
+    bool begun = barrier.tryBeginFrame();
+    std::thread updater([&barrier, &updated]() {
+      barrier.beginUpdate();
+      updated = true;
+      barrier.endUpdate();
+    });
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    bool early = updated;
+    barrier.endUpdate();
+    bool retried = barrier.tryBeginFrame();
+    if (retried)
+      barrier.endFrame();
+    updater.join();
+    if (!begun && !early && retried && updated) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 1, Trying a frame during an update for testTryFrame() failed!");
+    }
+
+    //Test 2: Cancelling the frame lets the waiting updates begin
+    updated = false;
+    barrier.beginUpdate();
+    begun = barrier.tryBeginFrame();
+    barrier.endUpdate();
+    std::thread canceller([&barrier]() {
+      std::this_thread::sleep_for(std::chrono::milliseconds(50));
+      barrier.cancelFrame();
+    });
+    barrier.beginUpdate();  // Would wait forever if the cancel didn't release it
+    updated = true;
+    barrier.endUpdate();
+    canceller.join();
+    if (!begun && updated && !barrier.isUpdating()) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 2, Cancelling a frame for testTryFrame() failed!");
+    }
+
+    if(passed == 2 && failed == 0) {
+      TsglDebug("Unit test for trying to begin frames passed!");
+      return true;
+    } else {
+      TsglErr("This many tests for FrameBarrier passed: ");
+      std::cout << " " << passed << std::endl;
+      TsglErr("This many tests for FrameBarrier failed: ");
+      std::cout << " " << failed << std::endl;
+      return false;
+    }
+}
+
+
+bool FrameBarrier::testNesting(FrameBarrier& barrier) {
+    int passed = 0;
+    int failed = 0;
+    //Test 1: A thread may begin an update inside its own, even while a frame is waiting
+    std::atomic<bool> drawn(false);
+    barrier.beginUpdate();
+    std::thread renderer([&barrier, &drawn]() {
+      barrier.beginFrame();
+      drawn = true;
+      barrier.endFrame();
+    });
+    while (true) {  // Wait for the frame to start waiting
+      std::lock_guard<std::mutex> lock(barrier.mutex);
+      if (barrier.waiting > 0) break;
+    }
+    barrier.beginUpdate();  // Would wait forever for the frame, which waits for us
+    bool nested = barrier.updaters == 1;
+    barrier.endUpdate();
+    std::this_thread::sleep_for(std::chrono::milliseconds(50));
+    bool early = drawn;
+    barrier.endUpdate();
+    renderer.join();
+    if (nested && !early && drawn && !barrier.isUpdating()) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 1, Nesting an update during a waiting frame for testNesting() failed!");
+    }
+
+    if(passed == 1 && failed == 0) {
+      TsglDebug("Unit test for nested updates passed!");
+      return true;
+    } else {
+      TsglErr("This many tests for FrameBarrier passed: ");
+      std::cout << " " << passed << std::endl;
+      TsglErr("This many tests for FrameBarrier failed: ");
+      std::cout << " " << failed << std::endl;
+      return false;
+    }
+}
+
+}
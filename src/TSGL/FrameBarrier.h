@@ -0,0 +1,112 @@
+/*
+ * FrameBarrier.h provides a reader / writer lock for synchronizing rendering with drawing threads.
+ */
+
+#ifndef FRAMEBARRIER_H_
+#define FRAMEBARRIER_H_
+
+#include <condition_variable>   // For waking waiting threads
+#include <map>                  // For counting each thread's nested updates
+#include <mutex>                // Needed for locking the barrier's state
+#include <thread>               // For telling threads apart
+
+#include "Error.h"              // For unit testing output
+#include "TsglAssert.h"         // For unit testing purposes
+
+namespace tsgl {
+
+/*! \class FrameBarrier
+ *  \brief Keeps a rendering thread from drawing a frame while other threads are in the middle of an update.
+ *  \details A FrameBarrier is a reader / writer lock. Any number of threads may be inside an update
+ *    (between beginUpdate() and endUpdate()) at once, but a frame (between beginFrame() and endFrame())
+ *    excludes all of them.
+ *  \details Waiting threads sleep on a condition variable and are woken as soon as they may proceed.
+ *    Frames take priority: once a frame is waiting, new updates wait until it is done, so that a steady
+ *    stream of updates cannot keep the Canvas from ever rendering.
+ *  \details Updates nest: a thread already inside an update may begin another without waiting, even for a
+ *    waiting frame, and only its outermost endUpdate() ends its part in the update.
+ *  \details FrameBarrier works with any kind of thread (std::thread, OpenMP, pthreads).
+ */
+class FrameBarrier {
+ private:
+    std::condition_variable changed;    // Signalled whenever a frame or the last update ends
+    bool                    deferred;   // Whether tryBeginFrame() failed and will be tried again
+    bool                    inFrame;    // Whether a frame is being drawn
+    std::mutex              mutex;      // Mutex for the barrier's state
+    std::map<std::thread::id, unsigned> nesting;  // How many updates each updating thread has begun
+    unsigned                updaters;   // Number of threads inside an update
+    unsigned                waiting;    // Number of frames waiting to begin
+
+    static bool testExclusion(FrameBarrier& barrier);
+    static bool testFramePriority(FrameBarrier& barrier);
+    static bool testNesting(FrameBarrier& barrier);
+    static bool testTryFrame(FrameBarrier& barrier);
+ public:
+
+    /*!
+     * \brief Default FrameBarrier constructor method.
+     * \details This is the default constructor for the FrameBarrier class.
+     * \return A new FrameBarrier with no frame or updates in progress.
+     */
+    FrameBarrier();
+
+    /*!
+     * \brief Begins a frame.
+     * \details Waits until no thread is inside an update, then keeps new updates from beginning until
+     *   endFrame() is called.
+     */
+    void beginFrame();
+
+    /*!
+     * \brief Begins an update.
+     * \details Waits until no frame is being drawn or waiting to be drawn, then keeps new frames from
+     *   beginning until the matching endUpdate() is called.
+     * \note May be called from any number of threads at once.
+     * \note Returns immediately if the calling thread is already inside an update.
+     */
+    void beginUpdate();
+
+    /*!
+     * \brief Gives up on a frame that tryBeginFrame() could not begin.
+     * \details Lets updates begin again without waiting for the frame to be tried again, for when it never
+     *   will be (e.g., because the Canvas has been closed).
+     */
+    void cancelFrame();
+
+    /*!
+     * \brief Ends a frame begun with beginFrame() or tryBeginFrame().
+     * \details Wakes all threads waiting to begin an update.
+     */
+    void endFrame();
+
+    /*!
+     * \brief Ends an update begun with beginUpdate().
+     * \details If this was the last update in progress, wakes the thread waiting to begin a frame.
+     * \note Must be called from the thread that began the update, once for each call to beginUpdate().
+     */
+    void endUpdate();
+
+    /*!
+     * \brief Begins a frame if no thread is inside an update, without waiting.
+     * \details If the frame can't begin, new updates wait as they would for beginFrame() until the frame is
+     *   tried again (or cancelFrame() is called), so that a steady stream of updates cannot keep it from ever
+     *   beginning.
+     * \return True if the frame has begun, and endFrame() must be called; false otherwise.
+     */
+    bool tryBeginFrame();
+
+    /*!
+     * \brief Accessor for whether any thread is inside an update.
+     * \return True if at least one update is in progress, false otherwise.
+     */
+    bool isUpdating();
+
+    /*!
+     * \brief Runs the Unit tests for FrameBarrier.
+     */
+    static void runTests();
+};
+
+}
+
+#endif /* FRAMEBARRIER_H_ */
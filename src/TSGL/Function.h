@@ -5,10 +5,14 @@
 #ifndef FUNCTION_H_
 #define FUNCTION_H_
 
+#include <cstddef>  // For size_t
+
 #include "Util.h"
 
 namespace tsgl {
 
+typedef Decimal (*functionPointer)(Decimal x);
+
 /*! \class Function
  *  \brief A base class for creating mathematical functions plottable by a CartesianCanvas.
  *  \details Function provides a base class for the creation of mathematical functions.
@@ -40,6 +44,56 @@ class Function {
      * \note This method is abstract and <B>must</B> be overridden.
      */
     virtual Decimal valueAt(Decimal x) const = 0;
+
+    /*!
+     * \brief Method to determine many values of a Function subclass at once.
+     * \details By default, this method simply calls valueAt() on each input in turn. Subclasses may
+     *   override it with a tight loop that the compiler can inline and vectorize; CartesianCanvas
+     *   plots Functions through this method, a chunk of inputs at a time.
+     *      \param xs An array of <code>n</code> inputs to the function.
+     *      \param ys An array to store the <code>n</code> outputs of the function in.
+     *      \param n The number of inputs to evaluate.
+     * \note CartesianCanvas may call this method from several threads at once (on different chunks),
+     *   so it must not modify any shared state.
+     */
+    virtual void valuesAt(const Decimal* xs, Decimal* ys, size_t n) const {
+        for (size_t i = 0; i < n; ++i)
+          ys[i] = valueAt(xs[i]);
+    }
+};
+
+/*! \class PointerFunction
+ *  \brief Adapts a plain function pointer into a Function.
+ */
+class PointerFunction : public Function {
+ public:
+
+    /*!
+     * \brief Constructs a new PointerFunction.
+     *      \param f Pointer to a function taking exactly one Decimal and returning a Decimal.
+     */
+    PointerFunction(functionPointer f) {
+        f_ = f;
+    }
+
+    /*!
+     * \brief Method to determine the value of PointerFunction.
+     * \return The result of calling the function pointer on *x*.
+     */
+    virtual Decimal valueAt(Decimal x) const {
+        return f_(x);
+    }
+
+    /*!
+     * \brief Method to determine many values of PointerFunction at once.
+     * \details Same as valueAt(), applied to each of the <code>n</code> inputs in <code>xs</code>.
+     */
+    virtual void valuesAt(const Decimal* xs, Decimal* ys, size_t n) const {
+        for (size_t i = 0; i < n; ++i)
+          ys[i] = f_(xs[i]);
+    }
+ private:
+    functionPointer f_;
 };
 
 /*! \class PowerFunction
@@ -64,6 +118,16 @@ class PowerFunction : public Function {
     virtual Decimal valueAt(Decimal x) const {
         return pow(x, a_);
     }
+
+    /*!
+     * \brief Method to determine many values of PowerFunction at once.
+     * \details Same as valueAt(), applied to each of the <code>n</code> inputs in <code>xs</code>.
+     */
+    virtual void valuesAt(const Decimal* xs, Decimal* ys, size_t n) const {
+        #pragma omp simd
+        for (size_t i = 0; i < n; ++i)
+          ys[i] = pow(xs[i], a_);
+    }
  private:
     Decimal a_;
 };
@@ -81,6 +145,16 @@ class SquareRootFunction : public Function {
     virtual Decimal valueAt(Decimal x) const {
         return sqrt(x);
     }
+
+    /*!
+     * \brief Method to determine many values of SquareRootFunction at once.
+     * \details Same as valueAt(), applied to each of the <code>n</code> inputs in <code>xs</code>.
+     */
+    virtual void valuesAt(const Decimal* xs, Decimal* ys, size_t n) const {
+        #pragma omp simd
+        for (size_t i = 0; i < n; ++i)
+          ys[i] = sqrt(xs[i]);
+    }
 };
 
 /*! \class SineFunction
@@ -96,6 +170,16 @@ class SineFunction : public Function {
     virtual Decimal valueAt(Decimal x) const {
         return sin(x);
     }
+
+    /*!
+     * \brief Method to determine many values of SineFunction at once.
+     * \details Same as valueAt(), applied to each of the <code>n</code> inputs in <code>xs</code>.
+     */
+    virtual void valuesAt(const Decimal* xs, Decimal* ys, size_t n) const {
+        #pragma omp simd
+        for (size_t i = 0; i < n; ++i)
+          ys[i] = sin(xs[i]);
+    }
 };
 
 /*! \class CosineFunction
@@ -111,6 +195,16 @@ class CosineFunction : public Function {
     virtual Decimal valueAt(Decimal x) const {
         return cos(x);
     }
+
+    /*!
+     * \brief Method to determine many values of CosineFunction at once.
+     * \details Same as valueAt(), applied to each of the <code>n</code> inputs in <code>xs</code>.
+     */
+    virtual void valuesAt(const Decimal* xs, Decimal* ys, size_t n) const {
+        #pragma omp simd
+        for (size_t i = 0; i < n; ++i)
+          ys[i] = cos(xs[i]);
+    }
 };
 
 /*! \class TangentFunction
@@ -126,6 +220,16 @@ class TangentFunction : public Function {
     virtual Decimal valueAt(Decimal x) const {
         return tan(x);
     }
+
+    /*!
+     * \brief Method to determine many values of TangentFunction at once.
+     * \details Same as valueAt(), applied to each of the <code>n</code> inputs in <code>xs</code>.
+     */
+    virtual void valuesAt(const Decimal* xs, Decimal* ys, size_t n) const {
+        #pragma omp simd
+        for (size_t i = 0; i < n; ++i)
+          ys[i] = tan(xs[i]);
+    }
 };
 
 /*! \class AbsoluteFunction
@@ -141,6 +245,16 @@ class AbsoluteFunction : public Function {
     virtual Decimal valueAt(Decimal x) const {
         return std::abs(x);
     }
+
+    /*!
+     * \brief Method to determine many values of AbsoluteFunction at once.
+     * \details Same as valueAt(), applied to each of the <code>n</code> inputs in <code>xs</code>.
+     */
+    virtual void valuesAt(const Decimal* xs, Decimal* ys, size_t n) const {
+        #pragma omp simd
+        for (size_t i = 0; i < n; ++i)
+          ys[i] = std::abs(xs[i]);
+    }
 };
 
 /*! \class ExponentialFunction
@@ -156,6 +270,16 @@ class ExponentialFunction : public Function {
     virtual Decimal valueAt(Decimal x) const {
         return exp(x);
     }
+
+    /*!
+     * \brief Method to determine many values of ExponentialFunction at once.
+     * \details Same as valueAt(), applied to each of the <code>n</code> inputs in <code>xs</code>.
+     */
+    virtual void valuesAt(const Decimal* xs, Decimal* ys, size_t n) const {
+        #pragma omp simd
+        for (size_t i = 0; i < n; ++i)
+          ys[i] = exp(xs[i]);
+    }
 };
 
 /*! \class NaturalLogFunction
@@ -171,6 +295,16 @@ class NaturalLogFunction : public Function {
     virtual Decimal valueAt(Decimal x) const {
         return log(x);
     }
+
+    /*!
+     * \brief Method to determine many values of NaturalLogFunction at once.
+     * \details Same as valueAt(), applied to each of the <code>n</code> inputs in <code>xs</code>.
+     */
+    virtual void valuesAt(const Decimal* xs, Decimal* ys, size_t n) const {
+        #pragma omp simd
+        for (size_t i = 0; i < n; ++i)
+          ys[i] = log(xs[i]);
+    }
 };
 
 /*! \class CommonLogFunction
@@ -186,6 +320,16 @@ class CommonLogFunction : public Function {
     virtual Decimal valueAt(Decimal x) const {
         return log10(x);
     }
+
+    /*!
+     * \brief Method to determine many values of CommonLogFunction at once.
+     * \details Same as valueAt(), applied to each of the <code>n</code> inputs in <code>xs</code>.
+     */
+    virtual void valuesAt(const Decimal* xs, Decimal* ys, size_t n) const {
+        #pragma omp simd
+        for (size_t i = 0; i < n; ++i)
+          ys[i] = log10(xs[i]);
+    }
 };
 
 /*! \class CeilingFunction
@@ -201,6 +345,16 @@ class CeilingFunction : public Function {
     virtual Decimal valueAt(Decimal x) const {
         return ceil(x);
     }
+
+    /*!
+     * \brief Method to determine many values of CeilingFunction at once.
+     * \details Same as valueAt(), applied to each of the <code>n</code> inputs in <code>xs</code>.
+     */
+    virtual void valuesAt(const Decimal* xs, Decimal* ys, size_t n) const {
+        #pragma omp simd
+        for (size_t i = 0; i < n; ++i)
+          ys[i] = ceil(xs[i]);
+    }
 };
 
 /*! \class FloorFunction
@@ -216,6 +370,16 @@ class FloorFunction : public Function {
     virtual Decimal valueAt(Decimal x) const {
         return floor(x);
     }
+
+    /*!
+     * \brief Method to determine many values of FloorFunction at once.
+     * \details Same as valueAt(), applied to each of the <code>n</code> inputs in <code>xs</code>.
+     */
+    virtual void valuesAt(const Decimal* xs, Decimal* ys, size_t n) const {
+        #pragma omp simd
+        for (size_t i = 0; i < n; ++i)
+          ys[i] = floor(xs[i]);
+    }
 };
 
 /*! \class RoundFunction
@@ -231,6 +395,16 @@ class RoundFunction : public Function {
     virtual Decimal valueAt(Decimal x) const {
         return round(x);
     }
+
+    /*!
+     * \brief Method to determine many values of RoundFunction at once.
+     * \details Same as valueAt(), applied to each of the <code>n</code> inputs in <code>xs</code>.
+     */
+    virtual void valuesAt(const Decimal* xs, Decimal* ys, size_t n) const {
+        #pragma omp simd
+        for (size_t i = 0; i < n; ++i)
+          ys[i] = round(xs[i]);
+    }
 };
 
 }
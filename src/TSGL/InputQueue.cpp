@@ -0,0 +1,135 @@
+#include "InputQueue.h"
+
+#include <thread>   // For the unit tests' producer thread
+
+namespace tsgl {
+
+InputQueue::InputQueue() : dropped(0), head(0), tail(0) { }
+
+unsigned long InputQueue::getDropped() const {
+    return dropped.load(std::memory_order_relaxed);
+}
+
+bool InputQueue::isEmpty() const {
+    return head.load(std::memory_order_relaxed) == tail.load(std::memory_order_acquire);
+}
+
+bool InputQueue::pop(InputEvent& event) {
+    unsigned h = head.load(std::memory_order_relaxed);
+    if (h == tail.load(std::memory_order_acquire))
+      return false;                                           // Nothing to pop
+    event = events[h & (CAPACITY - 1)];
+    head.store(h + 1, std::memory_order_release);             // Hand the slot back to the producer
+    return true;
+}
+
+bool InputQueue::push(const InputEvent& event) {
+    unsigned t = tail.load(std::memory_order_relaxed);
+    if (t - head.load(std::memory_order_acquire) == CAPACITY) {
+      dropped.fetch_add(1, std::memory_order_relaxed);        // Full; the consumer is falling behind
+      return false;
+    }
+    events[t & (CAPACITY - 1)] = event;
+    tail.store(t + 1, std::memory_order_release);             // Publish the event to the consumer
+    return true;
+}
+
+//-----------------Unit testing-------------------------------------------------------
+void InputQueue::runTests() {
+    TsglDebug("Testing InputQueue class...");
+    tsglAssert(testPushPop(), "Unit test for pushing and popping failed!");
+    tsglAssert(testConcurrent(), "Unit test for concurrent pushing and popping failed!");
+    TsglDebug("Unit tests for InputQueue complete.");
+    std::cout << std::endl;
+}
+
+bool InputQueue::testPushPop() {
+    int passed = 0;
+    int failed = 0;
+    InputQueue* q = new InputQueue();
+    InputEvent e = { TSGL_CURSOR_EVENT, 0, 0, 0, 0.0, 0.0, 0.0 };
+
+    //Test 1: Events come out in the order they went in
+    for (int i = 0; i < 10; ++i) {
+      e.x = i;
+      q->push(e);
+    }
+    bool inOrder = true;
+    for (int i = 0; i < 10; ++i)
+      inOrder = inOrder && q->pop(e) && e.x == i;
+    if (inOrder && q->isEmpty() && !q->pop(e)) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 1, FIFO order for testPushPop() failed!");
+    }
+
+    //Test 2: Pushing onto a full queue drops (and counts) the new event
+    for (unsigned i = 0; i < CAPACITY; ++i)
+      q->push(e);
+    if (!q->push(e) && q->getDropped() == 1) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 2, dropping when full for testPushPop() failed!");
+    }
+    delete q;
+
+    if(passed == 2 && failed == 0) {
+      TsglDebug("Unit test for pushing and popping passed!");
+      return true;
+    } else {
+      TsglErr("This many tests for InputQueue passed: ");
+      std::cout << " " << passed << std::endl;
+      TsglErr("This many tests for InputQueue failed: ");
+      std::cout << " " << failed << std::endl;
+      return false;
+    }
+}
+
+bool InputQueue::testConcurrent() {
+    int passed = 0;
+    int failed = 0;
+    InputQueue* q = new InputQueue();
+    const int EVENTS = 100000;
+
+    //Test 1: Every event pushed by one thread is popped, in order, by another
+    std::thread producer([q]() {
+      InputEvent e = { TSGL_CURSOR_EVENT, 0, 0, 0, 0.0, 0.0, 0.0 };
+      for (int i = 0; i < EVENTS; ++i) {
+        e.x = i;
+        while (!q->push(e))
+          std::this_thread::yield();
+      }
+    });
+    InputEvent e;
+    int next = 0;
+    bool inOrder = true;
+    while (next < EVENTS) {
+      if (q->pop(e)) {
+        inOrder = inOrder && (e.x == next);
+        ++next;
+      }
+    }
+    producer.join();
+    if (inOrder && q->isEmpty()) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 1, producer / consumer order for testConcurrent() failed!");
+    }
+    delete q;
+
+    if(passed == 1 && failed == 0) {
+      TsglDebug("Unit test for concurrent pushing and popping passed!");
+      return true;
+    } else {
+      TsglErr("This many tests for InputQueue passed: ");
+      std::cout << " " << passed << std::endl;
+      TsglErr("This many tests for InputQueue failed: ");
+      std::cout << " " << failed << std::endl;
+      return false;
+    }
+}
+
+}
@@ -0,0 +1,106 @@
+/*
+ * InputQueue.h provides a lock-free queue for passing input events from the GLFW callbacks to the application.
+ */
+
+#ifndef INPUTQUEUE_H_
+#define INPUTQUEUE_H_
+
+#include <atomic>           // For the lock-free indices
+
+#include "Error.h"          // For unit testing output
+#include "TsglAssert.h"     // For unit testing purposes
+
+namespace tsgl {
+
+/*! \brief Enum for the kinds of input events.
+ *  \details InputEventType tells what happened in an InputEvent.
+ */
+enum InputEventType {
+    TSGL_BUTTON_EVENT,      /*! A key or mouse button was pressed or released */
+    TSGL_CURSOR_EVENT,      /*! The mouse moved */
+    TSGL_SCROLL_EVENT       /*! The mouse wheel was scrolled */
+};
+
+/*! \struct InputEvent
+ *  \brief A single input event received by a Canvas.
+ *  \details <code>key</code>, <code>action</code> and <code>mods</code> are only meaningful for
+ *    TSGL_BUTTON_EVENT, and hold a Key, an Action and GLFW's modifier bits respectively.
+ *  \details <code>x</code> and <code>y</code> hold the mouse position for TSGL_BUTTON_EVENT and
+ *    TSGL_CURSOR_EVENT, and the scroll offsets for TSGL_SCROLL_EVENT.
+ *  \details <code>time</code> is the number of seconds since the Canvas was created at which the
+ *    event was received.
+ */
+struct InputEvent {
+    InputEventType type;    // What happened
+    int key, action, mods;  // Which key / button, whether it was pressed or released, and the modifiers held
+    double x, y;            // Mouse position or scroll offsets
+    double time;            // When the event was received
+};
+
+/*! \class InputQueue
+ *  \brief A fixed-size, lock-free, single-producer / single-consumer queue of InputEvents.
+ *  \details One thread (whichever is polling GLFW for events; Canvas makes sure only one does at a time)
+ *    pushes events while another thread pops them.
+ *    Neither of them ever blocks, and neither needs a mutex.
+ *  \details If the consumer falls behind and the queue fills up, new events are dropped and counted.
+ *  \warning <b>Pushing from more than one thread, or popping from more than one thread, at the same
+ *    time is not safe.</b>
+ */
+class InputQueue {
+ private:
+    static const unsigned CAPACITY = 4096;      // Must be a power of two
+
+    std::atomic<unsigned long> dropped;         // Number of events that were dropped because we were full
+    InputEvent                 events[CAPACITY];
+    std::atomic<unsigned>      head;            // Index of the next event to pop (only written by the consumer)
+    std::atomic<unsigned>      tail;            // Index of the next event to push (only written by the producer)
+
+    static bool testPushPop();
+    static bool testConcurrent();
+ public:
+
+    /*!
+     * \brief Default InputQueue constructor method.
+     * \details This is the default constructor for the InputQueue class.
+     * \return A new, empty InputQueue.
+     */
+    InputQueue();
+
+    /*!
+     * \brief Accessor for the number of dropped events.
+     * \return The number of events pushed while the InputQueue was full.
+     */
+    unsigned long getDropped() const;
+
+    /*!
+     * \brief Accessor for whether the InputQueue is empty.
+     * \return True if there are no events to pop, false otherwise.
+     * \note Only exact when called from the consumer; the producer may push at any time.
+     */
+    bool isEmpty() const;
+
+    /*!
+     * \brief Removes the oldest event from the InputQueue.
+     *   \param event The InputEvent to copy the oldest event into.
+     * \return True if an event was popped, false if the InputQueue was empty.
+     * \note May only be called from the consumer thread.
+     */
+    bool pop(InputEvent& event);
+
+    /*!
+     * \brief Adds an event to the InputQueue.
+     *   \param event The InputEvent to add.
+     * \return True if the event was added, false if it was dropped because the InputQueue was full.
+     * \note May only be called from the producer thread.
+     */
+    bool push(const InputEvent& event);
+
+    /*!
+     * \brief Runs the Unit tests for InputQueue.
+     */
+    static void runTests();
+};
+
+}
+
+#endif /* INPUTQUEUE_H_ */
@@ -3,7 +3,11 @@
 namespace tsgl {
 
 IntegralViewer::IntegralViewer(functionPointer f, int width, int height, Decimal startX, Decimal stopX, Decimal startY, Decimal stopY, std::string fname) {
-  myF = f;
+  myF.reset(new PointerFunction(f));
+  init(width, height, startX, stopX, startY, stopY, fname);
+}
+
+void IntegralViewer::init(int width, int height, Decimal startX, Decimal stopX, Decimal startY, Decimal stopY, std::string fname) {
   myWidth = width; myHeight = height;
   myStartX = startX; myStopX = stopX;
   myStartY = startY; myStopY = stopY;
@@ -52,7 +56,7 @@ void IntegralViewer::setupCanvas(CartesianCanvas*& can, const std::string& label
   can->start();
 
   can->drawRectangle(myStartX,myStartY,myStopX,myStopY,WHITE);        //Area we're drawing to
-  can->drawPartialFunction(myF,myStartX,myStopX,0,ColorInt(0,0,255)); //Outline of function
+  can->drawPartialFunction(*myF,myStartX,myStopX,0,ColorInt(0,0,255)); //Outline of function
   can->drawAxes(0, 0, SPACING, SPACING);                              //Axes marks
   drawLabels(can);
 }
@@ -74,7 +78,7 @@ long double IntegralViewer::rectangleEvaluate(long long numRectangles) {
       myRecCanvas->sleep();
       xLo = myStartX + i * recWidth;
       xMid = xLo + halfRecWidth;
-      y = (*myF)(xMid);
+      y = myF->valueAt(xMid);
       result += y;
       myRecCanvas->drawRectangle(xLo, 0, xLo+recWidth, y, tcol);
     }
@@ -103,8 +107,8 @@ long double IntegralViewer::trapezoidEvaluate(long long numTrapezoids) {
       if (!myTrapCanvas->isOpen()) continue;
       leftX = myStartX + i * trapWidth;
       rightX = leftX + trapWidth;
-      leftY = (*myF)(leftX);
-      rightY = (*myF)(rightX);
+      leftY = myF->valueAt(leftX);
+      rightY = myF->valueAt(rightX);
       result += ((leftY + rightY) * halfTrapWidth);
 
       xValues[0] = xValues[1] = leftX;
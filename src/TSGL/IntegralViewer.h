@@ -5,10 +5,12 @@
 #ifndef INTEGRALVIEWER_H_
 #define INTEGRALVIEWER_H_
 
+#include <memory>
 #include <string>
 #include <omp.h>
 #include <tsgl.h>
 #include <sstream>
+#include <type_traits>
 #include "Util.h"  //Decimal typedef
 
 namespace tsgl {
@@ -18,20 +20,21 @@ namespace tsgl {
  *  \details IntegralViewer provides a simple interface for integrating functions and outputting the results of the
  *    integration, both numerically and visually. IntegralViewer can evaluate an arbitrary function of the type
  *    <code>Decimal myFunction(Decimal x)</code>, where x is the input value of the function and the return value is
- *    the y value of the function. IntegralViewer can compute integrals using one or both of the rectangle method
+ *    the y value of the function, or any TSGL Function. IntegralViewer can compute integrals using one or both of the rectangle method
  *    and the trapezoid method, and provides functions for displaying both on a custom Canvas. Furthermore, these
  *    computations and visualizations are thread-safe; the number of threads to use can be set with
  *    <code>omp_set_num_threads()</code>.
  */
 class IntegralViewer {
 private:
-  functionPointer myF;
+  std::unique_ptr<const Function> myF;  // Our own copy of the function to integrate
   int myWidth, myHeight;
   long double myStartX, myStopX, myStartY, myStopY;
   double myRecTime, myTrapTime, myDelay;
   CartesianCanvas *myRecCanvas, *myTrapCanvas;
 
   void drawLabels(CartesianCanvas*& can);
+  void init(int width, int height, Decimal startX, Decimal stopX, Decimal startY, Decimal stopY, std::string fname);
   void setupCanvas(CartesianCanvas*& can, const std::string& label = "", double delay = 0.0);
 
 public:
@@ -53,6 +56,28 @@ public:
   IntegralViewer(functionPointer f, int width, int height, Decimal startX, Decimal stopX, Decimal startY = 0, Decimal stopY = 1,
            std::string fname  = "function");
 
+  /*!
+   * \brief Explicit IntegralViewer constructor method.
+   * \details This constructor integrates and displays a TSGL Function (such as one made from an expression
+   *   with expr::makeFunction()) instead of a function pointer.
+   *   \param f The Function to integrate and display. The IntegralViewer keeps its own copy, so it may be a
+   *     temporary, as in <code>IntegralViewer iv(makeFunction(sin(x) * x), ...)</code>. It must not modify
+   *     any shared state, as it is evaluated by several threads at once.
+   *   \param width The width of the window displaying the integration.
+   *   \param height The height of the window displaying the integration.
+   *   \param startX The minimum x-value whose y-value should be computed.
+   *   \param stopX The maximum x-value whose y-value should be computed.
+   *   \param startY The minimum y-value that should be displayed on the IntegralViewer's Canvas.
+   *   \param stopY The maximum y-value that should be displayed on the IntegralViewer's Canvas.
+   *   \param fname A descriptive name for the function you wish to integrate.
+   * \return A new IntegralViewer with the specified dimensions, bounds, and function description.
+   */
+  template <typename F, typename = typename std::enable_if<std::is_base_of<Function, F>::value>::type>
+  IntegralViewer(const F& f, int width, int height, Decimal startX, Decimal stopX, Decimal startY = 0, Decimal stopY = 1,
+           std::string fname  = "function") : myF(new F(f)) {
+    init(width, height, startX, stopX, startY, stopY, fname);
+  }
+
   /*!
    * \brief IntegralViewer destructor method.
    * \details This is the destructor for the IntegralViewer class.
@@ -0,0 +1,127 @@
+#include "RenderHub.h"
+
+namespace tsgl {
+
+RenderHub::RenderHub() {
+    canvasCount = 0;
+    next = 0;
+    stopping = false;
+
+    // Compile the shader programs once, in the context all later windows share objects with
+    GLFWwindow* shared = Canvas::retainSharedWindow();
+    Canvas::glfwMutex.lock();
+    glfwMakeContextCurrent(shared);
+    glewExperimental = GL_TRUE;
+    GLenum err = glewInit();
+    if (GLEW_OK != err) {
+        fprintf(stderr, "Error: %s\n", glewGetErrorString(err));
+        exit(102);
+    }
+    shaderProgram = Canvas::createShaderProgram(false, shaderVertex, shaderFragment);
+    textureShaderProgram = Canvas::createShaderProgram(true, textureShaderVertex, textureShaderFragment);
+    glFlush();                      // Make sure the programs are visible to the other contexts
+    glfwMakeContextCurrent(NULL);
+    Canvas::glfwMutex.unlock();
+
+    renderThread = std::thread(RenderHub::startRendering, this);
+}
+
+RenderHub::~RenderHub() {
+    hubMutex.lock();
+    stopping = true;
+    hubMutex.unlock();
+    wakeUp.notify_all();
+    renderThread.join();  // Returns once all of our Canvases have closed
+
+    Canvas::glfwMutex.lock();
+    glfwMakeContextCurrent(Canvas::sharedWindow);
+    Canvas::destroyShaderProgram(shaderProgram, shaderVertex, shaderFragment);
+    Canvas::destroyShaderProgram(textureShaderProgram, textureShaderVertex, textureShaderFragment);
+    glfwMakeContextCurrent(NULL);
+    Canvas::glfwMutex.unlock();
+    Canvas::releaseGlfw();
+}
+
+void RenderHub::add(Canvas& can) {
+    if (can.started) {
+        TsglErr("Canvas already started. Canvases must be added to a RenderHub before they are started.");
+        return;
+    }
+    can.hub = this;
+}
+
+void RenderHub::attach(Canvas* can) {
+    hubMutex.lock();
+    pending.push_back(can);
+    ++canvasCount;
+    hubMutex.unlock();
+    wakeUp.notify_all();
+}
+
+unsigned RenderHub::getCanvasCount() {
+    std::lock_guard<std::mutex> lock(hubMutex);
+    return canvasCount;
+}
+
+void RenderHub::renderLoop() {
+    std::unique_lock<std::mutex> lock(hubMutex);
+    while (!stopping || canvasCount > 0) {
+        // Start any newly added Canvases
+        while (!pending.empty()) {
+            Canvas* can = pending.front();
+            pending.erase(pending.begin());
+            lock.unlock();
+            can->renderThreadId = std::this_thread::get_id();
+            can->initGl();
+            can->beginDrawing();
+            canvases.push_back(can);
+            lock.lock();
+        }
+        if (canvases.empty()) {
+            wakeUp.wait(lock);  // Nothing to do until a Canvas is added or we're destroyed
+            continue;
+        }
+        lock.unlock();
+
+        // Render every Canvas whose frame is due, starting with a different one each round
+        double untilNextFrame = FRAME;
+        unsigned n = canvases.size();
+        for (unsigned i = 0; i < n; ++i) {
+            Canvas* can = canvases[(next + i) % n];
+            if (glfwWindowShouldClose(can->window))
+                continue;
+            if (can->drawTimer->advance())
+                can->drawFrame(false);  // A Canvas whose drawing is paused waits for the next round, not the others
+            untilNextFrame = std::min(untilNextFrame, can->drawTimer->getTimeUntilPeriod());
+        }
+        next = (next + 1) % n;
+
+      #ifndef __APPLE__
+        Canvas::pollEvents();  // Handle I/O for all of our Canvases at once
+      #endif
+
+        // Retire any Canvases that have been closed
+        unsigned closed = 0;
+        for (std::vector<Canvas*>::iterator it = canvases.begin(); it != canvases.end(); ) {
+            if (glfwWindowShouldClose((*it)->window)) {
+                (*it)->frameBarrier.cancelFrame();  // Its frame won't be tried again
+                (*it)->endDrawing();
+                it = canvases.erase(it);
+                ++closed;
+            } else {
+                ++it;
+            }
+        }
+
+        lock.lock();
+        canvasCount -= closed;
+        if (pending.empty() && untilNextFrame > 0)
+            wakeUp.wait_for(lock, std::chrono::duration<double>(untilNextFrame));
+    }
+}
+
+void RenderHub::startRendering(RenderHub* hub) {
+    hub->renderLoop();
+}
+
+}
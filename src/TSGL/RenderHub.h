@@ -0,0 +1,102 @@
+/*
+ * RenderHub.h provides a single rendering thread shared by any number of Canvases.
+ */
+
+#ifndef RENDERHUB_H_
+#define RENDERHUB_H_
+
+#include <condition_variable>   // For waking the rendering thread
+#include <mutex>                // Needed for locking the list of Canvases
+#include <thread>               // For the rendering thread
+#include <vector>               // For the list of Canvases
+
+#include "Canvas.h"
+
+namespace tsgl {
+
+/*! \class RenderHub
+ *  \brief Renders several Canvases from a single thread.
+ *  \details Normally, every Canvas spawns its own rendering thread, which wakes up once per frame. With many
+ *    (small) Canvases open at once, those threads mostly contend with each other for the GL driver.
+ *  \details A RenderHub replaces the rendering threads of all Canvases added to it with one thread of its own.
+ *    Each time around, that thread renders every Canvas whose frame is due, starting with a different Canvas
+ *    every time so that none of them falls behind for good, then handles I/O for all of them at once.
+ *  \details Canvases created while a RenderHub exists share their GL objects with it, which lets the RenderHub
+ *    compile TSGL's shader programs once for all of its Canvases.
+ *  \details Usage:
+ *    <code>
+ *    RenderHub hub;
+ *    Canvas c1(0, 0, 200, 200, "One"), c2(200, 0, 200, 200, "Two");
+ *    hub.add(c1);
+ *    hub.add(c2);
+ *    c1.start();
+ *    c2.start();
+ *    ...
+ *    c1.wait();
+ *    c2.wait();
+ *    </code>
+ *  \note Canvases still pace themselves with their own timers, so Canvases with different frame rates may
+ *    share a RenderHub.
+ *  \note A RenderHub must outlive the Canvases added to it; its destructor waits until they have all closed.
+ */
+class RenderHub {
+private:
+    std::vector<Canvas*>    canvases;                       // Canvases being rendered (only touched by the rendering thread)
+    unsigned                canvasCount;                    // Number of Canvases that are pending or being rendered
+    std::mutex              hubMutex;                       // Mutex for the list of Canvases waiting to be started
+    unsigned                next;                           // Index of the Canvas to render first in the next round
+    std::vector<Canvas*>    pending;                        // Canvases waiting to be started by the rendering thread
+    std::thread             renderThread;                   // Thread that renders all of the Canvases
+    GLtexture               shaderFragment,                 // Address of the shared fragment shader
+                            shaderProgram,                  // Address of the shared shader program
+                            shaderVertex;                   // Address of the shared vertex shader
+    bool                    stopping;                       // Whether the RenderHub is being destroyed
+    GLtexture               textureShaderFragment,          // Address of the shared textured fragment shader
+                            textureShaderProgram,           // Address of the shared textured shader program
+                            textureShaderVertex;            // Address of the shared textured vertex shader
+    std::condition_variable wakeUp;                         // Wakes the rendering thread when Canvases are added or removed
+
+    friend class Canvas;
+
+    void         attach(Canvas* can);                       // Queues a started Canvas for rendering
+    void         renderLoop();                              // Rendering loop of the RenderHub's thread
+    static void  startRendering(RenderHub* hub);            // Entry point of the rendering thread
+
+public:
+
+    /*!
+     * \brief Default RenderHub constructor method.
+     * \details This is the default constructor for the RenderHub class.
+     * \details Creates the shared GL context (if needed), compiles the shared shader programs, and starts
+     *   the RenderHub's rendering thread.
+     * \return A new RenderHub with no Canvases.
+     */
+    RenderHub();
+
+    /*!
+     * \brief RenderHub destructor method.
+     * \details This is the destructor for the RenderHub class.
+     * \details Waits for all of the RenderHub's Canvases to close, then stops the rendering thread and
+     *   frees the shared shader programs.
+     */
+    ~RenderHub();
+
+    /*!
+     * \brief Adds a Canvas to the RenderHub.
+     * \details Once started, the Canvas will be rendered by the RenderHub's thread rather than by a
+     *   thread of its own.
+     *   \param can The Canvas to add.
+     * \note The Canvas must not have been started yet.
+     */
+    void add(Canvas& can);
+
+    /*!
+     * \brief Accessor for the number of Canvases being rendered.
+     * \return The number of started Canvases that the RenderHub is rendering or about to render.
+     */
+    unsigned getCanvasCount();
+};
+
+}
+
+#endif /* RENDERHUB_H_ */
@@ -83,9 +83,15 @@ namespace tsgl {
 
 #define GL_GLEXT_PROTOTYPES
 
+std::shared_future<std::string> TextureHandler::defaultFont;
+std::once_flag TextureHandler::defaultFontSearch;
+
 TextureHandler::TextureHandler() {
     fontLibrary = nullptr;
     fontFace = nullptr;
+    std::call_once(defaultFontSearch, []() {
+      defaultFont = std::async(std::launch::async, findDefaultFont).share();
+    });
 }
 
 TextureHandler::~TextureHandler() {
@@ -93,6 +99,10 @@ TextureHandler::~TextureHandler() {
         glDeleteTextures(1, &(it->second));
     }
 
+    for (GlyphMap::iterator it = loadedGlyphs.begin(); it != loadedGlyphs.end(); ++it) {
+        glDeleteTextures(1, &(it->second.texture));
+    }
+
     for (FontMap::iterator it = loadedFonts.begin(); it != loadedFonts.end(); ++it) {
         FT_Done_Face(it->second);
     }
@@ -127,41 +137,39 @@ void TextureHandler::createGLtextureFromBuffer(GLtexture &texture, unsigned char
 
     glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST);
     glTexParameterf(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST);
+    glFlush();  // Make sure the texture is complete before another context tries to use it
 }
 
 bool TextureHandler::drawText(std::wstring text, unsigned int font_size, float* vertices) {
+    std::lock_guard<std::mutex> lock(handlerMutex);
     const wchar_t* string = text.c_str();
     if(fontFace == nullptr) {   //If no font is set, load up a default one
-      bool found = false;
-      for (int i = 0; i < sizeof(DEFAULTFONTPATHS)/sizeof(*DEFAULTFONTPATHS); ++i) {
-          if (fileExists(DEFAULTFONTPATHS[i])) {
-              TsglDebug("No Font set! Now loading from " + std::string(DEFAULTFONTPATHS[i]));    //NEW
-              loadFont(DEFAULTFONTPATHS[i]);
-              found = true;
-              break;
-          }
-      }
-      if (!found) {
+      std::string path = defaultFont.get();
+      if (path.empty()) {
           TsglErr("No suitable fonts found...exiting");    //NEW
           exit(44);
       }
+      TsglDebug("No Font set! Now loading from " + path);    //NEW
+      openFont(path);
     }
-    FT_GlyphSlot glyph = fontFace->glyph;
     FT_UInt current_glyph_index, previous_glyph_index = 0;
     int penX = vertices[0],
         penY = vertices[1];
 
-    bool error = FT_Set_Pixel_Sizes(fontFace, 0, font_size);
-    if (error) {
+    bool use_kerning = FT_HAS_KERNING(fontFace);
+    // Kerning uses whatever size the face was last set to, and cached glyphs don't set it
+    if (use_kerning && FT_Set_Pixel_Sizes(fontFace, 0, font_size)) {
         fprintf(stderr, "FT_Set_Pixel_Sizes failed\n");
         return false;
     }
 
-    bool use_kerning = FT_HAS_KERNING(fontFace);
-
     for (unsigned int i = 0; i < text.size(); i++) {
         current_glyph_index = FT_Get_Char_Index(fontFace, string[i]);
 
+        const Glyph* glyph = getGlyph(current_glyph_index, font_size);
+        if (glyph == nullptr)
+            return false;
+
         if (use_kerning && previous_glyph_index && current_glyph_index) {
             FT_Vector delta;
             FT_Get_Kerning(fontFace, previous_glyph_index, current_glyph_index, FT_KERNING_DEFAULT, &delta);
@@ -169,45 +177,17 @@ bool TextureHandler::drawText(std::wstring text, unsigned int font_size, float*
             penY += delta.y >> 6;
         }
 
-        error = FT_Load_Glyph(fontFace, current_glyph_index, FT_LOAD_RENDER);
-        if (error) {
-            fprintf(stderr, "FT_Load_Char falied\n");
-            return false;
-        }
-
         previous_glyph_index = current_glyph_index;
 
-        int glMode = GL_ALPHA;
-
-        char fontMode = glyph->bitmap.pixel_mode;
-        if (fontMode == FT_PIXEL_MODE_MONO)
-           glMode = GL_RED;
-        else if (fontMode == FT_PIXEL_MODE_GRAY)
-            glMode = GL_ALPHA;
-        else if (fontMode == FT_PIXEL_MODE_LCD)
-            glMode = GL_RGB;
-        else if (fontMode == FT_PIXEL_MODE_LCD_V)
-            glMode = GL_RGB;
-#ifndef _WIN32
-        else if (fontMode == FT_PIXEL_MODE_BGRA)
-            glMode = GL_RGBA;
-#endif
+        glBindTexture(GL_TEXTURE_2D, glyph->texture);                     // Set the current texture
 
-        GLtexture texture;
-        createGLtextureFromBuffer(texture, glyph->bitmap.buffer, glyph->bitmap.width, glyph->bitmap.rows, glMode);
-        glBindTexture(GL_TEXTURE_2D, texture);                            // Set the current texture
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
-        glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+        vertices[0]  = vertices[16] = penX + glyph->left;
+        vertices[8]  = vertices[24] = penX + glyph->left + glyph->width;
+        vertices[1]  = vertices[9]  = penY - glyph->top;
+        vertices[25] = vertices[17] = penY - glyph->top + glyph->rows;
 
-        vertices[0]  = vertices[16] = penX + glyph->bitmap_left;
-        vertices[8]  = vertices[24] = penX + glyph->bitmap_left + glyph->bitmap.width;
-        vertices[1]  = vertices[9]  = penY - glyph->bitmap_top;
-        vertices[25] = vertices[17] = penY - glyph->bitmap_top + glyph->bitmap.rows;
-
-        penX += glyph->advance.x >> 6;
-        penY += glyph->advance.y >> 6;
+        penX += glyph->advanceX;
+        penY += glyph->advanceY;
 
         glBufferData(GL_ARRAY_BUFFER, 32 * sizeof(float), vertices, GL_DYNAMIC_DRAW);  // Fill the buffer
         glDrawArrays(GL_TRIANGLE_STRIP, 0, 4);                                         // Draw the character
@@ -215,7 +195,71 @@ bool TextureHandler::drawText(std::wstring text, unsigned int font_size, float*
     return true;
 }
 
+std::string TextureHandler::findDefaultFont() {
+    for (unsigned i = 0; i < sizeof(DEFAULTFONTPATHS)/sizeof(*DEFAULTFONTPATHS); ++i) {
+        if (fileExists(DEFAULTFONTPATHS[i]))
+            return DEFAULTFONTPATHS[i];
+    }
+    return "";
+}
+
+const TextureHandler::Glyph* TextureHandler::getGlyph(FT_UInt index, unsigned int font_size) {
+    GlyphMap::key_type key(fontFace, font_size, index);
+    GlyphMap::iterator it = loadedGlyphs.find(key);
+    if (it != loadedGlyphs.end())
+        return &it->second;
+
+    // Render the glyph and upload it once; every later draw reuses the texture
+    bool error = FT_Set_Pixel_Sizes(fontFace, 0, font_size);
+    if (error) {
+        fprintf(stderr, "FT_Set_Pixel_Sizes failed\n");
+        return nullptr;
+    }
+
+    error = FT_Load_Glyph(fontFace, index, FT_LOAD_RENDER);
+    if (error) {
+        fprintf(stderr, "FT_Load_Char falied\n");
+        return nullptr;
+    }
+
+    FT_GlyphSlot slot = fontFace->glyph;
+    int glMode = GL_ALPHA;
+
+    char fontMode = slot->bitmap.pixel_mode;
+    if (fontMode == FT_PIXEL_MODE_MONO)
+       glMode = GL_RED;
+    else if (fontMode == FT_PIXEL_MODE_GRAY)
+        glMode = GL_ALPHA;
+    else if (fontMode == FT_PIXEL_MODE_LCD)
+        glMode = GL_RGB;
+    else if (fontMode == FT_PIXEL_MODE_LCD_V)
+        glMode = GL_RGB;
+#ifndef _WIN32
+    else if (fontMode == FT_PIXEL_MODE_BGRA)
+        glMode = GL_RGBA;
+#endif
+
+    Glyph glyph;
+    createGLtextureFromBuffer(glyph.texture, slot->bitmap.buffer, slot->bitmap.width, slot->bitmap.rows, glMode);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_LINEAR);
+    glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_LINEAR);
+    glyph.left = slot->bitmap_left;
+    glyph.top = slot->bitmap_top;
+    glyph.width = slot->bitmap.width;
+    glyph.rows = slot->bitmap.rows;
+    glyph.advanceX = slot->advance.x >> 6;
+    glyph.advanceY = slot->advance.y >> 6;
+    return &(loadedGlyphs[key] = glyph);
+}
+
 bool TextureHandler::loadFont(const std::string& filename) {
+    std::lock_guard<std::mutex> lock(handlerMutex);
+    return openFont(filename);
+}
+
+bool TextureHandler::openFont(const std::string& filename) {
     if (fontLibrary == nullptr) {
         if (FT_Init_FreeType(&fontLibrary)) {
             fprintf(stderr, "An error occurred during freetype font library initialization\n");
@@ -247,6 +291,7 @@ bool TextureHandler::loadFont(const std::string& filename) {
 
 GLtexture TextureHandler::loadPicture(std::string filename, unsigned int &width, unsigned int &height,
                                 GLtexture &texture) {
+    std::lock_guard<std::mutex> lock(handlerMutex);
     if (loadedTextures.find(filename) == loadedTextures.end()) {  // Load the image if we haven't already
         texture = 0;
         std::string extension = filename.substr(filename.find_last_of('.'));
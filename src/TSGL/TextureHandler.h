@@ -26,6 +26,10 @@
 #include <stdexcept>
 #include <string>
 #include <cstring>
+#include <future>
+#include <map>
+#include <mutex>
+#include <tuple>
 #include <unordered_map>
 
 #include "Error.h"
@@ -40,16 +44,36 @@ namespace tsgl {
  *  \brief Handles saving, loading, and rendering of images and textures.
  *  \details TextureHandler provides an interface for saving, loading, and rendering images and text to Canvas
  *    and CartesianCanvas through the use of GLTextures.
+ *  \details Images, fonts and rendered glyphs are each loaded once and then kept until the TextureHandler is
+ *    destroyed. A single TextureHandler may be shared by several Canvases whose windows share GL objects
+ *    (see Canvas::setSharedResources()); all of its methods are thread-safe.
  */
 class TextureHandler {
  private:
+    struct Glyph {
+        GLtexture texture;          // Texture holding the rendered glyph
+        int left, top;              // Offset of the bitmap from the pen position
+        int width, rows;            // Size of the bitmap in pixels
+        int advanceX, advanceY;     // How far to move the pen after drawing the glyph
+    };
+
     typedef std::unordered_map<std::string, GLtexture> TextureMap;
     typedef std::unordered_map<std::string, FT_Face> FontMap;
+    typedef std::map<std::tuple<FT_Face, unsigned int, FT_UInt>, Glyph> GlyphMap;  // (face, size, index) -> glyph
 
     TextureMap loadedTextures;
     FontMap loadedFonts;
+    GlyphMap loadedGlyphs;
     FT_Library fontLibrary;
     FT_Face fontFace;
+    std::mutex handlerMutex;
+
+    static std::shared_future<std::string> defaultFont;    // Path of the default font, found in the background
+    static std::once_flag defaultFontSearch;
+
+    static std::string findDefaultFont();
+    const Glyph* getGlyph(FT_UInt index, unsigned int font_size);
+    bool openFont(const std::string& filename);
 
     static void createGLtextureFromBuffer(GLtexture &texture, unsigned char* buffer, const unsigned int &width,
                                           const unsigned int &height, int glMode);
@@ -71,6 +95,8 @@ class TextureHandler {
     /*!
      * \brief Default TextureHandler constructor method.
      * \details This is the default constructor for theTextureHandler Canvas class.
+     * \details The first TextureHandler starts looking for a default font in the background, so that
+     *   the first call to drawText() without a font doesn't have to.
      * \return A new TextureHandler instance.
      */
     TextureHandler();
@@ -93,6 +119,7 @@ class TextureHandler {
      *   position, and texture coordinates will be left unchanged.
      * \note If no font is loaded before calling this function, TSGL will attempt to locate a
      *   default font at <i>../assets/freefont/FreeMono.ttf.</i>
+     * \note Each glyph is rendered and uploaded the first time it is drawn at a given size, and reused after that.
      * \return True if successful, false otherwise.
      * \bug If the default font cannot be located, TSGL will crash.
      */
@@ -105,6 +132,7 @@ class TextureHandler {
      * \warning If the font cannot be found then an error message is printed out.
      * \warning If the font library is not correctly installed then an error message is printed out.
      * \warning If the font is not supported then an error message is printed out.
+     * \note The font becomes the font used by drawText() for every Canvas using this TextureHandler.
      * \return True if successful, false otherwise.
      */
     bool loadFont(const std::string& filename);
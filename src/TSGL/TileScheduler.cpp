@@ -0,0 +1,241 @@
+#include "TileScheduler.h"
+
+#include <algorithm>    // For clipping tiles to the image
+#include <chrono>       // For the unit tests' uneven work
+#include <thread>       // For the unit tests' uneven work
+#include <vector>       // For the unit tests' pixel counts
+
+namespace tsgl {
+
+TileScheduler::TileScheduler(int width, int height, int tileSize, unsigned threads)
+    : cancelled(false), steals(0) {
+    this->width = std::max(width, 0);
+    this->height = std::max(height, 0);
+    this->tileSize = std::max(tileSize, 1);
+    this->threads = (threads > 0) ? threads : omp_get_num_procs();
+    columns = (this->width + this->tileSize - 1) / this->tileSize;
+    rows = (this->height + this->tileSize - 1) / this->tileSize;
+    progressBar = nullptr;
+    taskQueue = nullptr;
+}
+
+void TileScheduler::cancel() {
+    cancelled = true;
+}
+
+unsigned long TileScheduler::getSteals() const {
+    return steals;
+}
+
+unsigned TileScheduler::getThreads() const {
+    return threads;
+}
+
+Tile TileScheduler::getTile(int index) const {
+    Tile t;
+    t.index = index;
+    t.x = (index % columns) * tileSize;
+    t.y = (index / columns) * tileSize;
+    t.width = std::min(tileSize, width - t.x);
+    t.height = std::min(tileSize, height - t.y);
+    return t;
+}
+
+int TileScheduler::getTileCount() const {
+    return columns * rows;
+}
+
+bool TileScheduler::isCancelled() const {
+    return cancelled;
+}
+
+bool TileScheduler::nextTile(TileQueue queues[], unsigned tid, int& index) {
+    {
+      std::lock_guard<std::mutex> lock(queues[tid].mutex);
+      if (!queues[tid].tiles.empty()) {
+        index = queues[tid].tiles.front();  // Our own tiles, in order
+        queues[tid].tiles.pop_front();
+        return true;
+      }
+    }
+    for (unsigned i = 1; i < threads; ++i) {
+      TileQueue& victim = queues[(tid + i) % threads];
+      std::lock_guard<std::mutex> lock(victim.mutex);
+      if (!victim.tiles.empty()) {
+        index = victim.tiles.back();        // The tile the victim would have gotten to last
+        victim.tiles.pop_back();
+        ++steals;
+        return true;
+      }
+    }
+    return false;                           // Tiles are never added, so there's nothing left anywhere
+}
+
+void TileScheduler::run(std::function<void(const Tile&)> work) {
+    cancelled = false;
+    steals = 0;
+    const int TILES = getTileCount();
+    TileQueue* queues = new TileQueue[threads];
+    for (unsigned t = 0; t < threads; ++t)  // Start each thread off with its own band of tiles
+      for (int i = TILES * t / threads; i < (int)(TILES * (t + 1) / threads); ++i)
+        queues[t].tiles.push_back(i);
+
+    #pragma omp parallel num_threads(threads)
+    {
+      unsigned tid = omp_get_thread_num();  // If OpenMP gave us fewer threads, their tiles get stolen
+      int index, finished = 0;
+      while (!cancelled && nextTile(queues, tid, index)) {
+        if (taskQueue != nullptr)
+          taskQueue->update(index, RUNNING);
+        work(getTile(index));
+        ++finished;
+        if (taskQueue != nullptr)
+          taskQueue->update(index, FINISHED);
+        if (progressBar != nullptr) {
+          int segment = tid % progressBar->getSegs();
+          progressBar->update(TILES * segment / progressBar->getSegs() + finished, segment);
+        }
+      }
+    }
+    delete [] queues;
+}
+
+void TileScheduler::setProgressBar(ProgressBar* bar) {
+    progressBar = bar;
+}
+
+void TileScheduler::setVisualTaskQueue(VisualTaskQueue* queue) {
+    taskQueue = queue;
+}
+
+//-----------------Unit testing-------------------------------------------------------
+void TileScheduler::runTests() {
+    TsglDebug("Testing TileScheduler class...");
+    tsglAssert(testCoverage(), "Unit test for covering the image failed!");
+    tsglAssert(testStealing(), "Unit test for stealing tiles failed!");
+    tsglAssert(testCancel(), "Unit test for cancelling failed!");
+    TsglDebug("Unit tests for TileScheduler complete.");
+    std::cout << std::endl;
+}
+
+bool TileScheduler::testCoverage() {
+    int passed = 0;
+    int failed = 0;
+
+    //Test 1: Every pixel is computed exactly once, including along ragged edges
+    const int W = 100, H = 70;
+    TileScheduler scheduler(W, H, 16, 4);
+    std::vector<std::atomic<int> > counts(W * H);
+    for (int i = 0; i < W * H; ++i)
+      counts[i] = 0;
+    scheduler.run([&counts](const Tile& t) {
+      for (int y = t.y; y < t.y + t.height; ++y)
+        for (int x = t.x; x < t.x + t.width; ++x)
+          ++counts[y * W + x];
+    });
+    bool once = true;
+    for (int i = 0; i < W * H; ++i)
+      once = once && counts[i] == 1;
+    if (once && scheduler.getTileCount() == 7 * 5) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 1, Computing every pixel once for testCoverage() failed!");
+    }
+
+    //Test 2: Edge tiles are clipped to the image
+    Tile last = scheduler.getTile(scheduler.getTileCount() - 1);
+    if (last.x == 96 && last.y == 64 && last.width == 4 && last.height == 6) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 2, Clipping edge tiles for testCoverage() failed!");
+    }
+
+    if(passed == 2 && failed == 0) {
+      TsglDebug("Unit test for covering the image passed!");
+      return true;
+    } else {
+      TsglErr("This many tests for TileScheduler passed: ");
+      std::cout << " " << passed << std::endl;
+      TsglErr("This many tests for TileScheduler failed: ");
+      std::cout << " " << failed << std::endl;
+      return false;
+    }
+}
+
+bool TileScheduler::testStealing() {
+    int passed = 0;
+    int failed = 0;
+
+    //Test 1: When one thread's tiles are slow, the others steal them
+    TileScheduler scheduler(64, 64, 8, 4);
+    std::atomic<int> done(0);
+    const int SLOW = scheduler.getTileCount() / 4;  // The first thread's band
+    scheduler.run([&done, SLOW](const Tile& t) {
+      if (t.index < SLOW)
+        std::this_thread::sleep_for(std::chrono::milliseconds(5));
+      ++done;
+    });
+    if (done == scheduler.getTileCount() && scheduler.getSteals() > 0) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 1, Stealing from a slow thread for testStealing() failed!");
+    }
+
+    if(passed == 1 && failed == 0) {
+      TsglDebug("Unit test for stealing tiles passed!");
+      return true;
+    } else {
+      TsglErr("This many tests for TileScheduler passed: ");
+      std::cout << " " << passed << std::endl;
+      TsglErr("This many tests for TileScheduler failed: ");
+      std::cout << " " << failed << std::endl;
+      return false;
+    }
+}
+
+bool TileScheduler::testCancel() {
+    int passed = 0;
+    int failed = 0;
+
+    //Test 1: Cancelling stops the remaining tiles from being handed out
+    TileScheduler scheduler(256, 256, 8, 2);
+    std::atomic<int> done(0);
+    scheduler.run([&done, &scheduler](const Tile& t) {
+      ++done;
+      scheduler.cancel();
+    });
+    if (scheduler.isCancelled() && done <= (int)scheduler.getThreads()) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 1, Cancelling a run for testCancel() failed!");
+    }
+
+    //Test 2: The next run starts over
+    done = 0;
+    scheduler.run([&done](const Tile& t) {
+      ++done;
+    });
+    if (!scheduler.isCancelled() && done == scheduler.getTileCount()) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 2, Running again after cancelling for testCancel() failed!");
+    }
+
+    if(passed == 2 && failed == 0) {
+      TsglDebug("Unit test for cancelling passed!");
+      return true;
+    } else {
+      TsglErr("This many tests for TileScheduler passed: ");
+      std::cout << " " << passed << std::endl;
+      TsglErr("This many tests for TileScheduler failed: ");
+      std::cout << " " << failed << std::endl;
+      return false;
+    }
+}
+
+}
@@ -0,0 +1,146 @@
+/*
+ * TileScheduler.h provides a work-stealing scheduler for computing an image one tile at a time.
+ */
+
+#ifndef TILESCHEDULER_H_
+#define TILESCHEDULER_H_
+
+#include <atomic>           // For cancelling and counting steals from any thread
+#include <deque>            // For each thread's queue of tiles
+#include <functional>       // For the work to do on each tile
+#include <mutex>            // For guarding each thread's queue
+#include <omp.h>            // For the worker threads
+
+#include "Error.h"          // For unit testing output
+#include "ProgressBar.h"    // For reporting each thread's progress
+#include "TsglAssert.h"     // For unit testing purposes
+#include "VisualTaskQueue.h" // For reporting which tiles are being worked on
+
+namespace tsgl {
+
+/*! \struct Tile
+ *  \brief A rectangle of pixels handed out by a TileScheduler.
+ *  \details Tiles along the right and bottom edges of the image may be smaller than the others.
+ */
+struct Tile {
+    int x, y;               // Pixel coordinates of the tile's top left corner
+    int width, height;      // Size of the tile in pixels
+    int index;              // Position of the tile in row-major order
+};
+
+/*! \class TileScheduler
+ *  \brief Splits an image into small tiles and computes them in parallel with work stealing.
+ *  \details Giving each thread one band of rows, as <code>\#pragma omp parallel</code> loops over rows usually
+ *    do, leaves most threads idle at the end when some parts of an image take much longer than others (for
+ *    example, the inside of a Mandelbrot set).
+ *  \details TileScheduler instead cuts the image into tiles. Each thread starts with a queue holding its own
+ *    band of tiles, which it works through from the front. A thread whose queue runs dry takes tiles from the
+ *    back of another thread's queue, so every thread keeps working until the whole image is done, while
+ *    neighbouring tiles still tend to be computed by the same thread.
+ *  \details A TileScheduler can report its progress to a ProgressBar (one segment per thread) and to a
+ *    VisualTaskQueue (one element per tile).
+ */
+class TileScheduler {
+ private:
+    struct TileQueue {
+      std::mutex      mutex;                        // Guards tiles
+      std::deque<int> tiles;                        // Indices of the tiles left to compute
+    };
+
+    std::atomic<bool>           cancelled;          // Whether run() should stop handing out tiles
+    int                         columns, rows;      // Number of tiles across and down
+    int                         height, width;      // Size of the image in pixels
+    ProgressBar*                progressBar;        // ProgressBar to report to (or nullptr)
+    std::atomic<unsigned long>  steals;             // Number of tiles taken from another thread's queue
+    VisualTaskQueue*            taskQueue;          // VisualTaskQueue to report to (or nullptr)
+    unsigned                    threads;            // Number of threads to run with
+    int                         tileSize;           // Width and height of a full tile in pixels
+
+    bool nextTile(TileQueue queues[], unsigned tid, int& index);  // Pops our own tile or steals one
+
+    static bool testCoverage();
+    static bool testStealing();
+    static bool testCancel();
+ public:
+
+    /*!
+     * \brief Constructs a new TileScheduler.
+     *   \param width The width of the image in pixels.
+     *   \param height The height of the image in pixels.
+     *   \param tileSize The width and height of each tile in pixels (set to 32 by default).
+     *   \param threads The number of threads to compute tiles with
+     *     (set to 0, meaning one per processor, by default).
+     */
+    TileScheduler(int width, int height, int tileSize = 32, unsigned threads = 0);
+
+    /*!
+     * \brief Stops handing out tiles.
+     * \details Tiles that are already being computed are finished, and then run() returns.
+     *   May be called from any thread, including from inside the work passed to run().
+     */
+    void cancel();
+
+    /*!
+     * \brief Accessor for the number of tiles taken from another thread during the last run().
+     * \return The number of tiles that were stolen.
+     */
+    unsigned long getSteals() const;
+
+    /*!
+     * \brief Accessor for the number of threads.
+     * \return The number of threads that run() computes tiles with.
+     */
+    unsigned getThreads() const;
+
+    /*!
+     * \brief Accessor for a tile.
+     *   \param index The tile's position in row-major order.
+     * \return The tile at <code>index</code>.
+     */
+    Tile getTile(int index) const;
+
+    /*!
+     * \brief Accessor for the number of tiles.
+     * \return The number of tiles the image is split into.
+     */
+    int getTileCount() const;
+
+    /*!
+     * \brief Accessor for whether the last run() was cancelled.
+     * \return True if cancel() was called during the last run(), false otherwise.
+     */
+    bool isCancelled() const;
+
+    /*!
+     * \brief Computes every tile.
+     * \details Calls <code>work</code> once for each tile, from getThreads() OpenMP threads, and returns once
+     *   every tile has been computed or cancel() has been called.
+     *   \param work The function to compute a tile with.
+     */
+    void run(std::function<void(const Tile&)> work);
+
+    /*!
+     * \brief Reports each thread's progress to a ProgressBar.
+     *   \param bar The ProgressBar to update as tiles are finished, or nullptr to stop reporting.
+     * \note <code>bar</code> should range from 0 to getTileCount() and have getThreads() segments.
+     *   A thread that steals tiles may finish more than its share of them, which fills its segment.
+     */
+    void setProgressBar(ProgressBar* bar);
+
+    /*!
+     * \brief Reports each tile to a VisualTaskQueue.
+     *   \param queue The VisualTaskQueue whose elements to mark RUNNING and FINISHED as tiles are started and
+     *     finished, or nullptr to stop reporting.
+     * \note <code>queue</code> should have at least getTileCount() elements.
+     */
+    void setVisualTaskQueue(VisualTaskQueue* queue);
+
+    /*!
+     * \brief Runs the Unit tests for TileScheduler.
+     */
+    static void runTests();
+};
+
+}
+
+#endif /* TILESCHEDULER_H_ */
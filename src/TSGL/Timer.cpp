@@ -9,6 +9,18 @@ Timer::Timer(double period) {
 Timer::~Timer() {
 }
 
+// Move on to the next period without sleeping, if the current one has elapsed
+bool Timer::advance() {
+    mutexLock sleepLock(sleep_);
+    timepoint_d now = highResClock::now();
+    if (now < last_time + period_)
+      return false;
+    long long periods = (long long) ((now - last_time) / period_);
+    last_time = last_time + periods * period_;
+    time_between_sleeps = std::chrono::duration_cast<duration_d>(now - last_time).count() + period_.count();
+    return true;
+}
+
 // Get the number of reps since start
 unsigned int Timer::getReps() const {
     return std::chrono::duration_cast<duration_d>(highResClock::now() - start_time).count() / period_.count();
@@ -24,6 +36,12 @@ double Timer::getTimeBetweenSleeps() const {
     return time_between_sleeps;
 }
 
+// Get the time until the current period elapses
+double Timer::getTimeUntilPeriod() {
+    mutexLock sleepLock(sleep_);
+    return std::chrono::duration_cast<duration_d>(last_time + period_ - highResClock::now()).count();
+}
+
 // Check if the timer has elapsed past the point when it last past the period
 bool Timer::pastPeriod() {
     if (last_rep < getReps()) {
@@ -47,6 +47,15 @@ class Timer {
      */
     virtual ~Timer();
 
+    /*!
+     * \brief Moves the Timer on to its next period without sleeping, if the current one has elapsed.
+     * \details This function does the same bookkeeping as sleep(true) when the current period has already
+     *   elapsed, but never blocks. This is useful for servicing several Timers from a single thread.
+     * \return True if the Timer moved on to its next period, false if the current period has not elapsed yet.
+     * \see getTimeUntilPeriod()
+     */
+    bool advance();
+
     /*!
      * \brief Gets the number of repetitions since starting the timer.
      * \return The number of times the <code>period</period> has elapsed since the Timer has been started.
@@ -68,6 +77,14 @@ class Timer {
      */
     double getTimeBetweenSleeps() const;
 
+    /*!
+     * \brief Get the time remaining in the Timer's current period.
+     * \details The current period is the one that sleep(true) would sleep until the end of; it ends one
+     *   period after sleep(true) last returned or advance() last succeeded.
+     * \return The time in seconds until the current period elapses (0 or less if it already has).
+     */
+    double getTimeUntilPeriod();
+
     /*!
      * \brief Check if the Timer's period has elapsed.
      * \details This function returns whether the period of the Timer has elapsed since the last time
@@ -5,11 +5,13 @@
 #ifndef SRC_TSGL_UTIL_H_
 #define SRC_TSGL_UTIL_H_
 
-#include <cmath>  //To determine M_PI and is also used for math operations
+#include <atomic>    //For handing out streams to Random::local()
+#include <cmath>     //To determine M_PI and is also used for math operations
+#include <stdint.h>  //For Random's 64 bit state
 
 namespace tsgl {
 
-class CartesianCanvas;  //Forward declaration for typedef
+template<typename T> class CartesianCanvasT;  //Forward declaration for typedef
 
 //Constants to be used by TSGL classes and tests
 #ifdef _WIN32
@@ -28,7 +30,7 @@ const float FRAME = 1.0f/FPS;      // Number of seconds between frames
  * \note Used by: CartesianCanvas, Function, and IntegralViewer.
  */
 typedef long double Decimal;  // Define the variable type to use for coordinates
-typedef CartesianCanvas Cart; // Shorter name for CartesianCanvas
+typedef CartesianCanvasT<Decimal> Cart; // Shorter name for CartesianCanvas
 
 const int NUM_COLORS = 256, MAX_COLOR = 255;
 
@@ -128,6 +130,206 @@ inline bool fileExists (const std::string& name) {
 	#endif
 }
 
+
+/*!
+ * \class Random
+ * \brief A fast pseudorandom number generator that each thread can own.
+ * \details Random implements xoshiro256** (see http://prng.di.unimi.it/). Unlike rand(), it has no hidden
+ *   global state: each Random is seeded explicitly, so it never locks, and the same seed always produces
+ *   the same numbers.
+ * \details Threads should each use their own Random. Either construct one per thread with the same seed
+ *   and the thread's number as its stream (so the results are reproducible), or call local() for a
+ *   generator private to the calling thread. Streams are 2<sup>128</sup> numbers apart, so they never overlap.
+ * \details fill() generates many numbers at once from Random::LANES interleaved generators, which the
+ *   compiler can keep in SIMD registers. These are separate from the ones next() returns.
+ */
+class Random {
+public:
+  static const int LANES = 4;  // Number of generators fill() steps together
+
+  /*!
+   * \brief Constructs a Random number generator.
+   *   \param seed Any 64 bit number; generators with the same seed and stream produce the same numbers.
+   *   \param stream Which of the seed's independent streams to use (e.g., the thread's number).
+   */
+  explicit Random(uint64_t seed = 0x2545F4914F6CDD1Dull, unsigned stream = 0) {
+    setSeed(seed, stream);
+  }
+
+  /*!
+   * \brief Restarts the generator.
+   *   \param seed Any 64 bit number.
+   *   \param stream Which of the seed's independent streams to use.
+   */
+  void setSeed(uint64_t seed, unsigned stream = 0) {
+    for (int k = 0; k < 4; ++k) {  //SplitMix64 spreads the seed across the state, which must not be all 0
+      uint64_t z = (seed += 0x9E3779B97F4A7C15ull);
+      z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+      z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+      state[k] = z ^ (z >> 31);
+    }
+    for (unsigned i = 0; i < stream; ++i)
+      jump();
+    static const uint64_t LONG_JUMP[4] = { 0x76e15d3efefdcbbfull, 0xc5004e441c522fb3ull,
+                                           0x77710069854ee241ull, 0x39109bb02acbe635ull };
+    uint64_t lane[4] = { state[0], state[1], state[2], state[3] };
+    for (int j = 0; j < LANES; ++j) {  //2^192 apart, so they can't meet any stream's next()
+      jump(lane, LONG_JUMP);
+      for (int k = 0; k < 4; ++k)
+        lanes[k][j] = lane[k];
+    }
+  }
+
+  /*!
+   * \brief Generates 64 random bits.
+   * \return The next number from the generator.
+   */
+  uint64_t next() {
+    return step(state[0], state[1], state[2], state[3]);
+  }
+
+  /*!
+   * \brief Generates a random integer in a range.
+   *   \param min The smallest possible result.
+   *   \param max One more than the largest possible result.
+   * \return A number from <code>min</code> up to, but not including, <code>max</code>.
+   */
+  int nextInt(int min, int max) {
+    return min + (int)(((next() >> 32) * (uint64_t)(uint32_t)(max - min)) >> 32);
+  }
+
+  /*!
+   * \brief Generates a random float.
+   * \return A number from 0 up to, but not including, 1.
+   */
+  float nextFloat() {
+    return (next() >> 40) * (1.0f / 16777216.0f);
+  }
+
+  /*!
+   * \brief Generates a random double.
+   * \return A number from 0 up to, but not including, 1.
+   */
+  double nextDouble() {
+    return (next() >> 11) * (1.0 / 9007199254740992.0);
+  }
+
+  /*!
+   * \brief Skips ahead 2<sup>128</sup> numbers, to the start of the next stream.
+   */
+  void jump() {
+    static const uint64_t JUMP[4] = { 0x180ec6d33cfd0abaull, 0xd5a61266f0c9392cull,
+                                      0xa9582618e03fc9aaull, 0x39abdc4529b1661cull };
+    jump(state, JUMP);
+  }
+
+  /*!
+   * \brief Fills an array with random floats.
+   *   \param n The number of floats to generate.
+   *   \param out Array in which to store them.
+   *   \param min The smallest possible float.
+   *   \param max The largest possible float (which, rounding aside, is never reached).
+   */
+  void fill(int n, float out[], float min = 0.0f, float max = 1.0f) {
+    const float SCALE = (max - min) * (1.0f / 16777216.0f);
+    uint64_t s0[LANES], s1[LANES], s2[LANES], s3[LANES], bits[LANES];
+    loadLanes(s0, s1, s2, s3);
+    for (int i = 0; i < n; i += LANES) {
+      for (int j = 0; j < LANES; ++j)
+        bits[j] = step(s0[j], s1[j], s2[j], s3[j]);
+      for (int j = 0; j < LANES && i + j < n; ++j)
+        out[i + j] = min + (bits[j] >> 40) * SCALE;
+    }
+    storeLanes(s0, s1, s2, s3);
+  }
+
+  /*!
+   * \brief Fills an array with random integers.
+   *   \param n The number of integers to generate.
+   *   \param out Array in which to store them.
+   *   \param min The smallest possible integer.
+   *   \param max One more than the largest possible integer.
+   */
+  void fill(int n, int out[], int min, int max) {
+    const uint64_t RANGE = (uint32_t)(max - min);
+    uint64_t s0[LANES], s1[LANES], s2[LANES], s3[LANES], bits[LANES];
+    loadLanes(s0, s1, s2, s3);
+    for (int i = 0; i < n; i += LANES) {
+      for (int j = 0; j < LANES; ++j)
+        bits[j] = step(s0[j], s1[j], s2[j], s3[j]);
+      for (int j = 0; j < LANES && i + j < n; ++j)
+        out[i + j] = min + (int)(((bits[j] >> 32) * RANGE) >> 32);
+    }
+    storeLanes(s0, s1, s2, s3);
+  }
+
+  /*!
+   * \brief Accessor for the calling thread's own generator.
+   * \details The first call from each thread creates a generator on the next unused stream of the
+   *   default seed, so no two threads share one.
+   * \return A reference to the calling thread's Random.
+   * \note Visual Studio 2012 and 2013 lack thread_local, so there each thread's generator is allocated on
+   *   its first call and never freed.
+   */
+  static Random& local() {
+    static std::atomic<unsigned> streams;  // Zeroed before any thread can call this
+  #if defined(_MSC_VER) && _MSC_VER < 1900
+    static __declspec(thread) Random* generator = nullptr;  // __declspec(thread) only allows plain data
+    if (generator == nullptr)
+      generator = new Random(0x2545F4914F6CDD1Dull, streams++);
+    return *generator;
+  #else
+    static thread_local Random generator(0x2545F4914F6CDD1Dull, streams++);
+    return generator;
+  #endif
+  }
+
+private:
+  uint64_t state[4];
+  uint64_t lanes[4][LANES];  // Word k of lane j is lanes[k][j], so the lanes step in lockstep
+
+  static uint64_t rotl(uint64_t x, int k) {
+    return (x << k) | (x >> (64 - k));
+  }
+
+  static uint64_t step(uint64_t& s0, uint64_t& s1, uint64_t& s2, uint64_t& s3) {
+    const uint64_t result = rotl(s1 * 5, 7) * 9;
+    const uint64_t t = s1 << 17;
+    s2 ^= s0;
+    s3 ^= s1;
+    s1 ^= s2;
+    s0 ^= s3;
+    s2 ^= t;
+    s3 = rotl(s3, 45);
+    return result;
+  }
+
+  //fill() steps local copies of the lanes, so the compiler knows nothing else can change them
+  void loadLanes(uint64_t s0[LANES], uint64_t s1[LANES], uint64_t s2[LANES], uint64_t s3[LANES]) const {
+    for (int j = 0; j < LANES; ++j)
+      s0[j] = lanes[0][j], s1[j] = lanes[1][j], s2[j] = lanes[2][j], s3[j] = lanes[3][j];
+  }
+
+  void storeLanes(const uint64_t s0[LANES], const uint64_t s1[LANES], const uint64_t s2[LANES],
+                  const uint64_t s3[LANES]) {
+    for (int j = 0; j < LANES; ++j)
+      lanes[0][j] = s0[j], lanes[1][j] = s1[j], lanes[2][j] = s2[j], lanes[3][j] = s3[j];
+  }
+
+  static void jump(uint64_t s[4], const uint64_t table[4]) {
+    uint64_t jumped[4] = { 0, 0, 0, 0 };
+    for (int i = 0; i < 4; ++i)
+      for (int b = 0; b < 64; ++b) {
+        if (table[i] & (1ull << b))
+          for (int k = 0; k < 4; ++k)
+            jumped[k] ^= s[k];
+        step(s[0], s[1], s[2], s[3]);
+      }
+    for (int k = 0; k < 4; ++k)
+      s[k] = jumped[k];
+  }
+};
+
 }
 
 #endif /* SRC_TSGL_UTIL_H_ */
@@ -0,0 +1,94 @@
+/*
+ * Vertex.h provides a compact vertex format for streaming large numbers of points to the GPU.
+ */
+
+#ifndef VERTEX_H_
+#define VERTEX_H_
+
+#include <GL/glew.h>    // Needed for GL types
+#include "Color.h"      // Needed for ColorFloat
+#include <cstddef>      // Needed for offsetof()
+#include <cstring>      // Needed for memcpy()
+
+#ifdef __SSE2__
+  #include <emmintrin.h>  // SSE2 intrinsics for packing colors
+#endif
+
+namespace tsgl {
+
+/*! \struct PackedVertex
+ *  \brief A compact 8 byte vertex with 16-bit integer positions and 8-bit normalized colors.
+ *  \details PackedVertex is the default format of the Canvas' point buffer. One vertex consists of
+ *    two signed 16-bit screen coordinates followed by red, green, blue and alpha bytes, which the
+ *    shaders read back as normalized floats (0 - 255 maps to 0.0 - 1.0).
+ *  \details Compared to TSGL's float vertex format (6 floats, 24 bytes per vertex), a PackedVertex
+ *    needs a third of the memory and a third of the bandwidth when uploading to the GPU.
+ *  \note Positions are limited to the range -32768 to 32767, which covers any realistic window.
+ */
+struct PackedVertex {
+    GLshort x, y;           // Screen coordinates of the vertex
+    GLubyte r, g, b, a;     // Normalized color components of the vertex
+};
+
+/*!
+ * \brief Number of floating point values in a vertex of TSGL's float vertex format.
+ */
+const unsigned FLOAT_VERTEX_SIZE = 6;
+
+/*!
+ * \brief Packs a ColorFloat into four normalized bytes.
+ * \details Each component is clamped to the range 0 - 1 and rounded to the nearest of 256 levels.
+ *   Uses SSE2 to convert all four components at once where available.
+ *   \param c The ColorFloat to pack.
+ *   \param dest Pointer to (at least) four bytes to store the red, green, blue and alpha bytes in.
+ */
+inline void packColor(const ColorFloat& c, GLubyte* dest) {
+#ifdef __SSE2__
+    __m128 v = _mm_loadu_ps(&c.R);
+    v = _mm_min_ps(_mm_max_ps(v, _mm_setzero_ps()), _mm_set1_ps(1.0f));
+    v = _mm_add_ps(_mm_mul_ps(v, _mm_set1_ps(255.0f)), _mm_set1_ps(0.5f));
+    __m128i i = _mm_cvttps_epi32(v);
+    i = _mm_packs_epi32(i, i);
+    i = _mm_packus_epi16(i, i);
+    int packed = _mm_cvtsi128_si32(i);
+    memcpy(dest, &packed, 4);
+#else
+    float comp[4] = { c.R, c.G, c.B, c.A };
+    for (int i = 0; i < 4; ++i) {
+        clamp(comp[i], 0.0f, 1.0f);
+        dest[i] = (GLubyte) (comp[i] * 255.0f + 0.5f);
+    }
+#endif
+}
+
+/*!
+ * \brief Packs a single point into a PackedVertex.
+ *   \param x The x coordinate of the point.
+ *   \param y The y coordinate of the point.
+ *   \param c The color of the point.
+ *   \param dest The PackedVertex to fill in.
+ */
+inline void packVertex(int x, int y, const ColorFloat& c, PackedVertex& dest) {
+    dest.x = (GLshort) x;
+    dest.y = (GLshort) y;
+    packColor(c, &dest.r);
+}
+
+/*!
+ * \brief Converts an array of vertices in the float vertex format to PackedVertex.
+ * \details Positions are rounded to the nearest integer, and colors are packed as in packColor().
+ *   \param src Array of <code>n</code> vertices of FLOAT_VERTEX_SIZE floats each.
+ *   \param dest Array of (at least) <code>n</code> PackedVertex to store the results in.
+ *   \param n The number of vertices to convert.
+ */
+inline void packVertices(const float* src, PackedVertex* dest, unsigned n) {
+    for (unsigned i = 0; i < n; ++i, src += FLOAT_VERTEX_SIZE) {
+        dest[i].x = (GLshort) floor(src[0] + 0.5f);
+        dest[i].y = (GLshort) floor(src[1] + 0.5f);
+        packColor(*reinterpret_cast<const ColorFloat*>(src + 2), &dest[i].r);
+    }
+}
+
+}
+
+#endif /* VERTEX_H_ */
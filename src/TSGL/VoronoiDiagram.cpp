@@ -0,0 +1,218 @@
+#include "VoronoiDiagram.h"
+
+#include <algorithm>    // For clamping sites to the grid
+#include <climits>      // For the distance before any site is found
+#include <cmath>        // For sizing the grid cells
+#include "Util.h"       // For the unit tests' random sites
+
+namespace tsgl {
+
+VoronoiDiagram::VoronoiDiagram(int width, int height, unsigned threads) {
+    this->width = std::max(width, 0);
+    this->height = std::max(height, 0);
+    this->threads = (threads > 0) ? threads : omp_get_num_procs();
+    cellSize = 1;
+    columns = rows = 0;
+}
+
+void VoronoiDiagram::buildGrid(int sites, const int x[], const int y[]) {
+    cellSize = std::max(1, (int)std::sqrt((double)width * height / sites));  // About one site per cell
+    columns = (width + cellSize - 1) / cellSize;
+    rows = (height + cellSize - 1) / cellSize;
+    std::vector<int> cellOf(sites);
+    cellStart.assign(columns * rows + 1, 0);
+    for (int k = 0; k < sites; ++k) {  // Sites off the image go in the nearest cell, which only makes them farther
+      int col = std::min(std::max(x[k] / cellSize, 0), columns - 1);
+      int row = std::min(std::max(y[k] / cellSize, 0), rows - 1);
+      cellOf[k] = row * columns + col;
+      ++cellStart[cellOf[k] + 1];
+    }
+    for (int c = 0; c < columns * rows; ++c)
+      cellStart[c + 1] += cellStart[c];
+    cellSites.resize(sites);
+    std::vector<int> next(cellStart.begin(), cellStart.end() - 1);
+    for (int k = 0; k < sites; ++k)  // In order, so each cell's sites stay sorted by index
+      cellSites[next[cellOf[k]]++] = k;
+}
+
+void VoronoiDiagram::compute(int sites, const int x[], const int y[], int nearest[], int second[]) {
+    const int W = width, H = height;
+    if (sites <= 0) {
+      std::fill(nearest, nearest + W * H, -1);
+      if (second != nullptr)
+        std::fill(second, second + W * H, -1);
+      return;
+    }
+    if (W == 0 || H == 0)
+      return;
+    buildGrid(sites, x, y);
+
+    #pragma omp parallel for num_threads(threads) schedule(dynamic, 4)
+    for (int py = 0; py < H; ++py) {
+      const int cy = std::min(py / cellSize, rows - 1);
+      for (int px = 0; px < W; ++px) {
+        const int cx = std::min(px / cellSize, columns - 1);
+        int best = -1, bestD = INT_MAX, next = -1, nextD = INT_MAX;
+        for (int r = 0; ; ++r) {
+          if (r > 0) {  // No site in ring r is closer than the nearest side of it that is on the grid
+            int bound = INT_MAX;
+            if (cx - r >= 0)
+              bound = std::min(bound, px - (cx - r + 1) * cellSize + 1);
+            if (cx + r < columns)
+              bound = std::min(bound, (cx + r) * cellSize - px);
+            if (cy - r >= 0)
+              bound = std::min(bound, py - (cy - r + 1) * cellSize + 1);
+            if (cy + r < rows)
+              bound = std::min(bound, (cy + r) * cellSize - py);
+            if (bound == INT_MAX)  // The ring is off the grid, so every site has been seen
+              break;
+            if (((second != nullptr) ? nextD : bestD) < bound * bound)
+              break;
+          }
+          for (int gy = std::max(cy - r, 0); gy <= std::min(cy + r, rows - 1); ++gy) {
+            bool edge = (gy == cy - r || gy == cy + r);  // Top and bottom of the ring are whole rows of cells
+            int step = (edge || r == 0) ? 1 : 2 * r;
+            for (int gx = cx - r; gx <= cx + r; gx += step) {
+              if (gx < 0 || gx >= columns)
+                continue;
+              const int cell = gy * columns + gx;
+              for (int s = cellStart[cell]; s < cellStart[cell + 1]; ++s) {
+                int k = cellSites[s];
+                int dx = px - x[k], dy = py - y[k];
+                int d = dx * dx + dy * dy;
+                if (d < bestD || (d == bestD && k < best)) {
+                  next = best, nextD = bestD;
+                  best = k, bestD = d;
+                } else if (d < nextD || (d == nextD && k < next)) {
+                  next = k, nextD = d;
+                }
+              }
+            }
+          }
+        }
+        nearest[py * W + px] = best;
+        if (second != nullptr)
+          second[py * W + px] = next;
+      }
+    }
+}
+
+//-----------------Unit testing-------------------------------------------------------
+void VoronoiDiagram::runTests() {
+    TsglDebug("Testing VoronoiDiagram class...");
+    tsglAssert(testAgainstBruteForce(), "Unit test for matching brute force failed!");
+    tsglAssert(testFewSites(), "Unit test for few sites failed!");
+    TsglDebug("Unit tests for VoronoiDiagram complete.");
+    std::cout << std::endl;
+}
+
+bool VoronoiDiagram::testAgainstBruteForce() {
+    int passed = 0;
+    int failed = 0;
+
+    const int W = 97, H = 61, SITES = 300;
+    Random rng(49);
+    int x[SITES], y[SITES];
+    for (int k = 0; k < SITES; ++k) {
+      x[k] = rng.nextInt(0, W);
+      y[k] = rng.nextInt(0, H);
+    }
+    x[7] = x[3], y[7] = y[3];  // A tie, which should go to site 3
+    std::vector<int> nearest(W * H), second(W * H);
+    VoronoiDiagram(W, H, 4).compute(SITES, x, y, nearest.data(), second.data());
+
+    //Test 1: The nearest sites match checking every site
+    //Test 2: So do the second-nearest
+    bool sameNearest = true, sameSecond = true;
+    for (int py = 0; py < H; ++py) {
+      for (int px = 0; px < W; ++px) {
+        int best = -1, bestD = INT_MAX, next = -1, nextD = INT_MAX;
+        for (int k = 0; k < SITES; ++k) {
+          int d = (px - x[k]) * (px - x[k]) + (py - y[k]) * (py - y[k]);
+          if (d < bestD) {
+            next = best, nextD = bestD;
+            best = k, bestD = d;
+          } else if (d < nextD) {
+            next = k, nextD = d;
+          }
+        }
+        sameNearest = sameNearest && nearest[py * W + px] == best;
+        sameSecond = sameSecond && second[py * W + px] == next;
+      }
+    }
+    if (sameNearest && nearest[y[3] * W + x[3]] == 3) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 1, Finding the nearest sites for testAgainstBruteForce() failed!");
+    }
+    if (sameSecond && second[y[3] * W + x[3]] == 7) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 2, Finding the second-nearest sites for testAgainstBruteForce() failed!");
+    }
+
+    if(passed == 2 && failed == 0) {
+      TsglDebug("Unit test for matching brute force passed!");
+      return true;
+    } else {
+      TsglErr("This many tests for VoronoiDiagram passed: ");
+      std::cout << " " << passed << std::endl;
+      TsglErr("This many tests for VoronoiDiagram failed: ");
+      std::cout << " " << failed << std::endl;
+      return false;
+    }
+}
+
+bool VoronoiDiagram::testFewSites() {
+    int passed = 0;
+    int failed = 0;
+
+    const int W = 40, H = 30;
+    std::vector<int> nearest(W * H), second(W * H);
+    VoronoiDiagram voronoi(W, H);
+
+    //Test 1: With no sites, no pixel has a nearest site
+    voronoi.compute(0, nullptr, nullptr, nearest.data(), second.data());
+    if (std::count(nearest.begin(), nearest.end(), -1) == W * H &&
+        std::count(second.begin(), second.end(), -1) == W * H) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 1, Computing without sites for testFewSites() failed!");
+    }
+
+    //Test 2: With one site, even off the image, it is nearest to every pixel and there is no second
+    int x[2] = { -5, 39 }, y[2] = { 35, 0 };
+    voronoi.compute(1, x, y, nearest.data(), second.data());
+    if (std::count(nearest.begin(), nearest.end(), 0) == W * H &&
+        std::count(second.begin(), second.end(), -1) == W * H) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 2, Computing with one site for testFewSites() failed!");
+    }
+
+    //Test 3: With two sites, whichever isn't nearest is second
+    voronoi.compute(2, x, y, nearest.data(), second.data());
+    if (nearest[W - 1] == 1 && second[W - 1] == 0 && nearest[(H - 1) * W] == 0 && second[(H - 1) * W] == 1) {
+      passed++;
+    } else {
+      failed++;
+      TsglErr("Test 3, Computing with two sites for testFewSites() failed!");
+    }
+
+    if(passed == 3 && failed == 0) {
+      TsglDebug("Unit test for few sites passed!");
+      return true;
+    } else {
+      TsglErr("This many tests for VoronoiDiagram passed: ");
+      std::cout << " " << passed << std::endl;
+      TsglErr("This many tests for VoronoiDiagram failed: ");
+      std::cout << " " << failed << std::endl;
+      return false;
+    }
+}
+
+}
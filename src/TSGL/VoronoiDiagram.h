@@ -0,0 +1,85 @@
+/*
+ * VoronoiDiagram.h provides a fast nearest-site search for drawing Voronoi diagrams.
+ */
+
+#ifndef VORONOIDIAGRAM_H_
+#define VORONOIDIAGRAM_H_
+
+#include <omp.h>            // For computing rows in parallel
+#include <vector>           // For the grid of sites
+
+#include "Error.h"          // For unit testing output
+#include "TsglAssert.h"     // For unit testing purposes
+
+namespace tsgl {
+
+/*! \class VoronoiDiagram
+ *  \brief Finds the nearest and second-nearest of a set of sites to every pixel of an image.
+ *  \details Rather than measuring the distance from every pixel to every site, VoronoiDiagram sorts the
+ *    sites into a grid of square cells, sized so that each cell holds about one site. Each pixel then searches
+ *    outward from its own cell a ring of cells at a time, and stops as soon as the nearest edge of the next
+ *    ring is farther away than what it has already found. Since that is usually only a ring or two, the time
+ *    taken hardly depends on the number of sites.
+ *  \details Rows of pixels are split among the threads and computed left to right, so the results are written
+ *    in order, one row after another.
+ *  \details Distances are Euclidean. Ties go to the site with the lower index, so the results are exactly those
+ *    of checking every site.
+ *  \see http://en.wikipedia.org/wiki/Voronoi_diagram
+ */
+class VoronoiDiagram {
+ private:
+    std::vector<int>    cellStart;          // Index into cellSites of each cell's first site
+    std::vector<int>    cellSites;          // Indices of the sites, sorted by cell
+    int                 cellSize;           // Width and height of a grid cell in pixels
+    int                 columns, rows;      // Number of grid cells across and down
+    int                 height, width;      // Size of the image in pixels
+    unsigned            threads;            // Number of threads to run with
+
+    void buildGrid(int sites, const int x[], const int y[]);
+
+    static bool testAgainstBruteForce();
+    static bool testFewSites();
+ public:
+
+    /*!
+     * \brief Constructs a new VoronoiDiagram.
+     *   \param width The width of the images to compute, in pixels.
+     *   \param height The height of the images to compute, in pixels.
+     *   \param threads The number of threads to use (0, the default, uses as many as there are processors).
+     */
+    VoronoiDiagram(int width, int height, unsigned threads = 0);
+
+    /*!
+     * \brief Finds the nearest and (optionally) second-nearest site to every pixel.
+     *   \param sites The number of sites.
+     *   \param x Array of the sites' x-coordinates, in pixels.
+     *   \param y Array of the sites' y-coordinates, in pixels.
+     *   \param nearest Array of <code>width * height</code> ints, one row after another, in which to store the
+     *     index of the site nearest each pixel.
+     *   \param second Array of <code>width * height</code> ints in which to store the index of the site second
+     *     nearest each pixel, or nullptr (the default) to skip finding them.
+     * \note With no sites, every pixel is given -1. With one site, every pixel's second-nearest site is -1.
+     */
+    void compute(int sites, const int x[], const int y[], int nearest[], int second[] = nullptr);
+
+    /*!
+     * \brief Accessor for the height of the images to compute.
+     * \return The height in pixels.
+     */
+    int getHeight() { return height; }
+
+    /*!
+     * \brief Accessor for the width of the images to compute.
+     * \return The width in pixels.
+     */
+    int getWidth() { return width; }
+
+    /*!
+     * \brief Runs the Unit tests for VoronoiDiagram.
+     */
+    static void runTests();
+};
+
+}
+
+#endif /* VORONOIDIAGRAM_H_ */
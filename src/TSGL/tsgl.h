@@ -9,15 +9,23 @@
 	#define _CRT_SECURE_NO_DEPRECATE //To avoid issues with fopen, http://stackoverflow.com/questions/14386/fopen-deprecated-warning
 #endif
 
+#include "CachedFunction.h"
 #include "Canvas.h"
 #include "CartesianCanvas.h"
 #include "Color.h"
+#include "DistanceTransform.h"
 #include "Error.h"
+#include "Expression.h"
+#include "FrameBarrier.h"
+#include "InputQueue.h"
 #include "IntegralViewer.h"
 #include "Keynums.h"
+#include "RenderHub.h"
 #include "Spectrogram.h"
+#include "TileScheduler.h"
 #include "Timer.h"
 #include "Util.h"
 #include "VisualTaskQueue.h"
+#include "VoronoiDiagram.h"
 
 #endif /* TSGL_H_ */
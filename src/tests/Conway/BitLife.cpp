@@ -0,0 +1,193 @@
+/*
+ * BitLife.cpp
+ */
+
+#include "BitLife.h"
+
+BitLife::BitLife(int width, int height, unsigned threads) {
+  myWidth = std::max(width, 1);
+  myHeight = std::max(height, 1);
+  myWords = (myWidth + 63) / 64;
+  myThreads = (threads > 0) ? threads : omp_get_num_procs();
+  myCells.assign(myWords * myHeight, 0);
+  myNext.assign(myWords * myHeight, 0);
+  myPixels.resize(myWidth * myHeight);
+}
+
+int BitLife::countBits(uint64_t word) {
+  word = word - ((word >> 1) & 0x5555555555555555ull);  // Add up pairs of bits, then nibbles, then bytes
+  word = (word & 0x3333333333333333ull) + ((word >> 2) & 0x3333333333333333ull);
+  word = (word + (word >> 4)) & 0x0f0f0f0f0f0f0f0full;
+  return (int)((word * 0x0101010101010101ull) >> 56);
+}
+
+void BitLife::shiftRow(const uint64_t row[], uint64_t west[], uint64_t east[]) const {
+  const int LAST = myWords - 1, LAST_BIT = (myWidth - 1) % 64;  // The row wraps around from LAST_BIT of LAST
+  west[0] = (row[0] << 1) | ((row[LAST] >> LAST_BIT) & 1);
+  for (int w = 1; w <= LAST; ++w)
+    west[w] = (row[w] << 1) | (row[w - 1] >> 63);
+  for (int w = 0; w < LAST; ++w)
+    east[w] = (row[w] >> 1) | (row[w + 1] << 63);
+  east[LAST] = (row[LAST] >> 1) | ((row[0] & 1) << LAST_BIT);
+}
+
+void BitLife::clear(const ColorFloat& dead) {
+  std::fill(myCells.begin(), myCells.end(), 0);
+  std::fill(myPixels.begin(), myPixels.end(), dead);
+}
+
+bool BitLife::get(int x, int y) const {
+  return (myCells[y * myWords + x / 64] >> (x % 64)) & 1;
+}
+
+const ColorFloat* BitLife::getPixels() const {
+  return myPixels.data();
+}
+
+void BitLife::set(int x, int y, bool alive, const ColorFloat& color) {
+  if (x < 0 || x >= myWidth || y < 0 || y >= myHeight)
+    return;
+  uint64_t& word = myCells[y * myWords + x / 64];
+  uint64_t bit = 1ull << (x % 64);
+  word = alive ? (word | bit) : (word & ~bit);
+  myPixels[y * myWidth + x] = color;
+}
+
+unsigned long BitLife::step(const ColorFloat& born, const ColorFloat& died) {
+  const int W = myWidth, H = myHeight, WORDS = myWords;
+  const uint64_t LAST_MASK = ~0ull >> (63 - (W - 1) % 64);  // Bits of the last word that are on the board
+  unsigned long population = 0;
+  #pragma omp parallel num_threads(myThreads) reduction(+:population)
+  {
+    int tid = omp_get_thread_num(), nthreads = omp_get_num_threads();
+    int top = H * tid / nthreads, bottom = H * (tid + 1) / nthreads;
+    std::vector<uint64_t> shifted(6 * WORDS);  // West and east shifts of the rows above, at and below y
+    uint64_t *west[3], *east[3];
+    for (int k = 0; k < 3; ++k) {
+      west[k] = &shifted[2 * k * WORDS];
+      east[k] = west[k] + WORDS;
+    }
+    if (top < bottom) {
+      shiftRow(&myCells[((top + H - 1) % H) * WORDS], west[0], east[0]);  // The halo row above the stripe
+      shiftRow(&myCells[top * WORDS], west[1], east[1]);
+    }
+    for (int y = top; y < bottom; ++y) {
+      const uint64_t* up = &myCells[((y + H - 1) % H) * WORDS];
+      const uint64_t* mid = &myCells[y * WORDS];
+      const uint64_t* down = &myCells[((y + 1) % H) * WORDS];  // The halo row below, for the stripe's last row
+      shiftRow(down, west[2], east[2]);
+      const uint64_t *upWest = west[0], *upEast = east[0], *midWest = west[1], *midEast = east[1];
+      const uint64_t *downWest = west[2], *downEast = east[2];
+      uint64_t* out = &myNext[y * WORDS];
+      for (int w = 0; w < WORDS; ++w) {
+        //Add the three neighbors above, and the three below, into ones and twos
+        uint64_t a = upWest[w], b = up[w], c = upEast[w];
+        uint64_t upOnes = a ^ b ^ c, upTwos = (a & b) | (c & (a ^ b));
+        a = downWest[w], b = down[w], c = downEast[w];
+        uint64_t downOnes = a ^ b ^ c, downTwos = (a & b) | (c & (a ^ b));
+        uint64_t midOnes = midWest[w] ^ midEast[w], midTwos = midWest[w] & midEast[w];
+        //Add the ones; the count is 2 or 3 exactly when one of the twos (with the carry) is set
+        uint64_t ones = upOnes ^ downOnes ^ midOnes;
+        uint64_t carry = (upOnes & downOnes) | (midOnes & (upOnes ^ downOnes));
+        uint64_t oneTwo = (upTwos ^ downTwos ^ midTwos ^ carry) & ~((upTwos & downTwos) | (midTwos & carry));
+        out[w] = oneTwo & (ones | mid[w]);  // Born with 3 neighbors, survives with 2 or 3
+      }
+      out[WORDS - 1] &= LAST_MASK;
+      uint64_t* t = west[0];  // Slide the window of shifted rows down one row
+      west[0] = west[1], west[1] = west[2], west[2] = t;
+      t = east[0];
+      east[0] = east[1], east[1] = east[2], east[2] = t;
+
+      ColorFloat* pixels = &myPixels[y * W];
+      for (int w = 0; w < WORDS; ++w) {
+        uint64_t now = out[w], changed = now ^ mid[w];
+        population += countBits(now);
+        for (int x = w * 64; changed != 0; ++x, changed >>= 1, now >>= 1)
+          if (changed & 1)
+            pixels[x] = (now & 1) ? born : died;
+      }
+    }
+  }
+  myCells.swap(myNext);
+  return population;
+}
+
+//-----------------Unit testing-------------------------------------------------------
+void BitLife::runTests() {
+  TsglDebug("Testing BitLife class...");
+  tsglAssert(testAgainstNaive(), "Unit test for matching naive Life failed!");
+  TsglDebug("Unit tests for BitLife complete.");
+  std::cout << std::endl;
+}
+
+bool BitLife::testAgainstNaive() {
+  int passed = 0;
+  int failed = 0;
+
+  //Boards a word wide, just under and over, and several words with a partial last word (the LAST_MASK path),
+  //and boards shorter than the number of threads, so some stripes are empty and others are one row
+  const int WIDTHS[] = { 1, 2, 63, 64, 65, 100, 130, 200 }, HEIGHTS[] = { 1, 2, 5, 17, 40 };
+  const int BOARDS = 400, GENERATIONS = 4;
+  const ColorFloat ALIVE = WHITE, DEAD = BLACK;
+  Random rng(50);
+  bool sameCells = true, samePixels = true;
+  for (int b = 0; b < BOARDS; ++b) {
+    const int W = WIDTHS[b % 8], H = HEIGHTS[(b / 8) % 5];
+    BitLife board(W, H, 3);
+    std::vector<char> cells(W * H), next(W * H);
+    int density = rng.nextInt(5, 60);
+    board.clear(DEAD);
+    for (int i = 0; i < W * H; ++i) {
+      cells[i] = rng.nextInt(0, 100) < density;
+      board.set(i % W, i / W, cells[i], cells[i] ? ALIVE : DEAD);
+    }
+    for (int g = 0; g < GENERATIONS; ++g) {
+      unsigned long population = 0;
+      for (int y = 0; y < H; ++y) {
+        for (int x = 0; x < W; ++x) {
+          int neighbors = 0;  //Counted the slow way, wrapping around every edge
+          for (int dy = -1; dy <= 1; ++dy)
+            for (int dx = -1; dx <= 1; ++dx)
+              if (dx != 0 || dy != 0)
+                neighbors += cells[((y + dy + H) % H) * W + (x + dx + W) % W];
+          next[y * W + x] = neighbors == 3 || (neighbors == 2 && cells[y * W + x]);
+          population += next[y * W + x];
+        }
+      }
+      cells.swap(next);
+      sameCells = sameCells && board.step(ALIVE, DEAD) == population;
+      for (int i = 0; i < W * H; ++i) {
+        sameCells = sameCells && board.get(i % W, i / W) == (cells[i] != 0);
+        ColorFloat pixel = board.getPixels()[i], expected = cells[i] ? ALIVE : DEAD;
+        samePixels = samePixels && pixel == expected;
+      }
+    }
+  }
+
+  //Test 1: Every cell, and the population, match the rules applied one cell at a time
+  if (sameCells) {
+    passed++;
+  } else {
+    failed++;
+    TsglErr("Test 1, Matching naive Life for testAgainstNaive() failed!");
+  }
+
+  //Test 2: The pixels that changed were recolored, and only those
+  if (samePixels) {
+    passed++;
+  } else {
+    failed++;
+    TsglErr("Test 2, Coloring changed cells for testAgainstNaive() failed!");
+  }
+
+  if(passed == 2 && failed == 0) {
+    TsglDebug("Unit test for matching naive Life passed!");
+    return true;
+  } else {
+    TsglErr("This many tests for BitLife passed: ");
+    std::cout << " " << passed << std::endl;
+    TsglErr("This many tests for BitLife failed: ");
+    std::cout << " " << failed << std::endl;
+    return false;
+  }
+}
@@ -0,0 +1,102 @@
+/*
+ * BitLife.h
+ */
+
+#ifndef BITLIFE_H_
+#define BITLIFE_H_
+
+#include <omp.h>
+#include <stdint.h>
+#include <tsgl.h>
+#include <vector>
+
+using namespace tsgl;
+
+/*!
+ * \class BitLife
+ * \brief A dense Game of Life board that stores each cell as a single bit.
+ * \details Each row is packed into 64 bit words, with cell x in bit (x % 64) of word (x / 64). A generation
+ *   is computed a whole word of cells at a time:
+ *   - Each row's words are shifted one cell west and one cell east, so that every neighbor of a word's
+ *     cells lines up with it in one of eight words.
+ *   - The eight neighbors are added with bit-sliced adders: bitwise full adders that count the neighbors of
+ *     all 64 cells at once, with each bit of the counts kept in a separate word.
+ *   - The rules are then a few more bitwise operations on those counts.
+ *   .
+ *   The adders are plain loops over the words of a row, which the compiler can vectorize.
+ * \details The rows are split into one stripe per thread. Besides its own rows, each thread reads the halo
+ *   rows just above and below its stripe, and keeps the shifted words of the last three rows it read, so
+ *   every row is shifted only once per stripe.
+ * \details The board wraps around at the edges. Alongside the bits, BitLife keeps a buffer of each cell's
+ *   color, and updates it only where the words of cells changed.
+ * \see LifeFarm class
+ */
+class BitLife {
+private:
+  int myWidth, myHeight;
+  int myWords;                        // Words per row
+  unsigned myThreads;
+  std::vector<uint64_t> myCells, myNext;
+  std::vector<ColorFloat> myPixels;   // Color of each cell, one row after another
+
+  void shiftRow(const uint64_t row[], uint64_t west[], uint64_t east[]) const;
+  static int countBits(uint64_t word);
+
+  static bool testAgainstNaive();
+public:
+
+  /*!
+   * \brief Explicitly constructs a BitLife board, with every cell dead.
+   *    \param width The width of the board in cells.
+   *    \param height The height of the board in cells.
+   *    \param threads The number of threads to use (0, the default, uses as many as there are processors).
+   * \return The constructed BitLife board.
+   */
+  BitLife(int width, int height, unsigned threads = 0);
+
+  /*!
+   * \brief Kills every cell.
+   *    \param dead The color to give every cell.
+   */
+  void clear(const ColorFloat& dead);
+
+  /*!
+   * \brief Accessor for a cell.
+   *    \param x The column of the cell.
+   *    \param y The row of the cell.
+   * \return Whether the cell is alive.
+   */
+  bool get(int x, int y) const;
+
+  /*!
+   * \brief Accessor for the colors of the cells.
+   * \return An array of <code>width * height</code> colors, one row after another, ready for
+   *   Canvas::drawRaster().
+   */
+  const ColorFloat* getPixels() const;
+
+  /*!
+   * \brief Brings a cell to life or kills it.
+   * \details Cells off the board are ignored.
+   *    \param x The column of the cell.
+   *    \param y The row of the cell.
+   *    \param alive Whether the cell should be alive.
+   *    \param color The color to give the cell.
+   */
+  void set(int x, int y, bool alive, const ColorFloat& color);
+
+  /*!
+   * \brief Computes the next generation.
+   *    \param born The color to give cells that come to life.
+   *    \param died The color to give cells that die.
+   * \return The number of cells alive in the new generation.
+   */
+  unsigned long step(const ColorFloat& born, const ColorFloat& died);
+
+  /*!
+   * \brief Runs the Unit tests for BitLife.
+   */
+  static void runTests();
+};
+
+#endif /* BITLIFE_H_ */
@@ -4,7 +4,8 @@
 
 #include "LifeFarm.h"
 
-LifeFarm::LifeFarm(int w, int h, Canvas* c, bool randomize) {
+LifeFarm::LifeFarm(int w, int h, Canvas* c, bool randomize) : bits(w, h) {
+  usingBits = false;
   framecount = 0;
   listend = 0;
   width = w;
@@ -156,17 +157,20 @@ LifeFarm::~LifeFarm() {
 }
 
 void LifeFarm::addAnt(int x, int y) {
+  if (usingBits) {
+    bits.set(x, y, true, frameColor());
+    return;
+  }
   livelist[listend++] = y*width+x;
   alive[y][x] = true;
 }
 
-void LifeFarm::moveAnts() {
-  moveAntsOld();
-//  moveAntsNew();
+void LifeFarm::draw() {
+  if (usingBits)
+    can->drawRaster(0, 0, width, height, bits.getPixels());
 }
 
-void LifeFarm::moveAntsOld() {
-  //Compute this frame's color
+ColorFloat LifeFarm::frameColor() {
   const int P1 = 7, P2 = 11, P3 = 17;
  // std::cout << ++framecount << std::endl;
   int r = (framecount*P1/50 % 255);
@@ -175,7 +179,25 @@ void LifeFarm::moveAntsOld() {
   if (g < 128)  g = 255 - g;
   int b = (framecount*P3/50 % 255);
   if (b < 128)  b = 255 - b;
-  ColorFloat fcolor = ColorInt(r,g,b,255);
+  return ColorInt(r,g,b,255);
+}
+
+void LifeFarm::moveAnts() {
+  if (usingBits) {
+    unsigned long population = bits.step(frameColor(), bgcolor);
+    if (population < (unsigned long)size / 256)
+      switchToList();
+  } else {
+    moveAntsOld();
+//    moveAntsNew();
+    if (listend > size / 64)
+      switchToBits();
+  }
+}
+
+void LifeFarm::moveAntsOld() {
+  //Compute this frame's color
+  ColorFloat fcolor = frameColor();
 
   //Clear the each cell's neighbor list
   for (int i = 0; i < height; ++i)
@@ -241,6 +263,26 @@ void LifeFarm::moveAntsNew() {
   return;
 }
 
+void LifeFarm::switchToBits() {
+  bits.clear(bgcolor);
+  ColorFloat fcolor = frameColor();
+  for (int i = 0; i < listend; ++i)
+    bits.set(livelist[i] % width, livelist[i] / width, true, fcolor);
+  usingBits = true;
+}
+
+void LifeFarm::switchToList() {
+  usingBits = false;
+  listend = 0;
+  for (int row = 0; row < height; ++row) {
+    for (int col = 0; col < width; ++col) {
+      alive[row][col] = false;
+      if (bits.get(col, row))
+        addAnt(col, row);
+    }
+  }
+}
+
 void LifeFarm::setDrawdead(bool b) {
   drawdead = b;
 }
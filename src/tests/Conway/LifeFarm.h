@@ -8,6 +8,8 @@
 #include <tsgl.h>
 #include <omp.h>
 
+#include "BitLife.h"
+
 using namespace tsgl;
 
 /*!
@@ -15,6 +17,13 @@ using namespace tsgl;
  * \brief Simulate Conway's Game of Life!
  * \details Contains the data and methods needed in order to simulate Conway's Game of Life.
  * \details see https://en.wikipedia.org/wiki/Conway's_Game_of_Life for more details on what Conway's Game of Life is.
+ * \details LifeFarm has two engines, and switches between them by how many cells are alive:
+ *   - While fewer than 1 in 64 cells are alive, it keeps a list of the living cells, and draws each cell
+ *     that changes as a point.
+ *   - Above that, it moves onto a BitLife board, which computes 64 cells at a time on all the processors
+ *     and keeps the colors of the cells in a buffer, which draw() puts on the Canvas all at once.
+ *     It moves back onto the list once fewer than 1 in 256 cells are alive.
+ *   .
  */
 class LifeFarm {
 private:
@@ -30,6 +39,13 @@ private:
 
     int *currentstate, *nextstate;
     int *currentstart, *nextstart;
+
+    BitLife bits;
+    bool usingBits;
+
+    ColorFloat frameColor();
+    void switchToBits();
+    void switchToList();
 public:
     int width, height, size;
     Canvas* can;
@@ -59,10 +75,17 @@ public:
      */
     void addAnt(int x, int y);
 
+    /*!
+     * \brief Draws the board.
+     * \details While the BitLife engine is running, draws every cell onto the Canvas at once.
+     *   While the list engine is running, cells are drawn as they change, so this does nothing.
+     */
+    void draw();
+
     /*!
      * \brief Move the ants.
-     * \details Move the ants that are currently in the LifeFarm object.
-     * \note This method class moveAntsOld().
+     * \details Move the ants that are currently in the LifeFarm object, by one generation.
+     * \note This method calls moveAntsOld() while few cells are alive, and BitLife::step() otherwise.
      * \see moveAntsOld()
      */
     void moveAnts();
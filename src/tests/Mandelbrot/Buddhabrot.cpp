@@ -4,106 +4,122 @@
 
 #include "Buddhabrot.h"
 
-#ifdef _WIN32 //Windows doesn't like numbers higher than RAND_MAX (32767)
-  #define rand() (rand() | rand() << 16)
-#endif
-
 Buddhabrot::Buddhabrot(unsigned threads, unsigned depth = 1000) : Mandelbrot(threads, depth) {
-  counter = nullptr;
   cww = cwh = 0;
 }
 
-Buddhabrot::~Buddhabrot() {
-  for (int i = 0; i < cwh; ++i)
-    delete [] counter[i];
-  delete[] counter;
-  counter = nullptr;
+uint64_t Buddhabrot::randomBits(uint64_t sample, uint64_t stream) {
+  //SplitMix64's mixing function applied to a counter: the same sample always gets the same bits,
+  //and no thread has any state to share or lock
+  uint64_t z = (sample * 2 + stream + 1) * 0x9E3779B97F4A7C15ull;
+  z = (z ^ (z >> 30)) * 0xBF58476D1CE4E5B9ull;
+  z = (z ^ (z >> 27)) * 0x94D049BB133111EBull;
+  return z ^ (z >> 31);
+}
+
+void Buddhabrot::drawHistograms(Cart& can) {
+  const int THREADS = myHistograms.size();
+  std::vector<ColorFloat> tcolors(THREADS);
+  for (int t = 0; t < THREADS; ++t)
+    tcolors[t] = Colors::highContrastColor(t);
+  unsigned maxCount = 1;
+  #pragma omp parallel num_threads(myThreads)
+  {
+    unsigned myMax = 0;
+    #pragma omp for
+    for (int i = 0; i < cww * cwh; ++i) {
+      unsigned count = 0;
+      for (int t = 0; t < THREADS; ++t)
+        count += myHistograms[t][i];
+      if (count > myMax)
+        myMax = count;
+    }
+    #pragma omp critical
+    if (myMax > maxCount)
+      maxCount = myMax;
+  }
+  std::vector<ColorFloat> colors(cww * cwh);
+  #pragma omp parallel for num_threads(myThreads)
+  for (int i = 0; i < cww * cwh; ++i) {
+    float r = 0, g = 0, b = 0;
+    unsigned count = 0;
+    for (int t = 0; t < THREADS; ++t) {  //Blend the colors of the threads whose orbits passed through here
+      unsigned n = myHistograms[t][i];
+      r += n * tcolors[t].R, g += n * tcolors[t].G, b += n * tcolors[t].B;
+      count += n;
+    }
+    if (count == 0) {
+      colors[i] = BLACK;
+    } else {
+      float normalize = sqrt((float)count/maxCount) / count;
+      colors[i] = ColorFloat(r * normalize, g * normalize, b * normalize, 1.0f);
+    }
+  }
+  can.drawRaster(0, 0, cww, cwh, colors.data());  //One update for the whole screen
+  std::cout << maxCount << " max iterations" << std::endl;
 }
 
 void Buddhabrot::draw(Cart& can) {
   cww = can.getWindowWidth(), cwh = can.getWindowHeight();
   const unsigned long MAXITS = cww*cwh*10;
-  ColorFloat tcolor(1.0f,1.0f,1.0f,0.1f);
-  const int RPREC = 100000;
-  counter = new int*[cwh];
-  for (int i = 0; i < cwh; ++i)
-    counter[i] = new int[cww];
+  const int PREVIEWS = 10;
+  const double UNIT = 1.0 / 9007199254740992.0;  //2^-53, to turn 53 random bits into [0,1)
+  myHistograms.assign(myThreads, std::vector<unsigned>(cww * cwh));
   while (myRedraw) {
     myRedraw = false;
     can.clear();
-    for (int i = 0; i < cwh; ++i)
-      for (int j = 0; j < cww; ++j)
-        counter[i][j] = 0;
+    for (unsigned t = 0; t < myHistograms.size(); ++t)
+      std::fill(myHistograms[t].begin(), myHistograms[t].end(), 0);
     const Decimal cph = can.getPixelHeight(), cpw = can.getPixelWidth(),
       cMinx = can.getMinX(), cMiny = can.getMinY(),
       cMaxx = cMinx+cpw*(cww-1), cMaxy = cMiny+cph*(cwh-1);
-    unsigned long cycles = 0;
-    #pragma omp parallel num_threads(myThreads)
-    {
-      unsigned tid = omp_get_thread_num(), threads = omp_get_num_threads();
-      Decimal offset = cMiny+(cph*cwh*tid)/(Decimal)threads;
-      const Decimal wscale = (cpw*cww)/(Decimal)RPREC;
-      const Decimal hscale = (cph*cwh/threads)/(Decimal)RPREC;
-      ColorFloat tc = Colors::highContrastColor(tid);
-      ColorFloat tcolor(tc.R,tc.G,tc.B,0.1f);
-      complex* znums = new complex[myDepth];
-      Decimal col, row;
-      for (unsigned long i = tid; i < MAXITS; i+= threads) {
-        if (myRedraw) break;
-        col = cMinx+wscale*(rand() % RPREC);    //Between cMinx and cMaxx
-        row = offset+hscale*(rand() % RPREC);    //Between cMiny and cMaxy
-        complex c(col,row);
-        complex z = c;
-        unsigned its = 0;
-        while (std::abs(z) < 2.0l && its != myDepth) {
-          z = z * z + c;
-          znums[its] = z;
-          ++its;
-        }
-        if (its < myDepth) {  //If we're not in the Mandelbrot set
-          z = c;
-          while (its > 0) {
-            --its;
-            if (znums[its].imag() < cMiny || znums[its].imag() > cMaxy ||
-             znums[its].real() < cMinx || znums[its].real() > cMaxx)
-              continue;
-            int boxY = (znums[its].imag()-cMiny)/cph;
-            int boxX = (znums[its].real()-cMinx)/cpw;
-            #pragma omp atomic
-              ++(counter[boxY][boxX]);
-            can.Canvas::drawPixel(boxY, boxX, tcolor);
+    for (int round = 0; round < PREVIEWS && !myRedraw && can.isOpen(); ++round) {
+      const unsigned long FIRST = MAXITS * round / PREVIEWS, LAST = MAXITS * (round + 1) / PREVIEWS;
+      #pragma omp parallel num_threads(myThreads)
+      {
+        unsigned tid = omp_get_thread_num(), threads = omp_get_num_threads();
+        Decimal offset = cMiny+(cph*cwh*tid)/(Decimal)threads;
+        const Decimal wscale = cpw*cww;
+        const Decimal hscale = cph*cwh/threads;
+        unsigned* counter = myHistograms[tid].data();
+        complex* znums = new complex[myDepth];
+        Decimal col, row;
+        for (unsigned long i = FIRST + (threads + tid - FIRST % threads) % threads; i < LAST; i += threads) {
+          col = cMinx+wscale*((randomBits(i, 0) >> 11) * UNIT);    //Between cMinx and cMaxx
+          row = offset+hscale*((randomBits(i, 1) >> 11) * UNIT);   //Between cMiny and cMaxy
+          complex c(col,row);
+          complex z = c;
+          unsigned its = 0;
+          while (std::abs(z) < 2.0l && its != myDepth) {
+            z = z * z + c;
+            znums[its] = z;
+            ++its;
           }
+          if (its < myDepth) {  //If we're not in the Mandelbrot set
+            while (its > 0) {
+              --its;
+              if (znums[its].imag() < cMiny || znums[its].imag() > cMaxy ||
+               znums[its].real() < cMinx || znums[its].real() > cMaxx)
+                continue;
+              int boxY = (znums[its].imag()-cMiny)/cph;
+              int boxX = (znums[its].real()-cMinx)/cpw;
+              ++counter[boxY * cww + boxX];  //Only this thread touches its histogram
+            }
+          }
+          if (tid == 0 && (i / threads) % 4096 == 0)
+            can.handleIO();
+          if (myRedraw || !can.isOpen())
+            break;
         }
-        #pragma omp atomic
-          ++cycles;
-        if (cycles % (MAXITS/100) == 0) {
-          std::cout << (100*cycles)/MAXITS << "%" << std::endl;
-          can.handleIO();
-        }
-        if (myRedraw || !can.isOpen())
-          break;
+        delete [] znums;
+        znums = NULL;
       }
-    delete [] znums;
-    znums = NULL;
-    }
-    if (!can.isOpen())
-      return;
-    int maxIts = 0;
-    for (int i = 0; i < cwh; ++i)
-      for (int j = 0; j < cww; ++j)
-        if (counter[i][j] > maxIts)
-          maxIts = counter[i][j];
-    std::cout << maxIts << " max iterations" << std::endl;
-    #pragma omp parallel num_threads(myThreads)
-    {
-      for (int i = omp_get_thread_num(); i < cwh; i += omp_get_num_threads())
-        for (int j = 0; j < cww; ++j) {
-          float normalize = sqrt((float)counter[i][j]/maxIts);
-          can.Canvas::drawPixel(i, j, (ColorFloat)can.getPixel(i,j) * normalize);
-        }
+      if (!can.isOpen())
+        return;
+      std::cout << (100*LAST)/MAXITS << "%" << std::endl;
+      drawHistograms(can);
     }
     while (can.isOpen() && !myRedraw)
       can.sleep();  //Removed the timer and replaced it with an internal timer in the Canvas class
   }
 }
-
@@ -5,7 +5,7 @@
 #ifndef BUDDHABROT_H_
 #define BUDDHABROT_H_
 
-#include <stdlib.h>
+#include <stdint.h>
 
 #include "Mandelbrot.h"
 
@@ -21,8 +21,11 @@ using namespace tsgl;
  */
 class Buddhabrot : public Mandelbrot {
 private:
-  int **counter;
+  std::vector< std::vector<unsigned> > myHistograms;  // How many orbits each thread has seen pass through each pixel
   int cww, cwh;
+
+  static uint64_t randomBits(uint64_t sample, uint64_t stream);
+  void drawHistograms(Cart& can);
 public:
 
   /*!
@@ -34,16 +37,13 @@ public:
    */
   Buddhabrot(unsigned threads, unsigned depth);
 
-  /*!
-   * \brief Destroys a Buddhabrot object.
-   * \details Destructor for the Buddhabrot class.
-   * \return Frees up memory allocated to a Buddhabrot object.
-   */
-  ~Buddhabrot();
-
   /*!
    * \brief Draw the Buddhabrot.
    * \details Actually draws the Buddhabrot object to the CartesianCanvas.
+   * \details Each thread counts the orbits passing through each pixel in a histogram of its own, so no thread
+   *   waits on another, and picks its random points with a counter-based generator keyed on the sample's
+   *   number, so runs with the same number of threads draw the same picture. The histograms are merged and drawn as one block of pixels
+   *   after every tenth of the samples.
    *    \param can Reference to the CartesianCanvas to draw on.
    * \note This method overrides the draw() method from Mandelbrot.
    * \note Cart is a typedef for CartesianCanvas.
@@ -0,0 +1,209 @@
+/*
+ * DeepMandelbrot.cpp
+ */
+
+#include "DeepMandelbrot.h"
+
+DeepMandelbrot::DeepMandelbrot(unsigned threads, unsigned depth) : Mandelbrot(threads, depth) {
+  myPixelSize = 0.0;
+}
+
+int DeepMandelbrot::fractionLimbsFor(double pixelSize) {
+  //Enough bits to tell neighbouring pixels apart, and 64 more so the reference orbit stays accurate
+  int bits = (int)std::ceil(-std::log2(pixelSize)) + 64;
+  return std::max(2, (bits + 31) / 32);
+}
+
+void DeepMandelbrot::zoomAt(Cart& can, double scale) {
+  std::lock_guard<std::mutex> lock(myViewMutex);
+  double dx = (can.getMouseX() - can.getWindowWidth() / 2.0) * myPixelSize;
+  double dy = (can.getWindowHeight() / 2.0 - can.getMouseY()) * myPixelSize;
+  myPixelSize *= scale;
+  int limbs = fractionLimbsFor(myPixelSize);
+  myCenterX = myCenterX.withPrecision(limbs) + FixedPoint(dx, limbs);
+  myCenterY = myCenterY.withPrecision(limbs) + FixedPoint(dy, limbs);
+  myRedraw = true;
+}
+
+void DeepMandelbrot::bindings(Cart& can) {
+  myPixelSize = can.getPixelWidth();
+  int limbs = fractionLimbsFor(myPixelSize);
+  myCenterX = FixedPoint((can.getMinX() + can.getMaxX()) / 2, limbs);
+  myCenterY = FixedPoint((can.getMinY() + can.getMaxY()) / 2, limbs);
+  can.bindToButton(TSGL_SPACE, TSGL_PRESS, [this]() {
+    this->myRedraw = true;
+  });
+  can.bindToButton(TSGL_MOUSE_LEFT, TSGL_PRESS, [&can, this]() {
+    this->zoomAt(can, 0.5);
+  });
+  can.bindToButton(TSGL_MOUSE_RIGHT, TSGL_PRESS, [&can, this]() {
+    this->zoomAt(can, 1.5);
+  });
+  can.bindToScroll([&can, this](double dx, double dy) {
+    this->zoomAt(can, (dy == 1) ? 0.5 : 1.5);
+  });
+}
+
+void DeepMandelbrot::computeOrbit(const FixedPoint& cx, const FixedPoint& cy) {
+  myOrbitX.assign(1, 0.0);
+  myOrbitY.assign(1, 0.0);
+  FixedPoint zr(0.0, cx.getFractionLimbs()), zi(0.0, cx.getFractionLimbs());
+  for (unsigned n = 0; n < myDepth; ++n) {
+    FixedPoint zrzi = zr * zi;
+    zr = zr * zr - zi * zi + cx;
+    zi = zrzi + zrzi + cy;
+    double x = zr.toDouble(), y = zi.toDouble();
+    myOrbitX.push_back(x);
+    myOrbitY.push_back(y);
+    if (x * x + y * y > 4.0)  //Keep the escaped point; pixels rebase when they reach the end anyway
+      break;
+  }
+}
+
+unsigned DeepMandelbrot::iteratePixel(const double orbitX[], const double orbitY[], unsigned last, double dcr,
+                                      double dci, unsigned depth, unsigned long& rebases) {
+  double dr = 0.0, di = 0.0;  //This pixel's offset from the reference orbit
+  unsigned m = 0, n = 0;      //Where we are in the reference orbit, and how many iterations we've done
+  while (n < depth) {
+    double tr = 2.0 * orbitX[m] + dr, ti = 2.0 * orbitY[m] + di;  //d' = (2Z + d)d + dc
+    double nr = tr * dr - ti * di + dcr;
+    di = tr * di + ti * dr + dci;
+    dr = nr;
+    ++m, ++n;
+    double zr = orbitX[m] + dr, zi = orbitY[m] + di;
+    double mag = zr * zr + zi * zi;
+    if (mag > 4.0)
+      break;
+    if (mag < dr * dr + di * di || m == last) {  //The reference is no help any more, so rebase onto it
+      dr = zr, di = zi;
+      m = 0;
+      ++rebases;
+    }
+  }
+  return n;
+}
+
+void DeepMandelbrot::draw(Cart& can) {
+  const int W = can.getWindowWidth(), H = can.getWindowHeight();
+  TileScheduler scheduler(W, H, 32, myThreads);
+  while (myRedraw) {
+    myRedraw = false;
+    can.reset();
+    FixedPoint cx, cy;
+    double pixelSize;
+    {
+      std::lock_guard<std::mutex> lock(myViewMutex);
+      cx = myCenterX;
+      cy = myCenterY;
+      pixelSize = myPixelSize;
+    }
+    computeOrbit(cx, cy);
+    const unsigned LAST = myOrbitX.size() - 1;
+    const double* orbitX = myOrbitX.data();
+    const double* orbitY = myOrbitY.data();
+    std::atomic<unsigned long> rebases(0);
+    scheduler.run([&](const Tile& tile) {
+      unsigned long tileRebases = 0;
+      for (int y = tile.y; y < tile.y + tile.height; y++) {
+        const double dci = (H / 2.0 - y) * pixelSize;
+        for (int x = tile.x; x < tile.x + tile.width; x++) {
+          const double dcr = (x - W / 2.0) * pixelSize;
+          unsigned n = iteratePixel(orbitX, orbitY, LAST, dcr, dci, myDepth, tileRebases);
+          if (n == myDepth)
+            can.Canvas::drawPoint(x, y, BLACK);
+          else
+            can.Canvas::drawPoint(x, y, ColorHSV((n % 64) * 6.0f / 64, 1.0f, 0.5f + 0.5f * n / myDepth, 1.0f));
+        }
+      }
+      rebases += tileRebases;
+      can.handleIO();
+      if (myRedraw || !can.isOpen())
+        scheduler.cancel();
+    });
+    std::cout << "Pixel size " << pixelSize << " (" << cx.getFractionLimbs() * 32 << " bit center), orbit of "
+              << LAST << ", " << rebases << " rebases, " << can.getTime() << " s" << std::endl;
+    while (can.isOpen() && !myRedraw)
+      can.sleep();
+  }
+}
+
+//-----------------Unit testing-------------------------------------------------------
+void DeepMandelbrot::runTests() {
+  TsglDebug("Testing DeepMandelbrot class...");
+  tsglAssert(testShallowZoom(), "Unit test for matching direct iteration failed!");
+  TsglDebug("Unit tests for DeepMandelbrot complete.");
+  std::cout << std::endl;
+}
+
+/*
+ * Iterates a grid of pixels around a center both by perturbation and directly in long double, and checks
+ * that nearly all of them take the same number of iterations to escape. Pixels right on the edge of the
+ * set can differ by rounding alone, so up to 1% may.
+ */
+bool DeepMandelbrot::testAgainstDirect(double centerX, double centerY, double pixelSize, unsigned depth) {
+  const int SIZE = 64;
+  DeepMandelbrot deep(1, depth);
+  int limbs = fractionLimbsFor(pixelSize);
+  deep.computeOrbit(FixedPoint(centerX, limbs), FixedPoint(centerY, limbs));
+  unsigned long rebases = 0;
+  int different = 0;
+  for (int y = 0; y < SIZE; ++y) {
+    for (int x = 0; x < SIZE; ++x) {
+      double dcr = (x - SIZE / 2.0) * pixelSize, dci = (SIZE / 2.0 - y) * pixelSize;
+      unsigned perturbed = iteratePixel(deep.myOrbitX.data(), deep.myOrbitY.data(), deep.myOrbitX.size() - 1,
+                                        dcr, dci, depth, rebases);
+      long double cr = (long double)centerX + dcr, ci = (long double)centerY + dci, zr = 0, zi = 0;
+      unsigned direct = 0;
+      while (direct < depth) {
+        long double t = zr * zr - zi * zi + cr;
+        zi = 2 * zr * zi + ci;
+        zr = t;
+        ++direct;
+        if (zr * zr + zi * zi > 4)
+          break;
+      }
+      different += (perturbed != direct);
+    }
+  }
+  return different <= SIZE * SIZE / 100;
+}
+
+bool DeepMandelbrot::testShallowZoom() {
+  int passed = 0;
+  int failed = 0;
+
+  //Test 1: The whole set, from a reference that never escapes
+  if (testAgainstDirect(-0.5, 0.0, 2.5 / 64, 256)) {
+    passed++;
+  } else {
+    failed++;
+    TsglErr("Test 1, Matching direct iteration on the whole set for testShallowZoom() failed!");
+  }
+
+  //Test 2: A zoom whose reference escapes early, so every pixel has to rebase
+  if (testAgainstDirect(-0.75, 0.1, 1e-4, 1000)) {
+    passed++;
+  } else {
+    failed++;
+    TsglErr("Test 2, Matching direct iteration with a short reference for testShallowZoom() failed!");
+  }
+
+  //Test 3: A deeper zoom into Seahorse Valley, with a long reference
+  if (testAgainstDirect(-0.743643887037151, 0.131825904205330, 1e-6, 1000)) {
+    passed++;
+  } else {
+    failed++;
+    TsglErr("Test 3, Matching direct iteration zoomed in for testShallowZoom() failed!");
+  }
+
+  if(passed == 3 && failed == 0) {
+    TsglDebug("Unit test for matching direct iteration passed!");
+    return true;
+  } else {
+    TsglErr("This many tests for DeepMandelbrot passed: ");
+    std::cout << " " << passed << std::endl;
+    TsglErr("This many tests for DeepMandelbrot failed: ");
+    std::cout << " " << failed << std::endl;
+    return false;
+  }
+}
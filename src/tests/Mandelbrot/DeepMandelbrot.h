@@ -0,0 +1,83 @@
+/*
+ * DeepMandelbrot.h
+ */
+
+#ifndef DEEPMANDELBROT_H_
+#define DEEPMANDELBROT_H_
+
+#include <mutex>
+
+#include "FixedPoint.h"
+#include "Mandelbrot.h"
+
+using namespace tsgl;
+
+/*!
+ * \class DeepMandelbrot
+ * \brief Draws a Mandelbrot set that can be zoomed far past the limits of a long double.
+ * \details A CartesianCanvas stores its bounds as long doubles, so an ordinary Mandelbrot turns into blocks
+ *   once the view is about 1e-17 wide. DeepMandelbrot instead keeps the center of the view as a FixedPoint
+ *   number, with as many bits as the zoom needs, and renders it by perturbation:
+ *   - Iterate a single reference orbit Z at the center in full precision, and store it as doubles.
+ *   - For every pixel, iterate only its small offset from the reference, which double holds just fine:
+ *     if the pixel is at C + dc, then z = Z + d, where d' = 2Zd + d<sup>2</sup> + dc.
+ *   - Where the offset grows larger than the pixel's own value, or the reference runs out, the pixel
+ *     rebases onto the start of the reference orbit (d = z), so no pixel is ever glitched by following a
+ *     reference that is far away from it.
+ *   .
+ * \details Can zoom in and out by scrolling up and down on the mouse wheel, or by clicking the left and
+ *   right mouse buttons, respectively. Each zoom is centered on the mouse. The spacebar redraws.
+ * \note The offsets are doubles, so the view can be zoomed to about 1e-300 wide.
+ * \see Mandelbrot class, FixedPoint class
+ */
+class DeepMandelbrot : public Mandelbrot {
+private:
+  std::mutex myViewMutex;             // Guards the view, which the bindings change while we draw
+  FixedPoint myCenterX, myCenterY;    // Center of the view
+  double myPixelSize;                 // Width of one pixel in the complex plane
+  std::vector<double> myOrbitX, myOrbitY;  // The reference orbit
+
+  void zoomAt(Cart& can, double scale);
+  static int fractionLimbsFor(double pixelSize);
+  void computeOrbit(const FixedPoint& cx, const FixedPoint& cy);
+  static unsigned iteratePixel(const double orbitX[], const double orbitY[], unsigned last, double dcr, double dci,
+                               unsigned depth, unsigned long& rebases);
+
+  static bool testAgainstDirect(double centerX, double centerY, double pixelSize, unsigned depth);
+  static bool testShallowZoom();
+public:
+
+  /*!
+   * \brief Explicitly constructs a DeepMandelbrot object.
+   * \details Explicit constructor for the DeepMandelbrot class.
+   *    \param threads The number of threads to use in drawing the DeepMandelbrot object.
+   *    \param depth The number of iterations to go to in order to draw the DeepMandelbrot object.
+   * \return The constructed DeepMandelbrot object.
+   */
+  DeepMandelbrot(unsigned threads, unsigned depth);
+
+  /*!
+   * \brief Binds buttons and/or mouse clicks.
+   * \details Takes the starting view from the bounds of the CartesianCanvas, then binds the mouse wheel,
+   *   left and right mouse buttons to zoom, and the spacebar to redraw.
+   *    \param can Reference to the CartesianCanvas to have the buttons bound to.
+   * \note This hides the Mandelbrot class' bindings() method, which zooms the CartesianCanvas itself.
+   */
+  void bindings(Cart& can);
+
+  /*!
+   * \brief Draw the DeepMandelbrot object.
+   * \details Computes the reference orbit, then the pixels a tile at a time with a TileScheduler, and
+   *   prints the zoom, the length of the reference orbit, how many times pixels were rebased, and the time.
+   *    \param can Reference to the CartesianCanvas to draw on.
+   * \note This method overrides the Mandelbrot class' draw() method.
+   */
+  void draw(Cart& can);
+
+  /*!
+   * \brief Runs the Unit tests for DeepMandelbrot.
+   */
+  static void runTests();
+};
+
+#endif /* DEEPMANDELBROT_H_ */
@@ -0,0 +1,297 @@
+/*
+ * EscapeTime.h
+ */
+
+#ifndef ESCAPETIME_H_
+#define ESCAPETIME_H_
+
+#include <cmath>
+#if defined(__AVX__) || defined(__SSE2__)
+  #include <immintrin.h>
+#endif
+
+/*!
+ * \class DoubleLanes
+ * \brief A group of doubles operated on together with SIMD instructions.
+ * \details DoubleLanes holds 4 doubles when compiled with AVX enabled (for example, with <code>-mavx</code> or
+ *   <code>-march=native</code>), 2 doubles with SSE2 (the default on x86-64), and a single double otherwise.
+ * \details Comparisons produce masks, which can be combined with both(), tested with any(), and used to pick
+ *   lanes with select().
+ */
+#if defined(__AVX__)
+struct DoubleLanes {
+  static const int SIZE = 4;
+  __m256d v;
+  DoubleLanes() {}
+  DoubleLanes(__m256d x) : v(x) {}
+  DoubleLanes(double x) : v(_mm256_set1_pd(x)) {}
+  static DoubleLanes load(const double* p) { return _mm256_loadu_pd(p); }
+  void store(double* p) const { _mm256_storeu_pd(p, v); }
+};
+inline DoubleLanes operator+(DoubleLanes a, DoubleLanes b) { return _mm256_add_pd(a.v, b.v); }
+inline DoubleLanes operator-(DoubleLanes a, DoubleLanes b) { return _mm256_sub_pd(a.v, b.v); }
+inline DoubleLanes operator*(DoubleLanes a, DoubleLanes b) { return _mm256_mul_pd(a.v, b.v); }
+inline DoubleLanes operator/(DoubleLanes a, DoubleLanes b) { return _mm256_div_pd(a.v, b.v); }
+inline DoubleLanes lessThan(DoubleLanes a, DoubleLanes b) { return _mm256_cmp_pd(a.v, b.v, _CMP_LT_OQ); }
+inline DoubleLanes both(DoubleLanes m, DoubleLanes n) { return _mm256_and_pd(m.v, n.v); }
+inline DoubleLanes select(DoubleLanes m, DoubleLanes a, DoubleLanes b) { return _mm256_blendv_pd(b.v, a.v, m.v); }
+inline bool any(DoubleLanes m) { return _mm256_movemask_pd(m.v) != 0; }
+#elif defined(__SSE2__)
+struct DoubleLanes {
+  static const int SIZE = 2;
+  __m128d v;
+  DoubleLanes() {}
+  DoubleLanes(__m128d x) : v(x) {}
+  DoubleLanes(double x) : v(_mm_set1_pd(x)) {}
+  static DoubleLanes load(const double* p) { return _mm_loadu_pd(p); }
+  void store(double* p) const { _mm_storeu_pd(p, v); }
+};
+inline DoubleLanes operator+(DoubleLanes a, DoubleLanes b) { return _mm_add_pd(a.v, b.v); }
+inline DoubleLanes operator-(DoubleLanes a, DoubleLanes b) { return _mm_sub_pd(a.v, b.v); }
+inline DoubleLanes operator*(DoubleLanes a, DoubleLanes b) { return _mm_mul_pd(a.v, b.v); }
+inline DoubleLanes operator/(DoubleLanes a, DoubleLanes b) { return _mm_div_pd(a.v, b.v); }
+inline DoubleLanes lessThan(DoubleLanes a, DoubleLanes b) { return _mm_cmplt_pd(a.v, b.v); }
+inline DoubleLanes both(DoubleLanes m, DoubleLanes n) { return _mm_and_pd(m.v, n.v); }
+inline DoubleLanes select(DoubleLanes m, DoubleLanes a, DoubleLanes b) {
+  return _mm_or_pd(_mm_and_pd(m.v, a.v), _mm_andnot_pd(m.v, b.v));  // SSE2 has no blend
+}
+inline bool any(DoubleLanes m) { return _mm_movemask_pd(m.v) != 0; }
+#else
+struct DoubleLanes {
+  static const int SIZE = 1;
+  double v;
+  DoubleLanes() {}
+  DoubleLanes(double x) : v(x) {}
+  static DoubleLanes load(const double* p) { return *p; }
+  void store(double* p) const { *p = v; }
+};
+inline DoubleLanes operator+(DoubleLanes a, DoubleLanes b) { return a.v + b.v; }
+inline DoubleLanes operator-(DoubleLanes a, DoubleLanes b) { return a.v - b.v; }
+inline DoubleLanes operator*(DoubleLanes a, DoubleLanes b) { return a.v * b.v; }
+inline DoubleLanes operator/(DoubleLanes a, DoubleLanes b) { return a.v / b.v; }
+inline DoubleLanes lessThan(DoubleLanes a, DoubleLanes b) { return a.v < b.v ? 1.0 : 0.0; }
+inline DoubleLanes both(DoubleLanes m, DoubleLanes n) { return (m.v != 0 && n.v != 0) ? 1.0 : 0.0; }
+inline DoubleLanes select(DoubleLanes m, DoubleLanes a, DoubleLanes b) { return m.v != 0 ? a : b; }
+inline bool any(DoubleLanes m) { return m.v != 0; }
+#endif
+
+/*!
+ * \class MandelbrotRule
+ * \brief Iteration rule for the Mandelbrot set: z = z<sup>2</sup> + c, where c is the pixel and z starts at c.
+ * \details An iteration rule provides <code>start()</code>, which sets up z and c for a pixel, and
+ *   <code>step()</code>, which performs one iteration. Both are templates so that they can be run on
+ *   DoubleLanes or on plain doubles.
+ */
+struct MandelbrotRule {
+  template<typename V>
+  void start(V x, V y, V& zr, V& zi, V& cr, V& ci) const {
+    zr = cr = x;
+    zi = ci = y;
+  }
+  template<typename V>
+  void step(V& zr, V& zi, V cr, V ci) const {
+    V t = zr * zi;
+    zr = zr * zr - zi * zi + cr;
+    zi = t + t + ci;
+  }
+};
+
+/*!
+ * \class JuliaRule
+ * \brief Iteration rule for a Julia set: z = z<sup>2</sup> + c, where z starts at the pixel and c is constant.
+ */
+struct JuliaRule {
+  double realC, imagC;  // The constant c
+
+  JuliaRule(double real = -0.8, double imag = 0.156) : realC(real), imagC(imag) {}
+  template<typename V>
+  void start(V x, V y, V& zr, V& zi, V& cr, V& ci) const {
+    zr = x;
+    zi = y;
+    cr = V(realC);
+    ci = V(imagC);
+  }
+  template<typename V>
+  void step(V& zr, V& zi, V cr, V ci) const {
+    V t = zr * zi;
+    zr = zr * zr - zi * zi + cr;
+    zi = t + t + ci;
+  }
+};
+
+/*!
+ * \class NovaRule
+ * \brief Iteration rule for a Nova fractal: a relaxed Newton step for z<sup>3</sup> - 1, plus c.
+ * \details z = z + c - R(z<sup>3</sup> - 1) / 3z<sup>2</sup>, where c is the pixel and z starts at 1.
+ */
+struct NovaRule {
+  double relaxation;  // R
+
+  NovaRule(double r = 1.0) : relaxation(r) {}
+  template<typename V>
+  void start(V x, V y, V& zr, V& zi, V& cr, V& ci) const {
+    zr = V(1.0);
+    zi = V(0.0);
+    cr = x;
+    ci = y;
+  }
+  template<typename V>
+  void step(V& zr, V& zi, V cr, V ci) const {
+    V sr = zr * zr - zi * zi, si = zr * zi;
+    si = si + si;                                        // z^2
+    V nr = sr * zr - si * zi - V(1.0), ni = sr * zi + si * zr;  // z^3 - 1
+    V dr = V(3.0) * sr, di = V(3.0) * si;                // 3z^2
+    V scale = V(relaxation) / (dr * dr + di * di);
+    zr = zr + cr - (nr * dr + ni * di) * scale;
+    zi = zi + ci - (ni * dr - nr * di) * scale;
+  }
+};
+
+/*!
+ * \class EscapeTime
+ * \brief Computes escape-time fractals several pixels at a time.
+ * \details EscapeTime iterates <code>Rule</code> (see MandelbrotRule) on GROUP pixels at once, using
+ *   DoubleLanes for the arithmetic. A pixel stops once |z|<sup>2</sup> reaches the squared bailout radius
+ *   (so no square roots are taken while iterating) or once it has been iterated <code>depth</code> times.
+ *   Pixels that have stopped are masked out while the rest of their group keeps going, and the group is
+ *   finished when all of its pixels have stopped.
+ * \details For each pixel, the number of iterations and a smooth (fractional) escape count are written to
+ *   buffers. The final z can be kept as well, so that a later call to resume() can iterate further.
+ */
+template<typename Rule>
+class EscapeTime {
+private:
+  Rule myRule;
+  double myBailout;
+
+  //Iterates one group of pixels; counts and z are read from the buffers unless fresh is set
+  void iterate(const double x[], const double y[], double count[], double zr[], double zi[],
+               unsigned depth, bool fresh) const {
+    const int U = GROUP / DoubleLanes::SIZE;
+    DoubleLanes cr[U], ci[U], r[U], i[U], n[U];
+    const DoubleLanes limit(myBailout * myBailout), maxCount((double)depth), one(1.0), zero(0.0);
+    for (int k = 0; k < U; ++k) {
+      myRule.start(DoubleLanes::load(x + k * DoubleLanes::SIZE), DoubleLanes::load(y + k * DoubleLanes::SIZE),
+                   r[k], i[k], cr[k], ci[k]);
+      if (!fresh) {
+        r[k] = DoubleLanes::load(zr + k * DoubleLanes::SIZE);
+        i[k] = DoubleLanes::load(zi + k * DoubleLanes::SIZE);
+      }
+      n[k] = DoubleLanes::load(count + k * DoubleLanes::SIZE);
+    }
+    for (bool running = true; running; ) {
+      running = false;
+      for (int k = 0; k < U; ++k) {  // Independent groups of lanes, to hide the latency of each step
+        DoubleLanes active = both(lessThan(r[k] * r[k] + i[k] * i[k], limit), lessThan(n[k], maxCount));
+        if (!any(active))
+          continue;
+        running = true;
+        DoubleLanes nr = r[k], ni = i[k];
+        myRule.step(nr, ni, cr[k], ci[k]);
+        r[k] = select(active, nr, r[k]);
+        i[k] = select(active, ni, i[k]);
+        n[k] = n[k] + select(active, one, zero);
+      }
+    }
+    for (int k = 0; k < U; ++k) {
+      r[k].store(zr + k * DoubleLanes::SIZE);
+      i[k].store(zi + k * DoubleLanes::SIZE);
+      n[k].store(count + k * DoubleLanes::SIZE);
+    }
+  }
+
+  //Iterates n pixels, a group at a time
+  void run(int n, const double x[], const double y[], unsigned depth, unsigned iterations[], float smooth[],
+           double zr[], double zi[], bool fresh) const {
+    double gx[GROUP], gy[GROUP], count[GROUP], gr[GROUP], gi[GROUP];
+    for (int first = 0; first < n; first += GROUP) {
+      for (int j = 0; j < GROUP; ++j) {
+        int p = first + j;
+        bool real = p < n;
+        gx[j] = real ? x[p] : 0;
+        gy[j] = real ? y[p] : 0;
+        count[j] = !real ? depth : fresh ? 0 : iterations[p];  // Padding lanes start out finished
+        gr[j] = (real && !fresh) ? zr[p] : 0;
+        gi[j] = (real && !fresh) ? zi[p] : 0;
+      }
+      iterate(gx, gy, count, gr, gi, depth, fresh);
+      for (int j = 0; j < GROUP && first + j < n; ++j) {
+        int p = first + j;
+        iterations[p] = (unsigned)count[j];
+        if (zr != nullptr) {
+          zr[p] = gr[j];
+          zi[p] = gi[j];
+        }
+        if (smooth != nullptr)
+          smooth[p] = smoothCount(iterations[p], depth, gr[j], gi[j]);
+      }
+    }
+  }
+public:
+  /*!
+   * \var GROUP
+   * \brief The number of pixels iterated together.
+   */
+  static const int GROUP = 2 * DoubleLanes::SIZE;
+
+  /*!
+   * \brief Explicitly constructs an EscapeTime engine.
+   *    \param rule The iteration rule to use.
+   *    \param bailout The magnitude of z at which a pixel has escaped (set to 2 by default).
+   * \return The constructed EscapeTime engine.
+   */
+  explicit EscapeTime(const Rule& rule = Rule(), double bailout = 2.0) : myRule(rule), myBailout(bailout) {}
+
+  /*!
+   * \brief Computes a number of pixels.
+   *    \param n The number of pixels.
+   *    \param x The real parts of the pixels' coordinates.
+   *    \param y The imaginary parts of the pixels' coordinates.
+   *    \param depth The most iterations to perform on any pixel.
+   *    \param iterations Array in which to store each pixel's number of iterations
+   *      (<code>depth</code> if the pixel never escaped).
+   *    \param smooth Array in which to store each pixel's smooth escape count, or nullptr.
+   *    \param zr Array in which to store the real part of each pixel's final z (for resume()), or nullptr.
+   *    \param zi Array in which to store the imaginary part of each pixel's final z, or nullptr.
+   */
+  void compute(int n, const double x[], const double y[], unsigned depth, unsigned iterations[],
+               float smooth[] = nullptr, double zr[] = nullptr, double zi[] = nullptr) const {
+    run(n, x, y, depth, iterations, smooth, zr, zi, true);
+  }
+
+  /*!
+   * \brief Continues iterating pixels computed earlier with a smaller depth.
+   * \details Pixels that escaped are left alone; the others pick up from their stored z.
+   *    \param n The number of pixels.
+   *    \param x The real parts of the pixels' coordinates.
+   *    \param y The imaginary parts of the pixels' coordinates.
+   *    \param depth The new most iterations to perform on any pixel.
+   *    \param iterations The pixels' numbers of iterations so far, updated in place.
+   *    \param zr The real parts of the pixels' z so far, updated in place.
+   *    \param zi The imaginary parts of the pixels' z so far, updated in place.
+   *    \param smooth Array in which to store each pixel's smooth escape count, or nullptr.
+   */
+  void resume(int n, const double x[], const double y[], unsigned depth, unsigned iterations[],
+              double zr[], double zi[], float smooth[] = nullptr) const {
+    run(n, x, y, depth, iterations, smooth, zr, zi, false);
+  }
+
+  /*!
+   * \brief Computes the smooth escape count of a pixel.
+   * \details For a pixel that escaped, this is its number of iterations plus a fraction that changes
+   *   continuously with the pixel's coordinates, so that coloring by it shows no bands.
+   *    \param iterations The pixel's number of iterations.
+   *    \param depth The most iterations that were performed.
+   *    \param zr The real part of the pixel's final z.
+   *    \param zi The imaginary part of the pixel's final z.
+   * \return The smooth escape count, or <code>depth</code> if the pixel never escaped.
+   */
+  static float smoothCount(unsigned iterations, unsigned depth, double zr, double zi) {
+    if (iterations >= depth)
+      return depth;
+    double s = iterations + 1 - std::log2(0.5 * std::log(zr * zr + zi * zi));
+    return (s == s) ? (float)s : (float)iterations;  // z may be NaN if the rule divided by zero
+  }
+};
+
+#endif /* ESCAPETIME_H_ */
@@ -0,0 +1,202 @@
+/*
+ * FixedPoint.cpp
+ */
+
+#include "FixedPoint.h"
+
+#include <algorithm>
+#include <cmath>
+#include <tsgl.h>
+
+using namespace tsgl;
+
+FixedPoint::FixedPoint(double value, int fractionLimbs) {
+  myNegative = value < 0;
+  myLimbs.assign(std::max(fractionLimbs, 0) + 1, 0);
+  double magnitude = std::abs(value);
+  double whole = std::floor(magnitude);
+  myLimbs[0] = (uint32_t)whole;
+  double fraction = magnitude - whole;
+  for (unsigned k = 1; k < myLimbs.size() && fraction > 0; ++k) {
+    fraction = std::ldexp(fraction, 32);  // Exact, so the double's bits are copied over one limb at a time
+    double limb = std::floor(fraction);
+    myLimbs[k] = (uint32_t)limb;
+    fraction -= limb;
+  }
+}
+
+FixedPoint::FixedPoint(bool negative, const std::vector<uint32_t>& limbs) : myNegative(negative), myLimbs(limbs) {}
+
+int FixedPoint::compareMagnitudes(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b) {
+  for (unsigned k = 0; k < a.size(); ++k)
+    if (a[k] != b[k])
+      return (a[k] < b[k]) ? -1 : 1;
+  return 0;
+}
+
+FixedPoint FixedPoint::addSigned(const FixedPoint& a, const FixedPoint& b, bool negateB) {
+  const int LIMBS = std::max(a.getFractionLimbs(), b.getFractionLimbs());
+  std::vector<uint32_t> x = a.withPrecision(LIMBS).myLimbs, y = b.withPrecision(LIMBS).myLimbs;
+  bool xNegative = a.myNegative, yNegative = b.myNegative != negateB;
+  std::vector<uint32_t> sum(x.size());
+  if (xNegative == yNegative) {  // Same signs: add the magnitudes
+    uint64_t carry = 0;
+    for (int k = LIMBS; k >= 0; --k) {
+      uint64_t t = (uint64_t)x[k] + y[k] + carry;
+      sum[k] = (uint32_t)t;
+      carry = t >> 32;
+    }
+    return FixedPoint(xNegative, sum);
+  }
+  if (compareMagnitudes(x, y) < 0) {  // Different signs: subtract the smaller magnitude from the larger
+    std::swap(x, y);
+    std::swap(xNegative, yNegative);
+  }
+  int64_t borrow = 0;
+  for (int k = LIMBS; k >= 0; --k) {
+    int64_t t = (int64_t)x[k] - y[k] - borrow;
+    borrow = (t < 0) ? 1 : 0;
+    sum[k] = (uint32_t)(t + (borrow << 32));
+  }
+  bool zero = true;
+  for (unsigned k = 0; k < sum.size(); ++k)
+    zero = zero && sum[k] == 0;
+  return FixedPoint(xNegative && !zero, sum);
+}
+
+FixedPoint FixedPoint::operator+(const FixedPoint& other) const {
+  return addSigned(*this, other, false);
+}
+
+FixedPoint FixedPoint::operator-(const FixedPoint& other) const {
+  return addSigned(*this, other, true);
+}
+
+FixedPoint FixedPoint::operator*(const FixedPoint& other) const {
+  const int LIMBS = std::max(getFractionLimbs(), other.getFractionLimbs());
+  std::vector<uint32_t> a = withPrecision(LIMBS).myLimbs, b = other.withPrecision(LIMBS).myLimbs;
+  std::vector<uint32_t> product(2 * LIMBS + 1, 0);
+  for (int i = LIMBS; i >= 0; --i) {  // Schoolbook multiplication, least significant limbs first
+    uint64_t carry = 0;
+    for (int j = LIMBS; j >= 0; --j) {
+      uint64_t t = (uint64_t)a[i] * b[j] + product[i + j] + carry;  // Can't overflow 64 bits
+      product[i + j] = (uint32_t)t;
+      carry = t >> 32;
+    }
+    if (i > 0)
+      product[i - 1] = (uint32_t)carry;  // Nothing has been written there yet
+  }
+  product.resize(LIMBS + 1);
+  bool zero = true;
+  for (unsigned k = 0; k < product.size(); ++k)
+    zero = zero && product[k] == 0;
+  return FixedPoint(myNegative != other.myNegative && !zero, product);
+}
+
+FixedPoint FixedPoint::withPrecision(int fractionLimbs) const {
+  std::vector<uint32_t> limbs(myLimbs);
+  limbs.resize(std::max(fractionLimbs, 0) + 1, 0);
+  return FixedPoint(myNegative, limbs);
+}
+
+double FixedPoint::toDouble() const {
+  unsigned first = 0;
+  while (first + 1 < myLimbs.size() && myLimbs[first] == 0)
+    ++first;
+  double value = 0;
+  for (unsigned k = first; k < myLimbs.size() && k < first + 3; ++k)  // 96 bits is plenty for a double's 53
+    value += std::ldexp((double)myLimbs[k], -32 * (int)k);
+  return myNegative ? -value : value;
+}
+
+//-----------------Unit testing-------------------------------------------------------
+void FixedPoint::runTests() {
+  TsglDebug("Testing FixedPoint class...");
+  tsglAssert(testArithmetic(), "Unit test for matching long double arithmetic failed!");
+  tsglAssert(testPrecision(), "Unit test for precision beyond long double failed!");
+  TsglDebug("Unit tests for FixedPoint complete.");
+  std::cout << std::endl;
+}
+
+bool FixedPoint::testArithmetic() {
+  int passed = 0;
+  int failed = 0;
+
+  //Tests 1-3: Sums, differences and products of random numbers of either sign match long double
+  const int SAMPLES = 1000;
+  const long double TOLERANCE = 1e-15L;  //The rounding of toDouble(), on results no bigger than 4
+  Random rng(43);
+  bool sums = true, differences = true, products = true;
+  for (int i = 0; i < SAMPLES; ++i) {
+    double a = 4 * rng.nextDouble() - 2, b = 4 * rng.nextDouble() - 2;
+    FixedPoint fa(a), fb(b);
+    sums = sums && std::abs((fa + fb).toDouble() - ((long double)a + b)) < TOLERANCE;
+    differences = differences && std::abs((fa - fb).toDouble() - ((long double)a - b)) < TOLERANCE;
+    products = products && std::abs((fa * fb).toDouble() - (long double)a * b) < TOLERANCE;
+  }
+  if (sums) {
+    passed++;
+  } else {
+    failed++;
+    TsglErr("Test 1, Adding for testArithmetic() failed!");
+  }
+  if (differences) {
+    passed++;
+  } else {
+    failed++;
+    TsglErr("Test 2, Subtracting for testArithmetic() failed!");
+  }
+  if (products) {
+    passed++;
+  } else {
+    failed++;
+    TsglErr("Test 3, Multiplying for testArithmetic() failed!");
+  }
+
+  if(passed == 3 && failed == 0) {
+    TsglDebug("Unit test for matching long double arithmetic passed!");
+    return true;
+  } else {
+    TsglErr("This many tests for FixedPoint passed: ");
+    std::cout << " " << passed << std::endl;
+    TsglErr("This many tests for FixedPoint failed: ");
+    std::cout << " " << failed << std::endl;
+    return false;
+  }
+}
+
+bool FixedPoint::testPrecision() {
+  int passed = 0;
+  int failed = 0;
+
+  //Test 1: Bits far below a long double's 64 survive adding and subtracting 1
+  const double TINY = std::ldexp(1.0, -100);
+  FixedPoint one(1.0, 4);
+  if ((one + FixedPoint(TINY, 4) - one).toDouble() == TINY && (one - one).toDouble() == 0) {
+    passed++;
+  } else {
+    failed++;
+    TsglErr("Test 1, Adding tiny numbers for testPrecision() failed!");
+  }
+
+  //Test 2: So do products, and the more precise operand sets the precision
+  FixedPoint x = one + FixedPoint(TINY, 4), square = x * x, negated = x * FixedPoint(-1.0, 1);
+  if ((square - one).toDouble() == 2 * TINY && negated.getFractionLimbs() == 4 &&
+      (negated + one).toDouble() == -TINY) {
+    passed++;
+  } else {
+    failed++;
+    TsglErr("Test 2, Multiplying precisely for testPrecision() failed!");
+  }
+
+  if(passed == 2 && failed == 0) {
+    TsglDebug("Unit test for precision beyond long double passed!");
+    return true;
+  } else {
+    TsglErr("This many tests for FixedPoint passed: ");
+    std::cout << " " << passed << std::endl;
+    TsglErr("This many tests for FixedPoint failed: ");
+    std::cout << " " << failed << std::endl;
+    return false;
+  }
+}
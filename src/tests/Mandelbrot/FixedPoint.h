@@ -0,0 +1,86 @@
+/*
+ * FixedPoint.h
+ */
+
+#ifndef FIXEDPOINT_H_
+#define FIXEDPOINT_H_
+
+#include <stdint.h>
+#include <vector>
+
+/*!
+ * \class FixedPoint
+ * \brief A signed fixed-point number with as many fraction bits as needed.
+ * \details FixedPoint holds a sign, a 32 bit integer part and any number of 32 bit fraction "limbs", so it
+ *   can represent coordinates far more precisely than a long double. It supports only what is needed to
+ *   compute a Mandelbrot reference orbit: addition, subtraction, multiplication, and conversion to and from
+ *   double.
+ * \details The result of an operation has as many fraction limbs as the more precise of its operands.
+ *   Multiplication truncates the product to that many limbs.
+ * \note The integer part must stay below 2<sup>32</sup> in magnitude; overflow is not detected.
+ */
+class FixedPoint {
+private:
+  bool myNegative;
+  std::vector<uint32_t> myLimbs;  // myLimbs[0] is the integer part, myLimbs[k] is worth 2^(-32k)
+
+  FixedPoint(bool negative, const std::vector<uint32_t>& limbs);
+  static int compareMagnitudes(const std::vector<uint32_t>& a, const std::vector<uint32_t>& b);
+  static FixedPoint addSigned(const FixedPoint& a, const FixedPoint& b, bool negateB);
+
+  static bool testArithmetic();
+  static bool testPrecision();
+public:
+
+  /*!
+   * \brief Explicitly constructs a FixedPoint number.
+   *    \param value The value of the number.
+   *    \param fractionLimbs The number of 32 bit limbs after the binary point.
+   * \return The constructed FixedPoint number.
+   */
+  explicit FixedPoint(double value = 0.0, int fractionLimbs = 2);
+
+  /*!
+   * \brief Adds two FixedPoint numbers.
+   * \return The sum of this number and <code>other</code>.
+   */
+  FixedPoint operator+(const FixedPoint& other) const;
+
+  /*!
+   * \brief Subtracts two FixedPoint numbers.
+   * \return The difference of this number and <code>other</code>.
+   */
+  FixedPoint operator-(const FixedPoint& other) const;
+
+  /*!
+   * \brief Multiplies two FixedPoint numbers.
+   * \return The product of this number and <code>other</code>, truncated to the larger precision.
+   */
+  FixedPoint operator*(const FixedPoint& other) const;
+
+  /*!
+   * \brief Accessor for the precision.
+   * \return The number of 32 bit limbs after the binary point.
+   */
+  int getFractionLimbs() const { return myLimbs.size() - 1; }
+
+  /*!
+   * \brief Changes the precision.
+   *    \param fractionLimbs The new number of 32 bit limbs after the binary point.
+   * \return This number, with limbs dropped from or zeros appended to its fraction.
+   */
+  FixedPoint withPrecision(int fractionLimbs) const;
+
+  /*!
+   * \brief Converts to a double.
+   * \return The closest double (give or take rounding in the last bit) to this number.
+   */
+  double toDouble() const;
+
+  /*!
+   * \brief Runs the Unit tests for FixedPoint.
+   */
+  static void runTests();
+};
+
+#endif /* FIXEDPOINT_H_ */
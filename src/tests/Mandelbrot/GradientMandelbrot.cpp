@@ -7,37 +7,31 @@
 GradientMandelbrot::GradientMandelbrot(unsigned threads, unsigned depth) : Mandelbrot(threads, depth) {}
 
 void GradientMandelbrot::draw(Cart& can) {
+  TileScheduler scheduler(can.getWindowWidth(), can.getWindowHeight(), 32, myThreads);
+  EscapeTime<MandelbrotRule> engine;
   while (myRedraw) {
     myRedraw = false;
-    #pragma omp parallel num_threads(myThreads)
-    {
-      unsigned int nthreads = omp_get_num_threads();
-      double blockstart = can.getCartHeight() / nthreads;
-      unsigned int iterations;
-      double smooth;
-      for (unsigned int k = 0; k <= (can.getWindowHeight() / nthreads) && can.isOpen(); k++) {  // As long as we aren't trying to render off of the screen...
-        long double row = blockstart * omp_get_thread_num() + can.getMinY() + can.getPixelHeight() * k;
-        for (long double col = can.getMinX(); col <= can.getMaxX(); col += can.getPixelWidth()) {
-          complex c(col, row);
-          complex z(col, row);
-          smooth = exp(-std::abs(z));
-          iterations = 0;
-          while (std::abs(z) < 2.0l && iterations != myDepth) {
-            iterations++;
-            z = z * z + c;
-            smooth += exp(-std::abs(z));
-          }
-          smooth /= (myDepth + 1);
-          float value = (float)iterations/myDepth;
-          can.drawPoint(col, row, ColorHSV((float)smooth * 6.0f, 1.0f, value, 1.0f));
-          if (myRedraw) break;
+    scheduler.run([&](const Tile& tile) {
+      std::vector<double> cols(tile.width), rows(tile.width);
+      std::vector<unsigned> iterations(tile.width);
+      std::vector<float> smooth(tile.width);
+      for (int y = tile.y; y < tile.y + tile.height; y++) {
+        for (int i = 0; i < tile.width; i++) {
+          cols[i] = can.getMinX() + can.getPixelWidth() * (tile.x + i);
+          rows[i] = can.getMaxY() - can.getPixelHeight() * y;
+        }
+        engine.compute(tile.width, cols.data(), rows.data(), myDepth, iterations.data(), smooth.data());
+        for (int i = 0; i < tile.width; i++) {
+          float hue = 6.0f * smooth[i] / myDepth;  // The smooth escape count changes without bands
+          float value = (float)iterations[i]/myDepth;
+          can.Canvas::drawPoint(tile.x + i, y, ColorHSV(hue, 1.0f, value, 1.0f));
         }
-        can.handleIO();
-        if (myRedraw) break;
       }
-    }
+      can.handleIO();
+      if (myRedraw || !can.isOpen())
+        scheduler.cancel();
+    });
     while (can.isOpen() && !myRedraw)
       can.sleep();  //Removed the timer and replaced it with an internal timer in the Canvas class
   }
 }
-
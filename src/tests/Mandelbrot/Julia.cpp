@@ -9,6 +9,7 @@ Julia::Julia(unsigned threads, unsigned depth) : Mandelbrot(threads, depth) {}
 void Julia::draw(Cart& can) {
   const int CH = can.getWindowHeight();   //Height of our Mandelbrot canvas
   VisualTaskQueue vq(CH);
+  EscapeTime<JuliaRule> engine(JuliaRule(-0.8, 0.156));
   while(myRedraw) {
     myRedraw = false;
     can.reset();
@@ -18,6 +19,9 @@ void Julia::draw(Cart& can) {
     {
       vq.showLegend();
       int myNext;
+      const int CW = can.getWindowWidth();
+      std::vector<double> cols(CW), rows(CW);
+      std::vector<unsigned> iterations(CW);
       while(true) {  // As long as we aren't trying to render off of the screen...
         #pragma omp critical
         {
@@ -26,23 +30,20 @@ void Julia::draw(Cart& can) {
         if (myNext >= can.getWindowHeight())
           break;
         vq.update(myNext,RUNNING);
-        long double row = can.getMinY() + can.getPixelHeight() * myNext;
-        for(long double col = can.getMinX(); col <= can.getMaxX(); col += can.getPixelWidth()) {
-          complex z(-0.8f, 0.156f);
-          complex c(col, row);
-          unsigned iterations = 0;
-          while (std::abs(c) < 2.0 && iterations != myDepth) {  // Compute it until it escapes or we give up
-            iterations++;
-            c = c * c + z;
-          }
-          if(iterations == myDepth) { // If the point never escaped, draw it black
-            can.drawPoint(col, row, BLACK);
+        for (int i = 0; i < CW; i++) {
+          cols[i] = can.getMinX() + can.getPixelWidth() * i;
+          rows[i] = can.getMaxY() - can.getPixelHeight() * myNext;
+        }
+        engine.compute(CW, cols.data(), rows.data(), myDepth, iterations.data());  // Until they escape or we give up
+        for (int i = 0; i < CW; i++) {
+          if(iterations[i] == myDepth) { // If the point never escaped, draw it black
+            can.Canvas::drawPoint(i, myNext, BLACK);
           } else { // Otherwise, draw it with color based on how long it took
-            float mult = iterations/(float)myDepth;
-            can.drawPoint(col, row, Colors::blend(BLACK,WHITE,0.25f+0.5f*mult)*mult);
+            float mult = iterations[i]/(float)myDepth;
+            can.Canvas::drawPoint(i, myNext, Colors::blend(BLACK,WHITE,0.25f+0.5f*mult)*mult);
           }
-          if (!can.isOpen() || myRedraw) break;
         }
+        if (!can.isOpen()) break;
         vq.update(myNext,FINISHED);
         can.handleIO();
         if (myRedraw) break;
@@ -9,57 +9,111 @@ Mandelbrot::Mandelbrot(unsigned threads, unsigned depth) {
     myDepth = depth;
     myFirstX = myFirstY = mySecondX = mySecondY = 0.0;
     myRedraw = true;
+    myBufferMinX = myBufferMaxY = myBufferPixelWidth = myBufferPixelHeight = 0.0;
+    myBufferWidth = myBufferHeight = 0;
+    myBufferDepth = 0;
+    myProgressive = true;
 }
 
-void Mandelbrot::manhattanShading(CartesianCanvas& can) {
-  int** canPoints = new int*[can.getWindowHeight()];
-  for (int i = 0; i < can.getWindowHeight(); ++i) {
-    canPoints[i] = new int[can.getWindowWidth()];
-    for (int j = 0; j < can.getWindowWidth(); ++j) {
-      ColorInt c = can.getPoint(j,i);
-      canPoints[i][j] = ((c.R == c.G) && (c.G == c.B) && (c.B == 0)) ? 0 : -1;
-    }
-  }
-  bool done = false;
-  int loop, cwh = can.getWindowHeight(), cww = can.getWindowWidth();
-  for (loop = 0; !done; ++loop) {
-    done = true;
-    #pragma omp parallel for
-    for (int i = 0; i < cwh; ++i) {
-      for (int j = 0; j < cww; ++j) {
-        if (canPoints[i][j] != loop)
-          continue;
-        if (i > 0 && canPoints[i-1][j] == -1)
-          canPoints[i-1][j] = loop+1, done = false;
-        if (j > 0 && canPoints[i][j-1] == -1)
-          canPoints[i][j-1] = loop+1, done = false;
-        if (i < cwh-1 && canPoints[i+1][j] == -1)
-          canPoints[i+1][j] = loop+1, done = false;
-        if (j < cww-1 && canPoints[i][j+1] == -1)
-          canPoints[i][j+1] = loop+1, done = false;
+ColorFloat Mandelbrot::escapeColor(unsigned iterations, unsigned depth, ColorFloat tint) {
+  if (iterations >= depth)  // If the point never escaped, draw it black
+    return BLACK;
+  float mult = iterations/(float)depth;  // Otherwise, draw it with color based on how long it took
+  return Colors::blend(tint,WHITE,0.25f+0.5f*mult)*mult;
+}
+
+unsigned Mandelbrot::reuseBuffer(Cart& can, unsigned depth) {
+  const Decimal EXACT = 1e-6;  //How close (in pixels) a new pixel must be to an old one to reuse it
+  const int W = can.getWindowWidth(), H = can.getWindowHeight();
+  const Decimal MINX = can.getMinX(), MAXY = can.getMaxY(), PW = can.getPixelWidth(), PH = can.getPixelHeight();
+  std::vector<unsigned> iterations(W * H, 0);
+  std::vector<double> zr(W * H, 0.0), zi(W * H, 0.0);
+  std::vector<ColorFloat> colors(W * H, can.getBackgroundColor()), tints(W * H, BLACK);
+  std::vector<char> states(W * H, PIXEL_NEW);
+  unsigned todo = 0;
+  #pragma omp parallel for reduction(+:todo)
+  for (int y = 0; y < H; ++y) {
+    for (int x = 0; x < W; ++x) {
+      const int i = y * W + x;
+      if (myBufferDepth > 0) {
+        Decimal fx = (MINX + PW * x - myBufferMinX) / myBufferPixelWidth;  //Where this pixel falls in the old view
+        Decimal fy = (myBufferMaxY - (MAXY - PH * y)) / myBufferPixelHeight;
+        long ox = std::lround(fx), oy = std::lround(fy);
+        if (ox >= 0 && ox < myBufferWidth && oy >= 0 && oy < myBufferHeight) {
+          const int o = oy * myBufferWidth + ox;
+          colors[i] = myColors[o];  //Nearest old pixel, as a preview
+          tints[i] = myTints[o];
+          if (myStates[o] == PIXEL_DONE && myIterations[o] < myBufferDepth)
+            colors[i] = escapeColor(myIterations[o], depth, myTints[o]);  //Escaped colors are scaled by the depth
+          if (std::abs(fx - ox) < EXACT && std::abs(fy - oy) < EXACT && myStates[o] == PIXEL_DONE) {
+            unsigned n = myIterations[o];
+            if (n < myBufferDepth && n < depth)
+              states[i] = PIXEL_DONE;    //Escaped, and would have at the new depth too
+            else if (n == myBufferDepth && depth >= myBufferDepth)
+              states[i] = (depth == myBufferDepth) ? PIXEL_DONE : PIXEL_RESUME;
+            if (states[i] != PIXEL_NEW) {
+              iterations[i] = n;
+              zr[i] = myZr[o];
+              zi[i] = myZi[o];
+            }
+          }
+        }
       }
+      if (states[i] != PIXEL_DONE)
+        ++todo;
+      can.Canvas::drawPoint(x, y, colors[i]);
     }
   }
+  myIterations.swap(iterations);
+  myZr.swap(zr);
+  myZi.swap(zi);
+  myColors.swap(colors);
+  myTints.swap(tints);
+  myStates.swap(states);
+  myBufferMinX = MINX;
+  myBufferMaxY = MAXY;
+  myBufferPixelWidth = PW;
+  myBufferPixelHeight = PH;
+  myBufferWidth = W;
+  myBufferHeight = H;
+  myBufferDepth = depth;
+  return todo;
+}
 
-  int sum = 0;
-  for (int i = 0; i < cwh; ++i)
-    for (int j = 0; j < cww; ++j)
-      sum += canPoints[i][j];
-  float avg = (((float)sum)/cww)/cwh;
+void Mandelbrot::manhattanShading(CartesianCanvas& can, const ColorFloat colors[]) {
+  const int W = can.getWindowWidth(), H = can.getWindowHeight();
+  bool* black = new bool[W * H];
+  #pragma omp parallel for num_threads(myThreads)
+  for (int i = 0; i < W * H; ++i) {
+    ColorInt c = ColorFloat(colors[i]);
+    black[i] = (c.R == 0 && c.G == 0 && c.B == 0);
+  }
+  std::vector<float> distances(W * H);
+  DistanceTransform(W, H, myThreads).compute(black, distances.data(), TSGL_MANHATTAN);
+  delete [] black;
+  if (std::isinf(distances[0]))
+    return;  //Nothing is black, so there's nothing to measure from
 
-  #pragma omp parallel for
-  for (int i = 0; i < cwh; ++i) {
-    for (int j = 0; j < cww; ++j) {
-      float mult = sqrt(avg*((float)canPoints[i][j])/loop);
-      ColorFloat c = can.getPoint(j,i);
-      can.Canvas::drawPoint(j,i,c*mult);
+  double sum = 0;
+  float maxDistance = 0;
+  #pragma omp parallel num_threads(myThreads) reduction(+:sum)
+  {
+    float localMax = 0;
+    #pragma omp for
+    for (int i = 0; i < W * H; ++i) {
+      sum += distances[i];
+      localMax = std::max(localMax, distances[i]);
     }
+    #pragma omp critical
+    maxDistance = std::max(maxDistance, localMax);
   }
+  float avg = (float)(sum / W / H), levels = maxDistance + 1;
 
-  for (int i = 0; i < can.getWindowHeight(); ++i)
-    delete [] canPoints[i];
-  delete [] canPoints;
-  canPoints = NULL;
+  std::vector<ColorFloat> shaded(colors, colors + W * H);
+  #pragma omp parallel for num_threads(myThreads)
+  for (int i = 0; i < W * H; ++i)
+    shaded[i] = shaded[i] * std::sqrt(avg * distances[i] / levels);
+  can.drawRaster(0, 0, W, H, shaded.data());
 }
 
 void Mandelbrot::bindings(Cart& can) {
@@ -83,6 +137,30 @@ void Mandelbrot::bindings(Cart& can) {
       can.zoom(x, y, 1.5);
       this->myRedraw = true;
     });
+    for (int k = 0; k < 4; ++k) {
+      const Key KEYS[] = { TSGL_LEFT, TSGL_RIGHT, TSGL_UP, TSGL_DOWN };
+      const int DX[] = { -1, 1, 0, 0 }, DY[] = { 0, 0, 1, -1 };
+      int dx = DX[k], dy = DY[k];
+      can.bindToButton(KEYS[k], TSGL_PRESS, [&can, this, dx, dy]() {
+        //Pan by a whole number of pixels, so most of the old view can be reused
+        Decimal x = (can.getMinX() + can.getMaxX()) / 2 + dx * (can.getWindowWidth() / 8) * can.getPixelWidth();
+        Decimal y = (can.getMinY() + can.getMaxY()) / 2 + dy * (can.getWindowHeight() / 8) * can.getPixelHeight();
+        can.zoom(x, y, 1.0);
+        this->myRedraw = true;
+      });
+    }
+    can.bindToButton(TSGL_P, TSGL_PRESS, [this]() {
+      this->myProgressive = !this->myProgressive;
+    });
+    can.bindToButton(TSGL_EQUAL, TSGL_PRESS, [this]() {
+      this->myDepth *= 2;
+      this->myRedraw = true;
+    });
+    can.bindToButton(TSGL_MINUS, TSGL_PRESS, [this]() {
+      if (this->myDepth > 1)
+        this->myDepth /= 2;
+      this->myRedraw = true;
+    });
     can.bindToScroll([&can, this](double dx, double dy) {
       Decimal x, y;
       can.getCartesianCoordinates(can.getMouseX(), can.getMouseY(), x, y);
@@ -99,56 +177,84 @@ void Mandelbrot::draw(Cart& can) {
   const int XBRD = 10;                    //Border for out progress bar
   const int YBRD = 40;                    //Border for out progress bar
   const int PBWIDTH = 800;
+  TileScheduler scheduler(can.getWindowWidth(), CH, 32, myThreads);  //Hands out tiles, so no thread sits idle at the end
+  EscapeTime<MandelbrotRule> engine;      //Iterates several pixels at once
   Canvas pCan(0, 0, PBWIDTH, 100, "Thread Workloads");        //Canvas for our progress bar
   pCan.start();
   ProgressBar pb(
     XBRD,YBRD,pCan.getWindowWidth()-XBRD*2,pCan.getWindowHeight()-YBRD*2,
-    0,CH - (CH % myThreads),myThreads   //Make the max PB value a multiple of myThreads
+    0,scheduler.getTileCount(),scheduler.getThreads()   //One segment per thread, counting tiles
   );
+  scheduler.setProgressBar(&pb);
   while(myRedraw) {
     myRedraw = false;
     can.reset();
-    #pragma omp parallel num_threads(myThreads)
-    {
-      unsigned tid = omp_get_thread_num();
-      unsigned nthreads = omp_get_num_threads();
-      ColorFloat tcolor = Colors::highContrastColor(tid);
-      double blocksize = can.getCartHeight() / nthreads;
-      double blockheight = CH / nthreads;
-      pCan.clear();
-      pb.update(blockheight*tid);
-      pCan.drawProgress(&pb);
-      long double startrow = blocksize * tid + can.getMinY();
-      for(unsigned int k = 0; k <= blockheight && can.isOpen(); k++) {  // As long as we aren't trying to render off of the screen...
-        pb.update(k+(CH*tid)/nthreads);
-        //Messy, but effective
-//        pCan.drawRectangle(XBRD,YBRD,pCan.getWindowWidth()-XBRD,pCan.getWindowHeight()-YBRD,pCan.getBackgroundColor(),true);
+    const unsigned DEPTH = myDepth;       //The bindings can change the depth while we draw
+    unsigned todo = reuseBuffer(can, DEPTH);
+    double firstImage = -1;               //When every block had a color
+    //Sample every STEP-th pixel in each direction and draw it as a STEP x STEP block, then halve STEP.
+    //Pixels sampled by a coarser pass are already done, so each pass only computes the new ones.
+    for (int step = myProgressive ? 8 : 1; step >= 1 && !myRedraw && can.isOpen(); step /= 2) {
+      for (int i = 0; i < pb.getSegs(); ++i)
+        pb.update(0, i);
+      scheduler.run([&](const Tile& tile) {
+        ColorFloat tcolor = Colors::highContrastColor(omp_get_thread_num());
         //Elegant, but flickery
         pCan.clear();
         pCan.drawProgress(&pb);
-        long double row = startrow + can.getPixelHeight() * k;
-        for(long double col = can.getMinX(); col <= can.getMaxX(); col += can.getPixelWidth()) {
-          complex originalComplex(col, row);
-          complex c(col, row);
-          unsigned iterations = 0;
-          while (std::abs(c) < 2.0 && iterations != myDepth) {  // Compute it until it escapes or we give up
-            iterations++;
-            c = c * c + originalComplex;
+        std::vector<int> pixels(tile.width);
+        std::vector<double> cols(tile.width), rows(tile.width), zr(tile.width), zi(tile.width);
+        std::vector<unsigned> iterations(tile.width);
+        for (int y = tile.y; y < tile.y + tile.height && !myRedraw; y += step) {
+          for (char state = PIXEL_RESUME; state <= PIXEL_NEW; state++) {
+            int n = 0;  //Gather the samples in this row that still need work
+            for (int i = 0; i < tile.width; i += step) {
+              int p = y * can.getWindowWidth() + tile.x + i;
+              if (myStates[p] != state)
+                continue;
+              pixels[n] = p;
+              cols[n] = can.getMinX() + can.getPixelWidth() * (tile.x + i);
+              rows[n] = can.getMaxY() - can.getPixelHeight() * y;
+              iterations[n] = myIterations[p];
+              zr[n] = myZr[p];
+              zi[n] = myZi[p];
+              ++n;
+            }
+            if (n == 0)
+              continue;
+            if (state == PIXEL_NEW)
+              engine.compute(n, cols.data(), rows.data(), DEPTH, iterations.data(), nullptr, zr.data(), zi.data());
+            else
+              engine.resume(n, cols.data(), rows.data(), DEPTH, iterations.data(), zr.data(), zi.data());
+            for (int k = 0; k < n; k++) {
+              int p = pixels[k], x = p % can.getWindowWidth();
+              ColorFloat color = escapeColor(iterations[k], DEPTH, tcolor);
+              myIterations[p] = iterations[k];
+              myZr[p] = zr[k];
+              myZi[p] = zi[k];
+              myColors[p] = color;
+              myTints[p] = tcolor;
+              myStates[p] = PIXEL_DONE;
+              //Fill the rest of the block, which is always inside this tile, until a finer pass gets to it
+              for (int by = y; by < y + step && by < tile.y + tile.height; by++)
+                for (int bx = x; bx < x + step && bx < tile.x + tile.width; bx++)
+                  if ((bx == x && by == y) || myStates[by * can.getWindowWidth() + bx] != PIXEL_DONE)
+                    can.Canvas::drawPoint(bx, by, color);
+            }
           }
-          if(iterations == myDepth) { // If the point never escaped, draw it black
-            can.drawPoint(col, row, BLACK);
-          } else { // Otherwise, draw it with color based on how long it took
-            float mult = iterations/(float)myDepth;
-            can.drawPoint(col, row, Colors::blend(tcolor,WHITE,0.25f+0.5f*mult)*mult);
-          }
-          if (myRedraw) break;
         }
         can.handleIO();
-        if (myRedraw) break;
-      }
+        if (myRedraw || !can.isOpen())
+          scheduler.cancel();
+      });
+      if (firstImage < 0 && !myRedraw && can.isOpen())  //Only once a pass has run to completion
+        firstImage = can.getTime();
     }
 //    shadeCanvas(can);  Optional shading
-    std::cout << can.getTime() << std::endl;
+    if (firstImage >= 0)
+      std::cout << "First image after " << firstImage << " s, ";
+    std::cout << "finished after " << can.getTime() << " s ("
+              << todo << " of " << myIterations.size() << " pixels computed)" << std::endl;
     while (can.isOpen() && !myRedraw) {
       can.sleep(); //Removed the timer and replaced it with an internal timer in the Canvas class
     }
@@ -12,6 +12,9 @@
 #include <omp.h>
 #include <queue>
 #include <tsgl.h>
+#include <vector>
+
+#include "EscapeTime.h"
 
 using namespace tsgl;
 
@@ -30,8 +33,24 @@ typedef std::complex<Decimal> complex;
  */
 class Mandelbrot {
 private:
+  enum PixelState { PIXEL_DONE, PIXEL_RESUME, PIXEL_NEW };
+
   Decimal myFirstX, myFirstY, mySecondX, mySecondY;
 
+  //The last view drawn, kept so the next one only computes what it has to
+  std::vector<unsigned> myIterations;     // Iteration count of each pixel
+  std::vector<double> myZr, myZi;         // Final z of each pixel, for picking up where it left off
+  std::vector<ColorFloat> myColors;       // Color each pixel was drawn with
+  std::vector<ColorFloat> myTints;        // Color of the thread that computed each pixel
+  std::vector<char> myStates;             // PixelState of each pixel
+  Decimal myBufferMinX, myBufferMaxY, myBufferPixelWidth, myBufferPixelHeight;  // Where the buffer sits in the plane
+  int myBufferWidth, myBufferHeight;
+  unsigned myBufferDepth;                 // Depth the buffer was computed to, or 0 if there isn't one
+  bool myProgressive;                     // Whether to draw coarse blocks first and refine them
+
+  unsigned reuseBuffer(Cart& can, unsigned depth);
+  static ColorFloat escapeColor(unsigned iterations, unsigned depth, ColorFloat tint);
+
 protected:
   int myThreads;
   unsigned int myDepth;
@@ -40,10 +59,13 @@ protected:
   /*!
    * \brief Shades the fractal using Manhattan distances
    * \details This function may be called after the Mandelbrot has finished rendering to do some
-   *   post-procecssing using the distances from non-escaped pixels to their nearest escaped pixels,
-   *   using the average of their Manhattan distances.
+   *   post-processing: every pixel is darkened by its Manhattan distance to the nearest black
+   *   (non-escaped) pixel, relative to the average of those distances. The distances come from a
+   *   DistanceTransform, so this takes time proportional to the number of pixels.
+   *    \param can Reference to the CartesianCanvas to redraw the shaded image on.
+   *    \param colors Array of the colors of the image that was drawn, one row after another.
    */
-  void manhattanShading(CartesianCanvas& can);
+  void manhattanShading(CartesianCanvas& can, const ColorFloat colors[]);
 
 public:
 
@@ -66,7 +88,9 @@ public:
   /*!
    * \brief Binds buttons and/or mouse clicks.
    * \details Binds buttons and/or mouse clicks needed for I/O capabilities.
-   * \details In this case: the mouse wheel, left and right mouse buttons.
+   * \details In this case: the mouse wheel, left and right mouse buttons to zoom, the arrow keys to pan,
+   *   the equals and minus keys to double and halve the depth, the P key to turn progressive drawing on and off,
+   *   and the spacebar to redraw.
    *    \param can Reference to the CartesianCanvas to have the buttons bound to.
    * \note Cart is a typedef for CartesianCanvas.
    */
@@ -75,6 +99,16 @@ public:
   /*!
    * \brief Draw the Mandelbrot object.
    * \details Actually draws the Mandelbrot object onto the CartesianCanvas.
+   * \details The pixels are computed a tile at a time by a TileScheduler, so threads that finish their share
+   *   of the screen early help with the rest.
+   * \details The iteration counts of the last view are kept along with where it was in the plane. When the view
+   *   changes, pixels that sample exactly the same points as before are copied over, the old image is
+   *   stretched across the rest as a preview, and only those pixels are computed. If the depth has gone up,
+   *   pixels that hadn't escaped carry on from where they stopped instead of starting over.
+   * \details When drawing progressively (the default), every 8th pixel in each direction is computed first and
+   *   drawn as an 8x8 block, then the blocks are refined to 4x4, 2x2 and finally single pixels, each pass
+   *   computing only the pixels the earlier ones skipped. A new zoom cancels the passes within a row.
+   *   The time until the first pass is done is printed along with the total time.
    *    \param can Reference to the CartesianCanvas to draw on.
    * \note Can be inherited by children classes who extend the Mandelbrot class.
    * \note Cart is a typedef for CartesianCanvas.
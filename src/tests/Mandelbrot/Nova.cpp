@@ -7,46 +7,38 @@
 Nova::Nova(unsigned threads, unsigned depth) : Mandelbrot(threads, depth) {}
 
 void Nova::draw(Cart& can) {
-  const long double R = 1.0l;
+  TileScheduler scheduler(can.getWindowWidth(), can.getWindowHeight(), 32, myThreads);
+  EscapeTime<NovaRule> engine(NovaRule(1.0));
+  std::vector<ColorFloat> colors(can.getWindowWidth() * can.getWindowHeight());  //For shading afterwards
   while (myRedraw) {
     myRedraw= false;
-    #pragma omp parallel num_threads(myThreads)
-    {
-      unsigned int nthreads = omp_get_num_threads();
-      double blockstart = can.getCartHeight() / nthreads;
-      unsigned int iterations;
-      double smooth;
-      for (unsigned int k = 0; k <= (can.getWindowHeight() / nthreads) && can.isOpen(); k++) {  // As long as we aren't trying to render off of the screen...
-        long double row = blockstart * omp_get_thread_num() + can.getMinY() + can.getPixelHeight() * k;
-        for (long double col = can.getMinX(); col <= can.getMaxX(); col += can.getPixelWidth()) {
-          complex c(col, row);
-          complex z(1, 0);
-          smooth = exp(-std::abs(z));
-          complex n, d, c1;
-          complex r(1, 0);
-          iterations = 0;
-          while (std::abs(z) < 2.0l && iterations != myDepth) {
-            iterations++;
-            n = z * z * z - 1.0l;
-            d = z * z * 3.0l;
-            z = z + c - (R * n / d);
-            smooth += exp(-std::abs(z));
-          }
-          smooth /= myDepth;
-          if (smooth != smooth || smooth < 0)  // Check to see if smooth is NAN
-            smooth = 0;
-          smooth = smooth - (int)smooth;
-          float mult = iterations/(float)myDepth;
-          if (iterations == myDepth)
-            can.drawPoint(col, row, BLACK);
+    scheduler.run([&](const Tile& tile) {
+      std::vector<double> cols(tile.width), rows(tile.width);
+      std::vector<unsigned> iterations(tile.width);
+      std::vector<float> smooth(tile.width);
+      for (int y = tile.y; y < tile.y + tile.height; y++) {
+        for (int i = 0; i < tile.width; i++) {
+          cols[i] = can.getMinX() + can.getPixelWidth() * (tile.x + i);
+          rows[i] = can.getMaxY() - can.getPixelHeight() * y;
+        }
+        engine.compute(tile.width, cols.data(), rows.data(), myDepth, iterations.data(), smooth.data());
+        for (int i = 0; i < tile.width; i++) {
+          float s = smooth[i] / myDepth;
+          if (s < 0)
+            s = 0;
+          ColorFloat& c = colors[y * can.getWindowWidth() + tile.x + i];
+          if (iterations[i] == myDepth)
+            c = BLACK;
           else
-            can.drawPoint(col, row, ColorHSV((float) smooth * 6.0f, 1.0f, (float) smooth, 1.0f));
+            c = ColorHSV(s * 6.0f, 1.0f, s, 1.0f);
+          can.Canvas::drawPoint(tile.x + i, y, c);
         }
-        can.handleIO();
-        if (myRedraw) break;
       }
-    }
-    manhattanShading(can);
+      can.handleIO();
+      if (myRedraw || !can.isOpen())
+        scheduler.cancel();
+    });
+    manhattanShading(can, colors.data());
     while (can.isOpen() && !myRedraw)
       can.sleep();  //Removed the timer and replaced it with an internal timer in the Canvas class
   }
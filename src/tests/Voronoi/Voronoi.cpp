@@ -9,15 +9,14 @@ using namespace tsgl;
 Voronoi::Voronoi(Canvas& can) {
   const int NEW_WINDOW_W = can.getWindowWidth(),      // Set the screen sizes
         NEW_WINDOW_H = can.getWindowHeight();
-  srand(time(NULL));
+  Random rng(time(NULL));
   myX = new int[MY_POINTS]();
   myY = new int[MY_POINTS]();
   myKValue = new int[NEW_WINDOW_W * NEW_WINDOW_H]();
   for (int i = 0; i < MY_POINTS; i++) {              // Randomize the control points
-    myX[i] = rand() % NEW_WINDOW_W;
-    myY[i] = rand() % NEW_WINDOW_H;
+    myX[i] = rng.nextInt(0, NEW_WINDOW_W);
+    myY[i] = rng.nextInt(0, NEW_WINDOW_H);
   }
-  srand(time(NULL));
   myTC = Colors::randomColor(1.0f);                            // Randomize the axis colors
   myRC = Colors::randomColor(1.0f);
   myLC = Colors::randomColor(1.0f);
@@ -33,27 +32,16 @@ Voronoi::Voronoi(Canvas& can) {
 }
 
 void Voronoi::draw(Canvas& can) {
-  int myBestK = 0;                                  // Keep track of the current best k-value
-  float myBDist, myDist, myXD, myYD;                      // Keep track of the closes matches and current distances
-  #pragma omp parallel for private(myBDist, myXD, myYD, myDist, myBestK)
-  for (int i = 0; i < can.getWindowWidth(); i++) {            // For each individual point...
-    myBestK = 0;
-    for (int j = 0; j < can.getWindowHeight(); j++) {
-      myBDist = 9999;                           // Reset the best distance
-      for (int k = 0; k < MY_POINTS; k++) {      // Find the closest control point
-        myXD = i - myX[k];                      // Calculate the distance from each control point
-        myYD = j - myY[k];
-        myDist = sqrt(myXD * myXD + myYD * myYD);
-        if (myDist < myBDist) {                 // If it's the closest one
-          myBDist = myDist;                   // Update the best distance and control point
-          myBestK = k;
-        }
-      }
-      myKValue[i * can.getWindowHeight() + j] = myBestK;
-      can.drawPoint(i, j, myColor[myBestK]);      // Draw the point with the closest control's color
-      if (!can.isOpen()) break;
-    }
-  }
+  const int WW = can.getWindowWidth(),              // Set the screen sizes
+            WH = can.getWindowHeight();
+  VoronoiDiagram diagram(WW, WH);
+  diagram.compute(MY_POINTS, myX, myY, myKValue);   // Find the closest control point to each pixel
+  std::vector<ColorFloat> colors(WW * WH);
+  #pragma omp parallel for
+  for (int j = 0; j < WH; j++)                      // Color each pixel with its closest control's color
+    for (int i = 0; i < WW; i++)
+      colors[j * WW + i] = myColor[myKValue[j * WW + i]];
+  can.drawRaster(0, 0, WW, WH, colors.data());
 }
 
 Voronoi::~Voronoi() {
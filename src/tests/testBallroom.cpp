@@ -201,8 +201,8 @@ public:
           delete b;
           return;
         }
-        b->pos.x = 25 + rand() % (width-50);
-        b->pos.y = 25 + rand() % (height-50);
+        b->pos.x = 25 + Random::local().nextInt(0, width-50);
+        b->pos.y = 25 + Random::local().nextInt(0, height-50);
       }
     }
     balls.push_back(b);
@@ -272,11 +272,12 @@ void ballroomFunction(Canvas& can) {
     const int WW = can.getWindowWidth(),    // Window width
               WH = can.getWindowHeight();   // Window height
     BallRoom b(WW,WH);
+    Random& rng = Random::local();
     for (int i = 0; i < 100; ++ i) {
       float speed = 5.0f;
-      float dir = 2 * 3.14159f * (rand() % 100) / 100.0f;
-      b.addBall(25 + rand() % (WW-50),25 + rand() % (WH-50),speed*cos(dir),speed*sin(dir),10,
-        ColorInt(64 + rand() % 192,64 + rand() % 192,64 + rand() % 192,255));
+      float dir = 2 * 3.14159f * rng.nextFloat();
+      b.addBall(25 + rng.nextInt(0, WW-50),25 + rng.nextInt(0, WH-50),speed*cos(dir),speed*sin(dir),10,
+        ColorInt(64 + rng.nextInt(0, 192),64 + rng.nextInt(0, 192),64 + rng.nextInt(0, 192),255));
     }
 
     can.bindToButton(TSGL_MOUSE_LEFT, TSGL_PRESS, [&b]() {
@@ -39,7 +39,7 @@ void blurImageFunction(Canvas& can, std::string fpath, int threads) {
   int cww = can.getWindowWidth(), cwh = can.getWindowHeight();
   int side = sqrt(threads);  //Square root of the number of threads, rounded down
   can.drawImage(fpath, 0, 0, cww, cwh);
-  can.sleepFor(0.5f);
+  can.sync();  //Wait until the image is on the screen before reading it back
   #pragma omp parallel num_threads (side*side) //Make sure the actual number of threads is a square
   {
 	side=sqrt(omp_get_num_threads());  //Verify we actually have a workable number of threads
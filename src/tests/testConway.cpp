@@ -33,6 +33,8 @@ using namespace tsgl;
  *          .
  *        - Move the ants in the LifeFarm object.
  *        .
+ *      - Draw the LifeFarm object (which only draws anything once the board is busy enough for it
+ *        to have switched to its bit-packed engine).
  *      .
  *    - If the mouse has been clicked while the Canvas has been paused,
  *      add an ant to the LifeFarm object and draw it to the Canvas.
@@ -73,6 +75,7 @@ void conwayFunction(Canvas& can) {
           }
           farm.moveAnts();
         }
+        farm.draw();
       }
       if(mouseDown) {
         farm.addAnt(can.getMouseX(), can.getMouseY());
@@ -0,0 +1,129 @@
+/*
+ * testEscapeTime.cpp
+ *
+ * Usage: ./testEscapeTime <width> <height> <maxIterations>
+ */
+
+#include <complex>
+#include <omp.h>
+#include <tsgl.h>
+
+#include "Mandelbrot/EscapeTime.h"
+
+using namespace tsgl;
+
+typedef std::complex<long double> complex;
+
+/*!
+ * \brief Times the one-pixel-at-a-time loop the fractal demos used to run, against an EscapeTime engine.
+ * \details
+ * - Iterate every pixel of a <code>w</code> by <code>h</code> image on one thread with
+ *   <code>std::complex<long double></code>, checking <code>std::abs(z) < 2</code> every iteration, using
+ *   <code>oldStep</code> to start and step each pixel.
+ * - Compute the same image with <code>engine</code>, a row at a time.
+ * - Print both times, the speedup, and how many pixels' iteration counts differ (a few pixels right on the
+ *   edge of the set can, since the engine uses double rather than long double).
+ * .
+ * \param name A label for the printed results.
+ * \param engine The EscapeTime engine to time.
+ * \param oldStep A function that starts a pixel when its iteration count is 0, and steps it otherwise.
+ * \param w The width of the image.
+ * \param h The height of the image.
+ * \param minX The real part of the image's left edge.
+ * \param maxY The imaginary part of the image's top edge.
+ * \param size The width of the image in the complex plane.
+ * \param depth The number of iterations to go to.
+ * \param iterations Array in which to store the engine's iteration counts.
+ */
+template<typename Rule, typename Step>
+void timeKernel(const std::string& name, const EscapeTime<Rule>& engine, Step oldStep, int w, int h,
+                double minX, double maxY, double size, unsigned depth, unsigned iterations[]) {
+  const double step = size / w;
+  unsigned* old = new unsigned[w * h];
+  double start = omp_get_wtime();
+  for (int y = 0; y < h; ++y)
+    for (int x = 0; x < w; ++x) {
+      complex c(minX + step * x, maxY - step * y), z;
+      unsigned n = 0;
+      oldStep(z, c, n);
+      while (std::abs(z) < 2.0 && n != depth) {
+        n++;
+        oldStep(z, c, n);
+      }
+      old[y * w + x] = n;
+    }
+  double oldTime = omp_get_wtime() - start;
+
+  double* xs = new double[w];
+  double* ys = new double[w];
+  start = omp_get_wtime();
+  for (int y = 0; y < h; ++y) {
+    for (int x = 0; x < w; ++x) {
+      xs[x] = minX + step * x;
+      ys[x] = maxY - step * y;
+    }
+    engine.compute(w, xs, ys, depth, iterations + y * w);
+  }
+  double newTime = omp_get_wtime() - start;
+
+  int different = 0;
+  for (int i = 0; i < w * h; ++i)
+    if (old[i] != iterations[i])
+      ++different;
+  std::cout << name << ": " << oldTime << " s with std::complex, " << newTime << " s with EscapeTime ("
+            << oldTime / newTime << "x faster, " << different << " pixels differ)" << std::endl;
+  delete [] old;
+  delete [] xs;
+  delete [] ys;
+}
+
+/*!
+ * \brief Benchmarks the escape-time engine on each of the fractals it is used for, then draws them.
+ * \details
+ * - Print how many pixels each group of SIMD lanes holds (4 with AVX, 2 with SSE2, 1 without either).
+ * - Time the Mandelbrot, Julia and Nova iteration rules with timeKernel(), all on a single thread.
+ * - Draw the three images side by side, shaded by their iteration counts.
+ * .
+ * \param can Reference to the Canvas being drawn to.
+ * \param depth The number of iterations to go to.
+ */
+void escapeTimeFunction(Canvas& can, int depth) {
+  const int W = can.getWindowWidth() / 3, H = can.getWindowHeight();
+  unsigned* iterations = new unsigned[3 * W * H];
+  std::cout << "Pixels per SIMD register: " << DoubleLanes::SIZE << ", iterated in groups of "
+            << EscapeTime<MandelbrotRule>::GROUP << std::endl;
+
+  timeKernel("Mandelbrot", EscapeTime<MandelbrotRule>(), [](complex& z, const complex& c, unsigned n) {
+    z = (n == 0) ? c : z * z + c;
+  }, W, H, -2.0, 1.5, 3.0, depth, iterations);
+  timeKernel("Julia", EscapeTime<JuliaRule>(JuliaRule(-0.8, 0.156)), [](complex& z, const complex& c, unsigned n) {
+    z = (n == 0) ? c : z * z + complex(-0.8, 0.156);
+  }, W, H, -1.5, 2.0, 3.0, depth, iterations + W * H);
+  timeKernel("Nova", EscapeTime<NovaRule>(NovaRule(1.0)), [](complex& z, const complex& c, unsigned n) {
+    z = (n == 0) ? complex(1, 0) : z + c - (z * z * z - 1.0l) / (z * z * 3.0l);
+  }, W, H, -1.0, 0.5, 1.0, depth, iterations + 2 * W * H);
+
+  for (int k = 0; k < 3 && can.isOpen(); ++k)
+    for (int y = 0; y < H; ++y)
+      for (int x = 0; x < W; ++x) {
+        float mult = iterations[(k * H + y) * W + x] / (float)depth;
+        can.drawPoint(k * W + x, y, (mult == 1.0f) ? BLACK : Colors::highContrastColor(k) * mult);
+      }
+  delete [] iterations;
+}
+
+//Takes command line arguments for the width and height of the screen
+//as well as the number of iterations to go to
+int main(int argc, char* argv[]) {
+  int w = (argc > 1) ? atoi(argv[1]) : 1200;
+  int h = (argc > 2) ? atoi(argv[2]) : 400;
+  if (w <= 0 || h <= 0) {
+    w = 1200;
+    h = 400;
+  }
+  int d = (argc > 3) ? atoi(argv[3]) : 1000;
+  if (d <= 0)
+    d = 1000;
+  Canvas c(-1, -1, w, h, "Escape Time Kernels");
+  c.run(escapeTimeFunction, d);
+}
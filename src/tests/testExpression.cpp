@@ -0,0 +1,92 @@
+/*
+ * testExpression.cpp
+ *
+ * Usage: ./testExpression <samples>
+ */
+
+#include <omp.h>
+#include <tsgl.h>
+
+using namespace tsgl;
+
+//The same curve three ways: a hand-written Function, a plain function, and an expression
+class CurveFunction : public Function {
+ public:
+    long double valueAt(long double x) const {
+        return sin(x) * pow(x, 2) + 3;
+    }
+};
+
+Decimal curve(Decimal x) {
+    return sin(x) * pow(x, 2) + 3;
+}
+
+/*!
+ * \brief Times how long a Function takes to evaluate a number of samples.
+ * \details
+ * - Evaluate the Function one sample at a time with valueAt(), as drawFunction() used to, and
+ *   keep a running sum so the work can't be optimized away.
+ * - Evaluate it again in chunks of 256 with valuesAt().
+ * - Print both times.
+ * .
+ * \param name A label for the printed results.
+ * \param f The Function to evaluate.
+ * \param samples The number of samples to evaluate.
+ * \return The sum of the sampled values.
+ */
+Decimal timeFunction(const std::string& name, const Function& f, int samples) {
+  const int CHUNK = 256;
+  Decimal xs[CHUNK], ys[CHUNK];
+  Decimal sum = 0, step = 10.0 / samples;
+  double start = omp_get_wtime();
+  for (int i = 0; i < samples; ++i)
+    sum += f.valueAt(-5 + i * step);
+  double single = omp_get_wtime() - start;
+  start = omp_get_wtime();
+  for (int first = 0; first < samples; first += CHUNK) {
+    int n = std::min(CHUNK, samples - first);
+    for (int i = 0; i < n; ++i)
+      xs[i] = -5 + (first + i) * step;
+    f.valuesAt(xs, ys, n);
+    for (int i = 0; i < n; ++i)
+      sum += ys[i];
+  }
+  double batched = omp_get_wtime() - start;
+  std::cout << name << ": " << single << " s one at a time, " << batched << " s in batches" << std::endl;
+  return sum;
+}
+
+/*!
+ * \brief Benchmarks an expression against the virtual-dispatch and function pointer paths, then plots it.
+ * \details
+ * - Build sin(x) * x<sup>2</sup> + 3 as a Function subclass, a function pointer, and an expression.
+ * - Time each of them with timeFunction(), and check that they all computed the same thing.
+ * - Draw axes, then plot the expression with drawFunction().
+ * .
+ * \param can Reference to the CartesianCanvas being drawn to.
+ * \param samples The number of samples to time each version with.
+ */
+void expressionFunction(CartesianCanvas& can, int samples) {
+  using namespace expr;
+  CurveFunction virtualCurve;
+  PointerFunction pointerCurve(&curve);
+  Decimal a = timeFunction("Function subclass", virtualCurve, samples);
+  Decimal b = timeFunction("Function pointer", pointerCurve, samples);
+  Decimal c = timeFunction("Expression", makeFunction(sin(x) * pow(x, 2) + 3), samples);
+  if (std::abs(a - b) > 1e-6 * std::abs(a) || std::abs(a - c) > 1e-6 * std::abs(a))
+    TsglErr("The three versions of the curve disagree!");
+
+  can.drawAxes(0, 0, 1, 5);
+  can.drawFunction(makeFunction(sin(x) * pow(x, 2) + 3), 0, RED);
+  can.drawFunction(makeFunction(cos(x) * 10 - sqrt(x * x + 1)), 0, BLUE);
+}
+
+//Takes command line arguments for the number of samples to time
+int main(int argc, char* argv[]) {
+  int samples = (argc > 1) ? atoi(argv[1]) : 10000000;
+  if (samples <= 0)
+    samples = 10000000;
+  Cart c(-1, -1, 800, 600, -5, -25, 5, 25, "Expression Plotting");
+  c.setBackgroundColor(WHITE);
+  c.run(expressionFunction, samples);
+}
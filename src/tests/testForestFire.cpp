@@ -9,7 +9,7 @@
 using namespace tsgl;
 
 float randfloat(int divisor = 10000) {
-    return (rand() % divisor) / (float) divisor;
+    return Random::local().nextInt(0, divisor) / (float) divisor;
 }
 
 /*!
@@ -46,7 +46,7 @@ void forestFireFunction(Canvas& can) {
     const float LIFE = 10,
                 STRENGTH = 0.03,
                 MAXDIST = sqrt(WINDOW_W * WINDOW_W + WINDOW_H * WINDOW_H) / 2;
-    srand(time(NULL));  // Seed the random number generator
+    Random rng(time(NULL));  // Seed the random number generator
     bool* onFire = new bool[WINDOW_W * WINDOW_H]();
     float* flammability = new float[WINDOW_W * WINDOW_H]();
     //Setting each pixel's flammablity
@@ -62,10 +62,10 @@ void forestFireFunction(Canvas& can) {
     }
     //"Lakes"
     for (int reps = 0; reps < 32; reps++) {
-        int x = rand() % WINDOW_W;
-        int y = rand() % WINDOW_H;
-        int w = rand() % (WINDOW_W - x);
-        int h = rand() % (WINDOW_H - y);
+        int x = rng.nextInt(0, WINDOW_W);
+        int y = rng.nextInt(0, WINDOW_H);
+        int w = rng.nextInt(0, WINDOW_W - x);
+        int h = rng.nextInt(0, WINDOW_H - y);
         if (w > 32) w = 32;
         if (h > 32) h = 32;
         for (int i = 0; i < w; i++) {
@@ -37,7 +37,7 @@ using namespace tsgl;
 void getPixelsFunction(Canvas& can, int threads) {
   unsigned width = can.getWindowWidth(), height = can.getWindowHeight();
   can.drawImage("../assets/pics/test.png", 0, 0, width, height);
-  can.sleepFor(0.5f);
+  can.sync();  //Wait until the image is on the screen before reading it back
   #pragma omp parallel num_threads(threads)
   {
     unsigned blocksize = (double)height / omp_get_num_threads();
@@ -21,7 +21,7 @@ using namespace tsgl;
  * - Set up the internal timer of the Canvas to expire every ( \b FRAME * 2 ) seconds.
  * - Store the Canvas' dimensions for ease of use.
  * - Stretch a fancy image over the Canvas.
- * - Tell the internal timer to manually sleep for a quarter of a second (to assure the draw buffer is filled).
+ * - Wait until the image has been rendered (to assure the draw buffer is filled).
  * - Initialize a pointer to the Canvas' screen buffer.
  * - Set up a parallel OMP block with \b threads threads.
  * - Get the actual number of spawned threads and store it in: \b nthreads.
@@ -50,7 +50,7 @@ void greyScaleFunction(Canvas& can, int numberOfThreads) {
   const unsigned thickness = 3;
   const unsigned WW = can.getWindowWidth(),WH = can.getWindowHeight();
   can.drawImage("../assets/pics/colorful_cars.jpg", 0, 0, WW, WH);
-  can.sleepFor(0.25f);
+  can.sync();  //Wait until the image is on the screen before reading it back
   #pragma omp parallel num_threads(threads)
   {
     int nthreads = omp_get_num_threads();
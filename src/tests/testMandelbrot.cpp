@@ -7,6 +7,7 @@
 /*testMandelbrot.cpp contains multiple functions that display a Mandelbrot set in similar fashions (and one that displays a Julia set). */
 
 #include "Mandelbrot/Buddhabrot.h"
+#include "Mandelbrot/DeepMandelbrot.h"
 #include "Mandelbrot/Mandelbrot.h"
 #include "Mandelbrot/GradientMandelbrot.h"
 #include "Mandelbrot/Julia.h"
@@ -36,33 +37,39 @@ using namespace tsgl;
  *      from that area and redraw the Mandlebrot at that point.
  *    - The mouse's scroll wheel is set to tell the Canvas to zoom in / out by a predetermined amount at the mouse's
  *      current coordinates and redraw the Mandelbrot at that point.
+ *    - The arrow keys are set to pan the Canvas by an eighth of its size, the equals and minus keys to double
+ *      and halve the depth, and the P key to turn progressive drawing on and off.
  *    .
  * - When you actually draw the Mandelbrot object onto the CartesianCanvas:
  *   - Store the height of the Canvas, the x and y-coordinates for the ProgressBar, and the width of the ProgressBar Canvas.
+ *   - Create a TileScheduler that splits the Canvas into 32x32 pixel tiles.
  *   - Create the Canvas that will draw the ProgressBar object.
- *   - Create the ProgressBar object.
+ *   - Create the ProgressBar object, with one segment per thread counting the tiles it has finished, and
+ *     have the TileScheduler update it.
  *   - While the redraw flag is set:
  *      - Set the redraw flag to false.
  *      - Reset the internal timer to 0.
- *      - Fork off the predetermined number of parallel threads using OMP.
- *      - Store the actual number of threads spawned in: \b nthreads.
- *      - Assign a color to each thread.
- *      - Figure the cartesian size of the area each thread is to calculate and store it in: \b blocksize.
- *      - Figure out the actual number of rows each thread is to calculate and store it in: \b blockheight.
- *      - Clear the Canvas that holds the ProgressBar.
- *      - Update the ProgressBar.
- *      - Draw the ProgressBar onto the Canvas.
- *      - For 0 to \b blockheight and as long as we aren't trying to render off of the screen:
- *        - Update the ProgressBar.
- *        - Redraw the ProgressBar with labels for the ID of each thread above each segment of the ProgressBar.
- *        - Make an inner loop which determines whether to color the pixels black or a different color based off of whether they've escaped or not.
- *          - (Basic Mandelbrot calculations; see http://en.wikipedia.org/wiki/Mandelbrot_set#Computer_drawings ).
- *          - Break if the Canvas is to redraw.
+ *      - Move the iteration counts kept from the last view onto the new one: copy the pixels that land exactly on
+ *        old ones, and draw the rest from the nearest old pixel as a preview.
+ *      - For blocks of 8, 4, 2 and then 1 pixels (or just 1, if progressive drawing is off):
+ *        - Empty the ProgressBar.
+ *        - Run the TileScheduler, which gives each thread a band of tiles and lets threads that run out
+ *          take tiles from the others. For each tile:
+ *          - Assign a color to the thread computing it.
+ *          - Redraw the ProgressBar.
+ *          - Loop over every block-th row of the tile, iterating the block corners that no coarser pass or earlier
+ *            view computed several at once with an EscapeTime engine (pixels that hadn't escaped at a smaller depth
+ *            carry on from their last z), and then determining whether to color them black or a different color based
+ *            off of whether they've escaped or not. Each corner's color fills its block until a finer pass replaces it.
+ *            - (Basic Mandelbrot calculations; see http://en.wikipedia.org/wiki/Mandelbrot_set#Computer_drawings ).
+ *          .
+ *          - Handle any IO events (OS X version only).
+ *          - Cancel the remaining tiles if the Canvas is to redraw.
  *        .
- *        - Handle any IO events (OS X version only).
- *        - Break if the Canvas is to redraw.
+ *        - Note the time when the first pass finishes.
  *      .
- *      - Output the time it took to compute the screen.
+ *      - Output the time until the first pass finished, the time it took to compute the screen, and how many pixels
+ *        had to be computed.
  *      - While the Canvas has not been closed and it isn't time to redraw yet:
  *        - Sleep the thread for one frame until the Canvas is closed by the user or told to redraw.
  *      .
@@ -175,6 +182,26 @@ void novaFunction(Cart& can, unsigned threads, unsigned depth) {
     n.draw(can);            //Draw it
 }
 
+/*!
+ * \brief Draws a Mandelbrot set that can be zoomed far deeper than the ones above.
+ * \details
+ * - The center of the view is kept as a FixedPoint number, with more bits the deeper you zoom.
+ * - Each redraw iterates one reference orbit at the center in full precision, and then iterates every
+ *   pixel's offset from it in double, rebasing pixels whose offsets grow too large.
+ * - The size of a pixel, the length of the reference orbit, the number of rebases and the time
+ *   are printed after each redraw.
+ * .
+ * \param can Reference to the CartesianCanvas being drawn to.
+ * \param threads Reference to the number of threads to use.
+ * \param depth The number of iterations to go to in order to draw the DeepMandelbrot set.
+ * \see mandelbrotFunction(), DeepMandelbrot class.
+ */
+void deepMandelbrotFunction(Cart& can, unsigned threads, unsigned depth) {
+  DeepMandelbrot m(threads,depth);  //Create the DeepMandelbrot
+  m.bindings(can);                  //Bind the buttons
+  m.draw(can);                      //Draw it
+}
+
 //Takes command line arguments for the width and height of the screen
 //as well as the number of threads to use and the number of iterations to draw the Mandelbrot set
 int main(int argc, char* argv[]) {
@@ -195,6 +222,7 @@ int main(int argc, char* argv[]) {
   unsigned d = (argc > 4) ? atoi(argv[4]) : MAX_COLOR; //Normal Mandelbrot
   unsigned d2 = (argc > 4) ? atoi(argv[4]) : 32;  //Gradient Mandelbrot & Nova
   unsigned d3 = (argc > 4) ? atoi(argv[4]) : 1000; //Buddhabrot & Julia
+  unsigned d4 = (argc > 4) ? atoi(argv[4]) : 2000; //Deep Mandelbrot
   //Normal Mandelbrot
   std::cout << "Normal Mandelbrot" << std::endl;
   Cart c1(-1, -1, w, h, -2, -1.125, 1, 1.125, "Mandelbrot", FRAME / 2);
@@ -221,4 +249,9 @@ int main(int argc, char* argv[]) {
   Cart c5(x, -1, w, h, -1.0, -0.5, 0, 0.5, "Nova (Newton Fractal)", FRAME / 2);
   c5.zoom(-0.361883,-0.217078,0.1f);
   c5.run(novaFunction,t,32);
+
+  //Deep Mandelbrot
+  std::cout << "Deep Mandelbrot" << std::endl;
+  Cart c6(-1, -1, w, h, -2, -1.125, 1, 1.125, "Deep Mandelbrot", FRAME / 2);
+  c6.run(deepMandelbrotFunction,t,d4);
 }
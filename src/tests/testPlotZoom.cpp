@@ -0,0 +1,65 @@
+/*
+ * testPlotZoom.cpp
+ *
+ * Usage: ./testPlotZoom <points>
+ */
+
+#include <omp.h>
+#include <tsgl.h>
+
+using namespace tsgl;
+
+/*!
+ * \brief Plots a large number of points once, then zooms in and out of them.
+ * \details
+ * - Lay out the points in a sunflower spiral: point \b i is sqrt(\b i) from the center, turned by
+ *   the golden angle from the one before it.
+ * - Plot them all with plotPoints(), which keeps them on the GPU in Cartesian coordinates.
+ * - While the Canvas is open:
+ *   - Zoom in towards a point off to the side for 200 frames, then back out for 200 frames.
+ *   - Since only the view matrix changes, none of the points are recomputed or sent to the GPU again.
+ *   .
+ * - Print how long plotting took, and how long each frame took on average.
+ * .
+ * \param can Reference to the CartesianCanvas being drawn to.
+ * \param points The number of points to plot.
+ */
+void plotZoomFunction(CartesianCanvas& can, int points) {
+  const Decimal GOLDEN_ANGLE = PI * (3 - sqrt(5.0));
+  Decimal* x = new Decimal[points];
+  Decimal* y = new Decimal[points];
+  double start = omp_get_wtime();
+  #pragma omp parallel for
+  for (int i = 0; i < points; ++i) {
+    x[i] = sqrt((Decimal)i) * cos(i * GOLDEN_ANGLE);
+    y[i] = sqrt((Decimal)i) * sin(i * GOLDEN_ANGLE);
+  }
+  can.plotPoints(points, x, y, BLUE);
+  can.sync(can.flush());
+  std::cout << "Plotted " << points << " points in " << omp_get_wtime() - start << " s" << std::endl;
+  delete [] x;
+  delete [] y;
+
+  const Decimal FOCUS_X = sqrt((Decimal)points) * 0.3, FOCUS_Y = 0;
+  int frames = 0;
+  start = omp_get_wtime();
+  while (can.isOpen()) {
+    can.sleep();
+    Decimal scale = (frames / 200) % 2 == 0 ? 0.98 : 1 / 0.98;
+    Decimal centerX = (can.getMinX() + can.getMaxX()) / 2, centerY = (can.getMinY() + can.getMaxY()) / 2;
+    can.zoom(FOCUS_X + (centerX - FOCUS_X) * scale, FOCUS_Y + (centerY - FOCUS_Y) * scale, scale);  // Keep the focus still
+    ++frames;
+  }
+  std::cout << "Average time per frame: " << (omp_get_wtime() - start) / frames << " s" << std::endl;
+}
+
+//Takes command line arguments for the number of points to plot
+int main(int argc, char* argv[]) {
+  int points = (argc > 1) ? atoi(argv[1]) : 1000000;
+  if (points <= 0)
+    points = 1000000;
+  Decimal r = sqrt((Decimal)points) * 1.05;
+  Cart c(-1, -1, 800, 600, -r * 4 / 3, -r, r * 4 / 3, r, "Zooming a Plot");
+  c.setBackgroundColor(WHITE);
+  c.run(plotZoomFunction, points);
+}
@@ -0,0 +1,141 @@
+/*
+ * testRandom.cpp
+ *
+ * Usage: ./testRandom <width> <height> <numThreads>
+ */
+
+#include <omp.h>
+#include <tsgl.h>
+
+using namespace tsgl;
+
+/*!
+ * \brief Prints how many random numbers per second a benchmark generated.
+ * \param name A label for the benchmark.
+ * \param count The number of random numbers generated.
+ * \param seconds How long it took.
+ * \param sink A value computed from some of the numbers, printed so the compiler can't skip generating them.
+ */
+void report(const std::string& name, double count, double seconds, double sink) {
+  std::cout << name << count / seconds / 1e6 << " million per second (checksum " << sink << ")" << std::endl;
+}
+
+/*!
+ * \brief Benchmarks rand() against tsgl::Random from several threads at once, then draws each thread's noise.
+ * \details
+ * - On \b threads threads at once, generate random floats from 0 to 1:
+ *   - With rand(), which every thread shares.
+ *   - One at a time with Random::nextFloat(), each thread using the same seed on its own stream.
+ *   - In bulk with Random::fill(), on the same streams.
+ *   .
+ * - Print how many numbers per second each approach generated.
+ * - Generate the same streams twice more and check that they produce the same numbers both times.
+ * - Split the Canvas into one band per thread, and draw random noise in each band, tinted with that thread's color.
+ * .
+ * \param can Reference to the Canvas being drawn to.
+ * \param threads The number of threads to use.
+ */
+void randomFunction(Canvas& can, int threads) {
+  const int PER_THREAD = 1 << 22, BLOCK = 4096;
+  const uint64_t SEED = 12345;
+  double sink = 0, start = omp_get_wtime();
+  #pragma omp parallel num_threads(threads) reduction(+:sink)
+  {
+    float block[BLOCK];
+    for (int i = 0; i < PER_THREAD; i += BLOCK) {
+      for (int j = 0; j < BLOCK; ++j)
+        block[j] = rand() / (float)RAND_MAX;
+      sink += block[0] + block[BLOCK - 1];
+    }
+  }
+  report("rand():               ", threads * (double)PER_THREAD, omp_get_wtime() - start, sink);
+
+  sink = 0, start = omp_get_wtime();
+  #pragma omp parallel num_threads(threads) reduction(+:sink)
+  {
+    Random rng(SEED, omp_get_thread_num());
+    float block[BLOCK];
+    for (int i = 0; i < PER_THREAD; i += BLOCK) {
+      for (int j = 0; j < BLOCK; ++j)
+        block[j] = rng.nextFloat();
+      sink += block[0] + block[BLOCK - 1];
+    }
+  }
+  report("Random::nextFloat():  ", threads * (double)PER_THREAD, omp_get_wtime() - start, sink);
+
+  sink = 0, start = omp_get_wtime();
+  #pragma omp parallel num_threads(threads) reduction(+:sink)
+  {
+    Random rng(SEED, omp_get_thread_num());
+    float block[BLOCK];
+    for (int i = 0; i < PER_THREAD; i += BLOCK) {
+      rng.fill(BLOCK, block);
+      sink += block[0] + block[BLOCK - 1];
+    }
+  }
+  report("Random::fill():       ", threads * (double)PER_THREAD, omp_get_wtime() - start, sink);
+
+  std::vector<double> sums(threads);  //Each thread's total, to check the streams can be reproduced
+  #pragma omp parallel num_threads(threads)
+  {
+    Random rng(SEED, omp_get_thread_num());
+    float block[BLOCK];
+    double sum = 0;
+    for (int i = 0; i < PER_THREAD; i += BLOCK) {
+      rng.fill(BLOCK, block);
+      for (int j = 0; j < BLOCK; ++j)
+        sum += block[j];
+    }
+    sums[omp_get_thread_num()] = sum;
+  }
+
+  bool same = true;
+  #pragma omp parallel num_threads(threads)
+  {
+    Random rng(SEED, omp_get_thread_num());
+    float block[BLOCK];
+    double sum = 0;
+    for (int i = 0; i < PER_THREAD; i += BLOCK) {
+      rng.fill(BLOCK, block);
+      for (int j = 0; j < BLOCK; ++j)
+        sum += block[j];
+    }
+    if (sum != sums[omp_get_thread_num()])
+      same = false;
+  }
+  std::cout << "Same seed and streams give the same numbers: " << (same ? "yes" : "NO") << std::endl;
+
+  const int W = can.getWindowWidth(), H = can.getWindowHeight();
+  #pragma omp parallel num_threads(threads)
+  {
+    int tid = omp_get_thread_num(), nthreads = omp_get_num_threads();
+    int top = H * tid / nthreads, bottom = H * (tid + 1) / nthreads;
+    Random rng(SEED, tid);
+    ColorFloat tint = Colors::highContrastColor(tid);
+    std::vector<float> noise(W);
+    std::vector<ColorFloat> row(W);
+    for (int y = top; y < bottom && can.isOpen(); ++y) {
+      rng.fill(W, noise.data());
+      for (int x = 0; x < W; ++x)
+        row[x] = tint * noise[x];
+      can.drawRaster(0, y, W, 1, row.data());
+    }
+  }
+}
+
+//Takes command line arguments for the width and height of the screen
+//as well as the number of threads to use
+int main(int argc, char* argv[]) {
+  int w = (argc > 1) ? atoi(argv[1]) : 800;
+  int h = (argc > 2) ? atoi(argv[2]) : 600;
+  if (w <= 0 || h <= 0) {
+    w = 800;
+    h = 600;
+  }
+  int t = (argc > 3) ? atoi(argv[3]) : omp_get_num_procs();
+  if (t <= 0)
+    t = omp_get_num_procs();
+  Canvas c(-1, -1, w, h, "Random Number Generators");
+  c.setBackgroundColor(BLACK);
+  c.run(randomFunction, t);
+}
@@ -0,0 +1,90 @@
+/*
+ * testRenderHub.cpp
+ *
+ * Usage: ./testRenderHub <numCanvases> <useHub> <seconds>
+ */
+
+#include <omp.h>
+#include <tsgl.h>
+
+using namespace tsgl;
+
+/*!
+ * \brief Animates a small monitor window until it has run for a given number of seconds.
+ * \details
+ * - Store the Canvas' dimensions for easy use.
+ * - Until the time is up or the Canvas is closed:
+ *   - Draw a bar whose height follows a sine wave, offset by the Canvas' id.
+ *   - Sleep until the Canvas is ready to draw again.
+ *   .
+ * - Close the Canvas.
+ * .
+ * \param can Reference to the Canvas being drawn to.
+ * \param id Index of the Canvas, used to tell the windows apart.
+ * \param seconds How long to animate the Canvas for.
+ */
+void monitorFunction(Canvas& can, int id, int seconds) {
+  const int WW = can.getWindowWidth(), WH = can.getWindowHeight();
+  ColorFloat c = Colors::highContrastColor(id);
+  double start = can.getTime();
+  while (can.isOpen() && can.getTime() - start < seconds) {
+    int x = can.getFrameNumber() % WW;
+    int h = (WH / 2) * (1 + sin(can.getFrameNumber() / 10.0f + id));
+    can.drawLine(x, WH, x, WH - h, c);
+    can.drawLine((x + 1) % WW, 0, (x + 1) % WW, WH, can.getBackgroundColor());
+    can.sleep();
+  }
+  can.close();
+}
+
+/*!
+ * \brief Opens many small Canvases at once, rendered either by their own threads or by a RenderHub.
+ * \details
+ * - Lay the Canvases out in a grid across the screen.
+ * - If \b useHub is set, add each Canvas to a RenderHub before it is started.
+ * - Start every Canvas, then animate them all in parallel with monitorFunction().
+ * - Wait for every Canvas to close and print the average frame rate they achieved, as well as
+ *   the time until the last of them showed its first frame.
+ * .
+ * \param numCanvases The number of Canvases to open.
+ * \param useHub Whether to render the Canvases with a single RenderHub.
+ * \param seconds How long to animate the Canvases for.
+ */
+void renderHubFunction(int numCanvases, bool useHub, int seconds) {
+  const int SIZE = 160, PER_ROW = Canvas::getDisplayWidth() / SIZE;
+  RenderHub* hub = useHub ? new RenderHub() : nullptr;
+  Canvas** canvases = new Canvas*[numCanvases];
+  for (int i = 0; i < numCanvases; ++i) {
+    canvases[i] = new Canvas((i % PER_ROW) * SIZE, (i / PER_ROW) * SIZE, SIZE, SIZE, to_string(i));
+    if (hub)
+      hub->add(*canvases[i]);
+    canvases[i]->start();
+  }
+  #pragma omp parallel for num_threads(numCanvases)
+  for (int i = 0; i < numCanvases; ++i)
+    monitorFunction(*canvases[i], i, seconds);
+  float fps = 0;
+  double startup = 0;
+  for (int i = 0; i < numCanvases; ++i) {
+    canvases[i]->wait();
+    fps += canvases[i]->getFrameNumber() / (float) seconds;
+    startup = std::max(startup, canvases[i]->getTimeToFirstFrame());
+  }
+  std::cout << (useHub ? "RenderHub: " : "Separate threads: ") << numCanvases << " Canvases at "
+            << fps / numCanvases << " FPS on average, " << startup << " s until all were shown" << std::endl;
+  for (int i = 0; i < numCanvases; ++i)
+    delete canvases[i];
+  delete [] canvases;
+  delete hub;
+}
+
+int main(int argc, char* argv[]) {
+  int numCanvases = (argc > 1) ? atoi(argv[1]) : 20;
+  if (numCanvases <= 0)
+    numCanvases = 20;
+  bool useHub = (argc > 2) ? atoi(argv[2]) != 0 : true;
+  int seconds = (argc > 3) ? atoi(argv[3]) : 5;
+  if (seconds <= 0)
+    seconds = 5;
+  renderHubFunction(numCanvases, useHub, seconds);
+}
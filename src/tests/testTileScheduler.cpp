@@ -0,0 +1,106 @@
+/*
+ * testTileScheduler.cpp
+ *
+ * Usage: ./testTileScheduler <width> <height> <numThreads> <maxIterations>
+ */
+
+#include <complex>
+#include <omp.h>
+#include <tsgl.h>
+
+using namespace tsgl;
+
+/*!
+ * \brief Counts the Mandelbrot iterations for one pixel.
+ * \param x The pixel's column.
+ * \param y The pixel's row.
+ * \param w The width of the image.
+ * \param h The height of the image.
+ * \param depth The most iterations to try.
+ * \return The number of iterations before the point escaped, or <code>depth</code> if it never did.
+ */
+unsigned iterationsAt(int x, int y, int w, int h, unsigned depth) {
+  std::complex<double> c(-2.0 + 3.0 * x / w, 1.125 - 2.25 * y / h), z(c);
+  unsigned iterations = 0;
+  while (std::norm(z) < 4.0 && iterations != depth) {
+    z = z * z + c;
+    ++iterations;
+  }
+  return iterations;
+}
+
+/*!
+ * \brief Benchmarks the TileScheduler against giving each thread one band of rows, then shows who computed what.
+ * \details
+ * - Compute the Mandelbrot set the old way: fork \b threads threads, and give each one an equal band of rows.
+ *   Record how long the slowest band held everything up.
+ * - Compute it again with a TileScheduler, recording which thread computed each tile.
+ * - Print both wall times, and how many tiles were stolen.
+ * - Draw the set, coloring each pixel by the thread that computed it.
+ * .
+ * \param can Reference to the Canvas being drawn to.
+ * \param threads The number of threads to use.
+ * \param depth The number of iterations to go to for each pixel.
+ */
+void tileSchedulerFunction(Canvas& can, int threads, int depth) {
+  const int W = can.getWindowWidth(), H = can.getWindowHeight();
+  unsigned* iterations = new unsigned[W * H];
+  int* owner = new int[W * H];
+
+  double start = omp_get_wtime();
+  #pragma omp parallel num_threads(threads)
+  {
+    int tid = omp_get_thread_num(), nthreads = omp_get_num_threads();
+    for (int y = H * tid / nthreads; y < H * (tid + 1) / nthreads; ++y)
+      for (int x = 0; x < W; ++x)
+        iterations[y * W + x] = iterationsAt(x, y, W, H, depth);
+  }
+  double bands = omp_get_wtime() - start;
+
+  TileScheduler scheduler(W, H, 32, threads);
+  start = omp_get_wtime();
+  scheduler.run([&](const Tile& tile) {
+    int tid = omp_get_thread_num();
+    for (int y = tile.y; y < tile.y + tile.height; ++y)
+      for (int x = tile.x; x < tile.x + tile.width; ++x) {
+        iterations[y * W + x] = iterationsAt(x, y, W, H, depth);
+        owner[y * W + x] = tid;
+      }
+  });
+  double tiles = omp_get_wtime() - start;
+
+  std::cout << "One band of rows per thread: " << bands << " s" << std::endl;
+  std::cout << "TileScheduler:               " << tiles << " s (" << scheduler.getTileCount() << " tiles, "
+            << scheduler.getSteals() << " stolen)" << std::endl;
+
+  for (int y = 0; y < H && can.isOpen(); ++y)
+    for (int x = 0; x < W; ++x) {
+      unsigned i = iterations[y * W + x];
+      if (i == (unsigned)depth)
+        can.drawPoint(x, y, BLACK);
+      else
+        can.drawPoint(x, y, Colors::highContrastColor(owner[y * W + x]) * (0.25f + 0.75f * i / depth));
+    }
+  delete [] iterations;
+  delete [] owner;
+}
+
+//Takes command line arguments for the width and height of the screen,
+//as well as the number of threads and the number of iterations to use
+int main(int argc, char* argv[]) {
+  int w = (argc > 1) ? atoi(argv[1]) : 1200;
+  int h = (argc > 2) ? atoi(argv[2]) : 900;
+  if (w <= 0 || h <= 0) {
+    w = 1200;
+    h = 900;
+  }
+  int t = (argc > 3) ? atoi(argv[3]) : omp_get_num_procs();
+  if (t <= 0)
+    t = omp_get_num_procs();
+  int d = (argc > 4) ? atoi(argv[4]) : 1000;
+  if (d <= 0)
+    d = 1000;
+  Canvas c(-1, -1, w, h, "Tile Scheduler");
+  c.setBackgroundColor(WHITE);
+  c.run(tileSchedulerFunction, t, d);
+}
@@ -7,6 +7,9 @@
 /* testUnits.cpp runs the unit tests for the TSGL library. */
 
 #include "tsgl.h"
+#include "Conway/BitLife.h"
+#include "Mandelbrot/DeepMandelbrot.h"
+#include "Mandelbrot/FixedPoint.h"
 
 using namespace tsgl;
 
@@ -19,9 +22,18 @@ int main() {
    std::cout << "Begin unit testing...." << std::endl << std::endl;
    Canvas::runTests();   // Canvas (Image test included)
    TextureHandler::runTests();   // TextureHandler
+   CachedFunction::runTests();   // CachedFunction
+   FrameBarrier::runTests();     // FrameBarrier
+   InputQueue::runTests();       // InputQueue
+   TileScheduler::runTests();    // TileScheduler
+   DistanceTransform::runTests(); // DistanceTransform
+   VoronoiDiagram::runTests();   // VoronoiDiagram
    ConcavePolygon::runTests();   // ConcavePolygon
    ConvexPolygon::runTests();    // ConvexPolygon
    CartesianCanvas::runTests();  // CartesianCanvas
+   BitLife::runTests();          // BitLife (testConway)
+   FixedPoint::runTests();       // FixedPoint (testMandelbrot)
+   DeepMandelbrot::runTests();   // DeepMandelbrot (testMandelbrot)
    std::cout << std::endl;
    TsglDebug("All Unit Tests have completed!");
 }
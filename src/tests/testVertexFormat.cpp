@@ -0,0 +1,101 @@
+/*
+ * testVertexFormat.cpp
+ *
+ * Usage: ./testVertexFormat <width> <height> <numFrames>
+ */
+
+#include <omp.h>
+#include <tsgl.h>
+
+using namespace tsgl;
+
+/*!
+ * \brief Floods a Canvas with points for a fixed number of frames and reports the frame rate.
+ * \details A/B benchmark for the point buffer's vertex format.
+ * - Store the Canvas' dimensions for easy use.
+ * - For \b frames frames:
+ *   - Draw every pixel on the Canvas with a color that changes every frame.
+ *   - Sleep until the Canvas is ready to draw again.
+ *   .
+ * - Print the average time per frame and the number of bytes uploaded per frame.
+ * - Close the Canvas.
+ * .
+ * \param can Reference to the Canvas being drawn to.
+ * \param frames The number of frames to draw.
+ */
+void vertexFormatFunction(Canvas& can, int frames) {
+  const int width = can.getWindowWidth(), height = can.getWindowHeight();
+  can.reset();
+  double start = can.getTime();
+  for (int f = 0; f < frames && can.isOpen(); ++f) {
+    ColorFloat c(f % 2, 0.5f, (float) f / frames);
+    for (int y = 0; y < height; ++y)
+      for (int x = 0; x < width; ++x)
+        can.drawPoint(x, y, c);
+    can.sleep();
+  }
+  double elapsed = can.getTime() - start;
+  std::cout << "  average frame time: " << 1000 * elapsed / frames << " ms (" << can.getFPS() << " FPS)" << std::endl;
+  can.close();
+}
+
+/*!
+ * \brief Times the CPU side of filling the point buffer in both vertex formats.
+ *   \param points The number of points to convert.
+ */
+void conversionBenchmark(int points) {
+  const int REPS = 10;
+  float* floats = new float[FLOAT_VERTEX_SIZE * points];
+  PackedVertex* packed = new PackedVertex[points];
+  ColorFloat c(0.25f, 0.5f, 0.75f, 1.0f);
+
+  double start = omp_get_wtime();
+  for (int r = 0; r < REPS; ++r) {
+    for (int i = 0; i < points; ++i) {
+      float* v = &floats[FLOAT_VERTEX_SIZE * i];
+      v[0] = i % 1024; v[1] = i / 1024;
+      v[2] = c.R; v[3] = c.G; v[4] = c.B; v[5] = c.A;
+    }
+  }
+  double floatTime = (omp_get_wtime() - start) / REPS;
+
+  start = omp_get_wtime();
+  for (int r = 0; r < REPS; ++r)
+    for (int i = 0; i < points; ++i)
+      packVertex(i % 1024, i / 1024, c, packed[i]);
+  double packedTime = (omp_get_wtime() - start) / REPS;
+
+  start = omp_get_wtime();
+  for (int r = 0; r < REPS; ++r)
+    packVertices(floats, packed, points);
+  double convertTime = (omp_get_wtime() - start) / REPS;
+
+  std::cout << "Filling " << points << " vertices:" << std::endl;
+  std::cout << "  float:  " << 1000 * floatTime << " ms, " << (FLOAT_VERTEX_SIZE * sizeof(float) * points) / 1048576.0 << " MB" << std::endl;
+  std::cout << "  packed: " << 1000 * packedTime << " ms, " << (sizeof(PackedVertex) * points) / 1048576.0 << " MB" << std::endl;
+  std::cout << "  float to packed conversion: " << 1000 * convertTime << " ms" << std::endl;
+
+  delete [] floats;
+  delete [] packed;
+}
+
+int main(int argc, char* argv[]) {
+  int w = (argc > 1) ? atoi(argv[1]) : 1.2*Canvas::getDisplayHeight();
+  int h = (argc > 2) ? atoi(argv[2]) : 0.75*w;
+  if (w <= 0 || h <= 0)     //Checked the passed width and height if they are valid
+    w = 1.2*Canvas::getDisplayHeight(), h = 0.75*w; //If not, set the width and height to a default value
+  int frames = (argc > 3) ? atoi(argv[3]) : 120;
+  if (frames <= 0)
+    frames = 120;
+
+  conversionBenchmark(w*h);
+
+  std::cout << "Float vertex format (" << FLOAT_VERTEX_SIZE * sizeof(float) << " bytes per point):" << std::endl;
+  Canvas c1(-1, -1, w, h, "Vertex Format: Float");
+  c1.setPackedPoints(false);
+  c1.run(vertexFormatFunction,frames);
+
+  std::cout << "Packed vertex format (" << sizeof(PackedVertex) << " bytes per point):" << std::endl;
+  Canvas c2(-1, -1, w, h, "Vertex Format: Packed");
+  c2.run(vertexFormatFunction,frames);
+}
@@ -36,23 +36,11 @@ using namespace tsgl;
  *      .
  *   .
  * - When you draw:
- *    - The best k-value is initially set to 0.
- *    - We initialize variables keeping track of the best and current distances.
- *    - We start a parallel OMP block, allowing the system to determine the best means of parallelization.
- *    - For each column, we set the best k to 0. Then:
- *      - For each row:
- *        - Reset the best distance to a large value.
- *        - For each control point:
- *          - We calculate the distance from row,col to the control point.
- *          - If this distance is less than the best distance, we update the best distance and best-k
- *            (best point).
- *          - We set the k-value for row,col to the best-k.
- *          - We draw a pixel at row,col with the best-k's point color.
- *          - If we closed the Canvas, break.
- *          .
- *        .
- *      .
- *   .
+ *    - A VoronoiDiagram sorts the control points into a grid, and finds the closest one to each pixel
+ *      by searching only the grid cells near it, with the rows split among the threads.
+ *    - The k-value for each pixel is set to its closest control point.
+ *    - Each pixel is given its closest control point's color, and the whole image is drawn at once.
+ *    .
  * .
  * \param can Reference to the Canvas being drawn to.
  */
@@ -65,15 +53,13 @@ void voronoiFunction(Canvas& can) {
  * \brief Draws a randomly generated Voronoi diagram with fancy shading.
  * \details Same principle as voronoiFunction(). Also has a class.
  * - Key differences:
- * - We keep track of the second best distance to each point in \b nbdist.
- * - We keep track of the kvalues of each 2nd best point in the array \b kvalue2.
- * - In a second post-processing loop through the screen:
- *   - Find the closest and 2nd closest control points to each pixel.
+ * - The VoronoiDiagram also finds the 2nd closest control point to each pixel, and we keep
+ *   their kvalues in the array \b kvalue2.
+ * - Then, for each pixel:
  *   - Find the distance from the pixel to the closest control point and store it in: \b d1.
  *   - Find the distance from the closest to the 2nd closest control point and store it in: \b kd.
- *   - Set \b shading to ( \b d1 / \b kd ).
- *   - Bind \b shading between 0 and 1, and shade the pixel with \b shading.
- *   - Break if the Canvas is closed.
+ *   - Set \b shading to the square root of ( \b d1 / \b kd ).
+ *   - Bind \b shading between 0 and 1, and darken the pixel's color by \b shading.
  *   .
  * .
  * \param can Reference to the Canvas being drawn to.